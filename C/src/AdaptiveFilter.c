@@ -11,12 +11,35 @@
 /******************************************************************************/
 /* include block */
 #include "AdaptiveFilter.h"
+#include <math.h>
+#include <string.h>
 
 /******************************************************************************/
 /** local definitions **/
 static void AdaptWeights(AfData *pData);
 static double Filter(double input, AfData *pData);
-static double SquaredNorm(double *x, unsigned int length);
+static double PushInput(double input, AfData *pData);
+static unsigned int Window(const AfData *pData, double **ppSeg0, double **ppSeg1);
+static double WindowNorm(const AfData *pData);
+static void UpdateNorm(double newest, double oldest, AfData *pData);
+static double InputNorm(const AfData *pData);
+static void BindKernels(AfData *pData);
+static double FilterFused(double oldest, AfData *pData);
+static size_t BufferBytes(const AfData *pConfig);
+static void Freeze(AfData *pData);
+static void FirTimeDomain(const double *input, double *output, size_t n, AfData *pData);
+static void FirFftBlock(const double *input, double *output, size_t n, AfFir *pFir);
+static unsigned int PartialTaps(const AfData *pData);
+static void AdaptPartial(double step, AfData *pData);
+static unsigned int NextBlock(unsigned int blocks, AfData *pData);
+static void RankPush(AfData *pData);
+static void RankResize(AfData *pData);
+static void RankSift(AfData *pData, unsigned int bottom, unsigned int k, unsigned int size);
+static int RankAbove(const AfData *pData, unsigned int bottom, unsigned int a, unsigned int b);
+static unsigned int RankIndex(const AfData *pData, unsigned int bottom, unsigned int k);
+static void RankSwap(AfData *pData, unsigned int i, unsigned int j);
+
+#define PARTIAL_SEED (2463534242u) /* xorshift32 state used when PartialSeed is 0 */
 
 /******************************************************************************
  * AdaptiveFilterRun
@@ -35,9 +58,13 @@ static double SquaredNorm(double *x, unsigned int length);
 double AdaptiveFilterRun(double input, double desired, AfData *pData) {
 	double output;
 
+	BindKernels(pData); /* select SIMD kernels on first use */
+
 	output = Filter(input, pData); /* filter the input */
 	pData->Error = desired - output; /* update the error */
-	AdaptWeights(pData); /* update adaptive filter weights */
+	if (!pData->Frozen) {
+		AdaptWeights(pData); /* update adaptive filter weights */
+	}
 
 	return output;
 }
@@ -61,8 +88,12 @@ double AdaptiveFilterRun(double input, double desired, AfData *pData) {
 double AdaptiveFilterRunErrorIn(double input, double error, AfData *pData) {
 	double output;
 
+	BindKernels(pData); /* select SIMD kernels on first use */
+
 	pData->Error = error; /* update the error */
-	AdaptWeights(pData); /* update adaptive filter weights */
+	if (!pData->Frozen) {
+		AdaptWeights(pData); /* update adaptive filter weights */
+	}
 	output = Filter(input, pData); /* filter the input */
 
 	return output;
@@ -70,6 +101,341 @@ double AdaptiveFilterRunErrorIn(double input, double error, AfData *pData) {
 /* End of AdaptiveFilterRunErrorIn() */
 /******************************************************************************/
 
+/******************************************************************************
+ * AdaptiveFilterRunBlock
+ *
+ * @param[in]     input   block of n input signal samples
+ * @param[in]     desired block of n desired signal samples
+ * @param[out]    output  block of n adaptive filter outputs (may be NULL)
+ * @param[out]    error   block of n errors, desired - output (may be NULL)
+ * @param[in]     n       number of samples in the block
+ * @param[in,out] pData   pointer to AdaptiveFilter parameter/state struct
+ *
+ * @returns       none
+ *
+ * @note          Runs the normalized least mean square adaptive filter over
+ *  a whole block of samples. State is carried across calls, so splitting a
+ *  signal into blocks of any size gives exactly the same outputs, errors and
+ *  weights as calling AdaptiveFilterRun() once per sample. A frozen filter
+ *  only filters; AdaptiveFilterFir() is the faster path for that.
+ *
+ * @warning       input and desired must not alias output or error
+ */
+void AdaptiveFilterRunBlock(const double *input, const double *desired,
+                            double *output, double *error, size_t n,
+                            AfData *pData) {
+	double y;
+	size_t i;
+
+	BindKernels(pData); /* select SIMD kernels on first use */
+
+	for ( i = 0; i < n; i++ ) {
+		y = Filter(input[i], pData); /* filter the input */
+		pData->Error = desired[i] - y; /* update the error */
+		if (!pData->Frozen) {
+			AdaptWeights(pData); /* update adaptive filter weights */
+		}
+
+		if (output) {
+			output[i] = y;
+		}
+		if (error) {
+			error[i] = pData->Error;
+		}
+	}
+}
+/* End of AdaptiveFilterRunBlock() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterFlush
+ *
+ * @param[in,out] pData  pointer to AdaptiveFilter parameter/state struct
+ *
+ * @returns       none
+ *
+ * @note          In fused mode each call leaves its weight update pending
+ *  until the next sample's sweep, so pData->pWeights lags by one update.
+ *  This applies the pending update so the weights can be read or copied.
+ *  Outputs are unaffected; filtering may continue afterwards.
+ *
+ * @warning       none
+ */
+void AdaptiveFilterFlush(AfData *pData) {
+	double *pSeg0, *pSeg1;
+	unsigned int n0;
+
+	BindKernels(pData); /* select SIMD kernels on first use */
+
+	if (pData->PendingStep != 0.0) {
+		n0 = Window(pData, &pSeg0, &pSeg1);
+		pData->pKernels->ScaledAdd(pData->pWeights, pData->PendingStep, pSeg0, n0);
+		pData->pKernels->ScaledAdd(pData->pWeights + n0, pData->PendingStep, pSeg1, pData->Length - n0);
+		pData->PendingStep = 0.0;
+	}
+}
+/* End of AdaptiveFilterFlush() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterSkippedFraction
+ *
+ * @param[in]     pData  pointer to AdaptiveFilter parameter/state struct
+ *
+ * @returns       fraction of weight updates skipped by the set-membership
+ *  bound since the filter was set up, 0 before the first sample
+ *
+ * @note          Clear pData->Adaptations and pData->Skipped to start a new
+ *  measurement window.
+ *
+ * @warning       none
+ */
+double AdaptiveFilterSkippedFraction(const AfData *pData) {
+	if (pData->Adaptations == 0) {
+		return 0.0;
+	}
+	return (double)pData->Skipped / (double)pData->Adaptations;
+}
+/* End of AdaptiveFilterSkippedFraction() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterFirMemSize
+ *
+ * @param[in]     length filter length
+ *
+ * @returns       number of bytes AdaptiveFilterFirInit() needs in pMem
+ *
+ * @note          none
+ *
+ * @warning       none
+ */
+size_t AdaptiveFilterFirMemSize(unsigned int length) {
+	unsigned int size = 4;
+
+	while (size < 2 * length) {
+		size *= 2;
+	}
+
+	/* must match the carving in AdaptiveFilterFirInit() */
+	return (3 * (size_t)size + 4) * sizeof(double) + AfFftMemSize(size);
+}
+/* End of AdaptiveFilterFirMemSize() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterFirInit
+ *
+ * @param[out]    pFir  block FIR to initialize
+ * @param[in]     pData filter to run; its Length, weights and delay line are
+ *  used in place
+ * @param[in]     pMem  AdaptiveFilterFirMemSize(pData->Length) bytes,
+ *  aligned for double
+ *
+ * @returns       0 on success, -1 if the filter length is 0
+ *
+ * @note          The FFT size is the smallest power of two N >= 2*Length, so
+ *  each FFT block yields N - Length + 1 >= Length + 1 outputs. The weights
+ *  are transformed on the first AdaptiveFilterFir() call.
+ *
+ * @warning       pMem and pData must stay valid for as long as pFir is used
+ */
+int AdaptiveFilterFirInit(AfFir *pFir, AfData *pData, void *pMem) {
+	double *p = (double *)pMem;
+	unsigned int size = 4, log2Size = 2;
+
+	if (pData->Length == 0) {
+		return -1;
+	}
+	while (size < 2 * pData->Length) {
+		size *= 2;
+		log2Size++;
+	}
+
+	pFir->pData = pData;
+	pFir->Size = size;
+	pFir->Block = size - pData->Length + 1;
+	pFir->FftCost = AF_FIR_FFT_COST * size * log2Size + 2.0 * size; /* + product */
+	pFir->Adaptations = pData->Adaptations;
+	pFir->Stale = 1;
+	pFir->FftBlocks = 0;
+
+	pFir->pWeightSpectrum = p;  p += size + 2;
+	pFir->pSpectrum = p;        p += size + 2;
+	pFir->pTime = p;            p += size;
+
+	return AfFftInit(&pFir->Fft, size, p);
+}
+/* End of AdaptiveFilterFirInit() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterFir
+ *
+ * @param[in]     input  block of n input signal samples
+ * @param[out]    output block of n filter outputs
+ * @param[in]     n      number of samples in the block
+ * @param[in,out] pFir   block FIR
+ *
+ * @returns       none
+ *
+ * @note          Filters the block with the current weights and no
+ *  adaptation, whatever pData->Frozen says. Chunks of up to Block samples
+ *  go through FFT convolution when the cost model (AF_FIR_FFT_COST) rates
+ *  it cheaper than chunk * Length dot-product taps, otherwise through the
+ *  dot-product kernel. Either way every input goes through the filter's
+ *  delay line, so AdaptiveFilterRun() can carry on where this left off and
+ *  the outputs match it to rounding. The weights are transformed again
+ *  after any adaptation since the last call.
+ *
+ * @warning       output may alias input
+ */
+void AdaptiveFilterFir(const double *input, double *output, size_t n,
+                       AfFir *pFir) {
+	AfData *pData = pFir->pData;
+	size_t chunk;
+
+	BindKernels(pData); /* select SIMD kernels on first use */
+	Freeze(pData); /* applies any pending fused update first */
+
+	if (pFir->Adaptations != pData->Adaptations) {
+		pFir->Stale = 1;
+	}
+
+	while (n > 0) {
+		chunk = (n < pFir->Block) ? n : pFir->Block;
+		if (pFir->FftCost < (double)chunk * pData->Length) {
+			FirFftBlock(input, output, chunk, pFir);
+		}
+		else {
+			FirTimeDomain(input, output, chunk, pData);
+		}
+		input += chunk;
+		output += chunk;
+		n -= chunk;
+	}
+}
+/* End of AdaptiveFilterFir() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterArenaSize
+ *
+ * @param[in]     count   number of filters
+ * @param[in]     pConfig parameters of every filter (see
+ *  AdaptiveFilterCreateMany())
+ *
+ * @returns       arena bytes AdaptiveFilterCreateMany() needs for count
+ *  filters
+ *
+ * @note          none
+ *
+ * @warning       none
+ */
+size_t AdaptiveFilterArenaSize(unsigned int count, const AfData *pConfig) {
+	const size_t align = AF_ARENA_ALIGN;
+	const size_t structs = ((size_t)count * sizeof(AfData) + align - 1) / align * align;
+	const size_t weights = ((size_t)pConfig->Length * sizeof(double) + align - 1) / align * align;
+	const size_t buffer = (BufferBytes(pConfig) + align - 1) / align * align;
+	const size_t rank = (pConfig->Partial == AF_PARTIAL_MMAX)
+	                    ? (2 * (size_t)pConfig->Length * sizeof(unsigned int) + align - 1) / align * align
+	                    : 0;
+
+	return structs + (size_t)count * (buffer + weights + rank);
+}
+/* End of AdaptiveFilterArenaSize() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterCreate
+ *
+ * @param[in,out] pArena  arena to carve the filter from
+ * @param[in]     pConfig parameters (see AdaptiveFilterCreateMany())
+ *
+ * @returns       new filter, or NULL if the arena is full
+ *
+ * @note          Same as AdaptiveFilterCreateMany() with a count of 1.
+ *
+ * @warning       none
+ */
+AfData *AdaptiveFilterCreate(AfArena *pArena, const AfData *pConfig) {
+	return AdaptiveFilterCreateMany(pArena, 1, pConfig);
+}
+/* End of AdaptiveFilterCreate() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterCreateMany
+ *
+ * @param[in,out] pArena  arena to carve the filters from
+ * @param[in]     count   number of filters
+ * @param[in]     pConfig parameters of every filter: StepSize,
+ *  Regularization, Length, Layout, NormRefresh, Fused, pKernels, Partial,
+ *  UpdateTaps, PartialSeed, ErrorBound and Frozen are copied, the buffer,
+ *  weight and other state fields are ignored
+ *
+ * @returns       array of count filters, or NULL if the arena is full
+ *
+ * @note          Replaces hand-assembled AfData structs over static arrays.
+ *  The structs are contiguous, followed by each filter's delay line and
+ *  weights side by side (and the M-max workspace), every one starting on its
+ *  own AF_ARENA_ALIGN boundary and zeroed. There is no per-filter destroy: the filters live
+ *  until the arena is reset or destroyed.
+ *
+ * @warning       none
+ */
+AfData *AdaptiveFilterCreateMany(AfArena *pArena, unsigned int count,
+                                 const AfData *pConfig) {
+	const size_t used = pArena->Used;
+	AfData *pFilters;
+	double *pBuffer, *pWeights;
+	unsigned int *pRank;
+	unsigned int k;
+
+	if (count == 0 || AdaptiveFilterArenaSize(count, pConfig) > pArena->Size - used) {
+		return NULL;
+	}
+
+	pFilters = (AfData *)AfArenaAlloc(pArena, (size_t)count * sizeof(AfData));
+	for ( k = 0; k < count; k++ ) {
+		pBuffer = (double *)AfArenaAlloc(pArena, BufferBytes(pConfig));
+		pWeights = (double *)AfArenaAlloc(pArena, pConfig->Length * sizeof(double));
+		pRank = (pConfig->Partial == AF_PARTIAL_MMAX)
+		        ? (unsigned int *)AfArenaAlloc(pArena, 2 * pConfig->Length * sizeof(unsigned int))
+		        : NULL;
+
+		/* the parameters are const, so the struct is written whole */
+		AfData filter = {
+			pConfig->StepSize,
+			pConfig->Regularization,
+			pConfig->Length,
+			pBuffer,
+			0, /* initial buffer index */
+			pWeights,
+			0.0, /* initial error */
+			pConfig->Layout,
+			pConfig->NormRefresh,
+			0.0, 0.0, 0, /* running norm */
+			pConfig->pKernels,
+			pConfig->Fused,
+			0.0, /* no pending update */
+			pConfig->Partial,
+			pConfig->UpdateTaps,
+			pRank,
+			0, 0, /* heaps not yet built, first sequential block */
+			pConfig->PartialSeed,
+			pConfig->ErrorBound,
+			0, 0, /* update counters */
+			pConfig->Frozen
+		};
+		memcpy(&pFilters[k], &filter, sizeof(AfData));
+	}
+
+	return pFilters;
+}
+/* End of AdaptiveFilterCreateMany() */
+/******************************************************************************/
+
 /** internal functions **/
 
 /***************************************************************************//**
@@ -80,25 +446,50 @@ double AdaptiveFilterRunErrorIn(double input, double error, AfData *pData) {
 * @returns       none
 * 
 * @note          Updates the filter weights in pData->pWeights using the
-*  canonical normalized least mean square algorithm.
+*  canonical normalized least mean square algorithm. In fused mode the
+*  update is only recorded in pData->PendingStep and the next Filter() sweep
+*  applies it. A partial update (see AdaptPartial()) is applied at once,
+*  fused or not, with the step normalized by the full input norm.
+*  With a set-membership bound the update is skipped, before the input norm
+*  is needed, whenever |Error| <= ErrorBound; otherwise the SM-NLMS step
+*  1 - ErrorBound/|Error| moves the a posteriori error onto the bound.
 * 
 * @warning       none
 *******************************************************************************/
 static void AdaptWeights(AfData *pData) {
-	double sn, normStepSize;
-	int i;
+	double sn, stepSize, normStepSize;
+	double *pSeg0, *pSeg1;
+	unsigned int n0;
 
-	sn = SquaredNorm(pData->pBuffer,pData->Length); /* compute norm term */
-	normStepSize = (pData->StepSize)/(pData->Regularization + sn); /* normalize step size */
+	pData->Adaptations++;
+	stepSize = pData->StepSize;
+	if (pData->ErrorBound > 0.0) {
+		/* set-membership: adapt only when the error leaves the bound */
+		if (fabs(pData->Error) <= pData->ErrorBound) {
+			pData->Skipped++;
+			return;
+		}
+		stepSize = 1.0 - pData->ErrorBound / fabs(pData->Error);
+	}
+
+	sn = InputNorm(pData); /* compute norm term */
+	normStepSize = stepSize/(pData->Regularization + sn); /* normalize step size */
+
+	if (PartialTaps(pData) < pData->Length) {
+		AdaptPartial(normStepSize * (pData->Error), pData); /* M of Length taps */
+		return;
+	}
 
-	for ( i = pData->Length - 1; i >= 0; i--) {
-        /* wrap index */
-        if (pData->BufferIdx >= pData->Length) {
-            pData->BufferIdx = 0;
-        }
-        /* Normalized Least Mean Square update equation */
-		pData->pWeights[i] += normStepSize * (pData->Error) * (pData->pBuffer[pData->BufferIdx++]);
+	if (pData->Fused) {
+		pData->PendingStep = normStepSize * (pData->Error); /* deferred update */
+		return;
 	}
+
+	n0 = Window(pData, &pSeg0, &pSeg1); /* newest-first input vector */
+
+	/* Normalized Least Mean Square update equation */
+	pData->pKernels->ScaledAdd(pData->pWeights, normStepSize * (pData->Error), pSeg0, n0);
+	pData->pKernels->ScaledAdd(pData->pWeights + n0, normStepSize * (pData->Error), pSeg1, pData->Length - n0);
 }
 /* End of AdaptWeights()*/
 /******************************************************************************/
@@ -112,64 +503,731 @@ static void AdaptWeights(AfData *pData) {
 * @returns       new filter output
 * 
 * @note          Computes a new output sample using the input and current
-*  filter weights.
-*
+*  filter weights. In fused mode with no update pending (a skipped
+*  set-membership update, or the first sample) this is a plain dot product
+*  and AdaptWeights() measures the input norm itself if it needs it. A
+*  frozen filter skips the running norm and M-max ranking (see Freeze()).
 * 
 * @warning       none
 *******************************************************************************/
 static double Filter(double input, AfData *pData) {
-	double output = 0;
-	int i;
-    
-    /* wrap index */
-    if (pData->BufferIdx >= pData->Length) {
-        pData->BufferIdx = 0;
-    }
-    /* overwrite oldest input with new input */
-	pData->pBuffer[pData->BufferIdx++] = input;
-
-	for (i = pData->Length - 1; i >= 0; i--) {
-        /* wrap index */
-        if (pData->BufferIdx >= pData->Length) {
-            pData->BufferIdx = 0;
-        }
-        /* compute inner product of weight vector and buffer */
-		output += (pData->pWeights[i]) * (pData->pBuffer[pData->BufferIdx++]);
-	}
-    
+	double output, oldest;
+	double *pSeg0, *pSeg1;
+	unsigned int n0;
+
+	if (pData->Frozen) {
+		Freeze(pData); /* no update state to keep in step */
+	}
+
+	oldest = PushInput(input, pData); /* overwrite oldest input with new input */
+	if (!pData->Frozen) {
+		UpdateNorm(input, oldest, pData); /* keep running norm in step */
+		if (pData->Partial == AF_PARTIAL_MMAX && pData->pRank) {
+			RankPush(pData); /* keep the M largest inputs in step */
+		}
+	}
+
+	if (pData->Fused && pData->PendingStep != 0.0) {
+		return FilterFused(oldest, pData); /* apply pending update while filtering */
+	}
+
+	n0 = Window(pData, &pSeg0, &pSeg1); /* newest-first input vector */
+
+	/* compute inner product of weight vector and buffer */
+	output = pData->pKernels->Dot(pData->pWeights, pSeg0, n0);
+	output += pData->pKernels->Dot(pData->pWeights + n0, pSeg1, pData->Length - n0);
+	if (pData->Fused && pData->NormRefresh == 0) {
+		pData->Energy = -1.0; /* nothing was pending, so no sweep measured the window */
+	}
+
 	return output;
 }
 /* End of Filter()*/
 /******************************************************************************/
 
 /***************************************************************************//**
-* SquaredNorm
+* PushInput
+* 
+* @param[in]     input input signal sample
+* @param[in,out]     pData pointer to AdaptiveFilter parameter/state struct
+*
+* @returns       the oldest input sample, which input replaces
+* 
+* @note          Moves pData->BufferIdx back one slot and writes the new input
+*  there, so BufferIdx always indexes the newest sample and older samples
+*  follow it at increasing addresses. The mirrored layout also writes the
+*  copy Length slots further on.
+* 
+* @warning       none
+*******************************************************************************/
+static double PushInput(double input, AfData *pData) {
+	double oldest;
+	unsigned int idx = pData->BufferIdx;
+
+	/* wrap index */
+	if (idx == 0 || idx > pData->Length) {
+		idx = pData->Length;
+	}
+	idx--;
+
+	oldest = pData->pBuffer[idx];
+	pData->pBuffer[idx] = input;
+	if (pData->Layout == AF_DELAY_MIRRORED) {
+		pData->pBuffer[idx + pData->Length] = input;
+	}
+	pData->BufferIdx = idx;
+
+	return oldest;
+}
+/* End of PushInput()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Window
 * 
-* @param[in]     pInput pointer to a buffer of input samples
-* @param[in]     length length of the buffer
+* @param[in]     pData pointer to AdaptiveFilter parameter/state struct
+* @param[out]    ppSeg0 first contiguous slice of the input vector
+* @param[out]    ppSeg1 second contiguous slice of the input vector
 *
-* @returns       squared L2-norm of the input buffer
+* @returns       number of samples in the first slice
 * 
-* @note          Computes the squared L2-norm of the input buffer which is
-*  the sum of each every element squared.
+* @note          Describes the current input vector, newest sample first, as
+*  at most two contiguous slices so that weight i pairs with element i. The
+*  mirrored layout always yields a single slice of Length samples; the
+*  circular layout splits where the buffer wraps.
 * 
 * @warning       none
 *******************************************************************************/
-static double SquaredNorm(double *pInput, const unsigned int length) {
-	double output = 0;
-	unsigned int i;
+static unsigned int Window(const AfData *pData, double **ppSeg0, double **ppSeg1) {
+	unsigned int idx = pData->BufferIdx;
 
-    /* Note: this could be computationally improved, but is currently done
-     * this way to definitively avoid numerical error accumulation due to
-     * the properties of floating point addition.
-     */
-	for ( i = 0; i < length; i++ ) {
-		output += pInput[i]*pInput[i]; /* accumulate squared elements */
+	if (idx >= pData->Length) {
+		idx = 0; /* guard against an out-of-range index */
+	}
+	*ppSeg0 = pData->pBuffer + idx;
+	if (pData->Layout == AF_DELAY_MIRRORED) {
+		*ppSeg1 = pData->pBuffer + idx + pData->Length;
+		return pData->Length;
 	}
-    
+	*ppSeg1 = pData->pBuffer;
+	return pData->Length - idx;
+}
+/* End of Window()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* WindowNorm
+* 
+* @param[in]     pData pointer to AdaptiveFilter parameter/state struct
+*
+* @returns       squared L2-norm of the current input vector
+* 
+* @note          Exact O(Length) recomputation over the delay line window.
+* 
+* @warning       none
+*******************************************************************************/
+static double WindowNorm(const AfData *pData) {
+	double *pSeg0, *pSeg1;
+	unsigned int n0;
+
+	n0 = Window(pData, &pSeg0, &pSeg1);
+
+	return pData->pKernels->SquaredNorm(pSeg0, n0) + pData->pKernels->SquaredNorm(pSeg1, pData->Length - n0);
+}
+/* End of WindowNorm()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* UpdateNorm
+* 
+* @param[in]     newest input sample just written to the delay line
+* @param[in]     oldest input sample it replaced
+* @param[in,out] pData pointer to AdaptiveFilter parameter/state struct
+*
+* @returns       none
+* 
+* @note          Maintains the running squared norm when pData->NormRefresh is
+*  nonzero. Each sample adds newest^2 - oldest^2 using Neumaier compensated
+*  summation (the lost low-order bits are carried in EnergyComp), and every
+*  NormRefresh samples the norm is recomputed exactly, discarding any drift.
+*  Between refreshes the drift is bounded by roughly
+*  NormRefresh * 2^-52 * max(input^2), independent of filter length.
+* 
+* @warning       none
+*******************************************************************************/
+static void UpdateNorm(double newest, double oldest, AfData *pData) {
+	double delta, sum;
+
+	if (pData->NormRefresh == 0) {
+		return; /* exact norm is recomputed on demand */
+	}
+
+	if (pData->NormCount == 0) {
+		/* bounded exact recompute */
+		pData->Energy = WindowNorm(pData);
+		pData->EnergyComp = 0.0;
+	}
+	else {
+		/* recursive update: add newest^2, subtract oldest^2 */
+		delta = newest * newest - oldest * oldest;
+		sum = pData->Energy + delta;
+		if (fabs(pData->Energy) >= fabs(delta)) {
+			pData->EnergyComp += (pData->Energy - sum) + delta;
+		}
+		else {
+			pData->EnergyComp += (delta - sum) + pData->Energy;
+		}
+		pData->Energy = sum;
+	}
+
+	if (++pData->NormCount >= pData->NormRefresh) {
+		pData->NormCount = 0;
+	}
+}
+/* End of UpdateNorm()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* InputNorm
+* 
+* @param[in]     pData pointer to AdaptiveFilter parameter/state struct
+*
+* @returns       squared L2-norm of the current input vector
+* 
+* @note          Returns the running norm when enabled, otherwise recomputes
+*  it exactly.
+* 
+* @warning       none
+*******************************************************************************/
+static double InputNorm(const AfData *pData) {
+	double sn;
+
+	if (pData->NormRefresh == 0) {
+		/* the fused sweep may already have measured the current window */
+		return (pData->Fused && pData->Energy >= 0.0) ? pData->Energy : WindowNorm(pData);
+	}
+
+	sn = pData->Energy + pData->EnergyComp;
+
+	return (sn > 0.0) ? sn : 0.0; /* rounding must never make it negative */
+}
+/* End of InputNorm()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* BindKernels
+* 
+* @param[in,out] pData pointer to AdaptiveFilter parameter/state struct
+*
+* @returns       none
+* 
+* @note          Leaves a caller-chosen kernel table alone, otherwise selects
+*  the best table for the host (see AfKernelsGet()).
+* 
+* @warning       none
+*******************************************************************************/
+static void BindKernels(AfData *pData) {
+	if (!pData->pKernels) {
+		pData->pKernels = AfKernelsGet(AF_ISA_AUTO);
+	}
+}
+/* End of BindKernels()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* FilterFused
+* 
+* @param[in]     oldest input sample that the newest input just replaced
+* @param[in,out] pData pointer to AdaptiveFilter parameter/state struct
+*
+* @returns       new filter output
+* 
+* @note          Single pass over the weights that first applies the pending
+*  update from the previous sample, w[i] += PendingStep * xPrev[i], and then
+*  accumulates w[i] * x[i] and x[i]^2. The previous input vector is the
+*  current one shifted by one tap, with the replaced sample in the last tap,
+*  so each weight is loaded and stored once per sample instead of twice.
+*  The arithmetic matches Filter() followed by AdaptWeights() up to the
+*  kernel tolerance.
+* 
+* @warning       none
+*******************************************************************************/
+static double FilterFused(double oldest, AfData *pData) {
+	const double step = pData->PendingStep;
+	double *pW = pData->pWeights;
+	double *pSeg0, *pSeg1;
+	double output, energy = 0.0, prevLast;
+	unsigned int n0, n1;
+
+	n0 = Window(pData, &pSeg0, &pSeg1); /* newest-first input vector */
+	n1 = pData->Length - n0;
+
+	/* first slice; its last tap's previous input is the next slice's first */
+	output = pData->pKernels->UpdateDot(pW, pSeg0, pSeg0 + 1, step, n0 - 1, &energy);
+	prevLast = (n1 > 0) ? pSeg1[0] : oldest;
+	pW[n0 - 1] += step * prevLast;
+	output += pW[n0 - 1] * pSeg0[n0 - 1];
+	energy += pSeg0[n0 - 1] * pSeg0[n0 - 1];
+
+	/* second slice, present only when the circular buffer wraps */
+	if (n1 > 0) {
+		output += pData->pKernels->UpdateDot(pW + n0, pSeg1, pSeg1 + 1, step, n1 - 1, &energy);
+		pW[pData->Length - 1] += step * oldest;
+		output += pW[pData->Length - 1] * pSeg1[n1 - 1];
+		energy += pSeg1[n1 - 1] * pSeg1[n1 - 1];
+	}
+
+	pData->PendingStep = 0.0;
+	if (pData->NormRefresh == 0) {
+		pData->Energy = energy; /* exact norm of the current window */
+	}
+
 	return output;
 }
-/* End of SquaredNorm()*/
+/* End of FilterFused()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* BufferBytes
+*
+* @param[in]     pConfig filter parameters (Length, Layout)
+*
+* @returns       size of the filter's delay line in bytes
+*
+* @note          none
+*
+* @warning       none
+*******************************************************************************/
+static size_t BufferBytes(const AfData *pConfig) {
+	const size_t rows = (pConfig->Layout == AF_DELAY_MIRRORED) ? 2 : 1;
+
+	return rows * pConfig->Length * sizeof(double);
+}
+/* End of BufferBytes()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* PartialTaps
+*
+* @param[in]     pData pointer to AdaptiveFilter parameter/state struct
+*
+* @returns       number of taps the next update adapts, Length for a full
+*  update
+*
+* @note          M-max without a pRank workspace falls back to a full update.
+*
+* @warning       none
+*******************************************************************************/
+static unsigned int PartialTaps(const AfData *pData) {
+	if (pData->Partial == AF_PARTIAL_NONE || pData->UpdateTaps == 0 ||
+	    pData->UpdateTaps >= pData->Length ||
+	    (pData->Partial == AF_PARTIAL_MMAX && !pData->pRank)) {
+		return pData->Length;
+	}
+	return pData->UpdateTaps;
+}
+/* End of PartialTaps()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* AdaptPartial
+*
+* @param[in]     step  normalized step times error
+* @param[in,out] pData pointer to AdaptiveFilter parameter/state struct
+*
+* @returns       none
+*
+* @note          Adds step * x[i] to UpdateTaps of the weights. M-max walks
+*  the top heap of buffer slots, whose tap is the slot's distance from the
+*  newest sample. The block modes split the taps into blocks of M (the last
+*  may be shorter) and update one block, either the next in turn or one
+*  drawn from a xorshift32 generator, with the vector kernel.
+*
+* @warning       none
+*******************************************************************************/
+static void AdaptPartial(double step, AfData *pData) {
+	const unsigned int length = pData->Length, m = pData->UpdateTaps;
+	unsigned int idx = pData->BufferIdx, k, slot, first, last, n0;
+	double *pSeg0, *pSeg1;
+
+	if (pData->Partial == AF_PARTIAL_MMAX) {
+		if (idx >= length) {
+			idx = 0; /* guard against an out-of-range index, as in Window() */
+		}
+		for ( k = 0; k < pData->RankTop; k++ ) {
+			slot = pData->pRank[k];
+			pData->pWeights[(slot >= idx) ? slot - idx : slot + length - idx] += step * pData->pBuffer[slot];
+		}
+		return;
+	}
+
+	if (pData->Partial == AF_PARTIAL_SEQUENTIAL) {
+		first = (pData->PartialIdx < length) ? pData->PartialIdx : 0;
+		pData->PartialIdx = (first + m < length) ? first + m : 0;
+	}
+	else {
+		first = NextBlock((length + m - 1) / m, pData) * m;
+	}
+	last = (first + m < length) ? first + m : length;
+
+	/* the block may straddle the two slices of a circular window */
+	n0 = Window(pData, &pSeg0, &pSeg1);
+	if (first < n0) {
+		pData->pKernels->ScaledAdd(pData->pWeights + first, step, pSeg0 + first,
+		                           ((last < n0) ? last : n0) - first);
+	}
+	if (last > n0) {
+		first = (first > n0) ? first : n0;
+		pData->pKernels->ScaledAdd(pData->pWeights + first, step, pSeg1 + (first - n0), last - first);
+	}
+}
+/* End of AdaptPartial()*/
 /******************************************************************************/
 
+/***************************************************************************//**
+* NextBlock
+*
+* @param[in]     blocks number of blocks to choose from
+* @param[in,out] pData  pointer to AdaptiveFilter parameter/state struct
+*
+* @returns       random block number below blocks
+*
+* @note          Advances the xorshift32 state in pData->PartialSeed. The
+*  modulo bias is below blocks / 2^32.
+*
+* @warning       none
+*******************************************************************************/
+static unsigned int NextBlock(unsigned int blocks, AfData *pData) {
+	unsigned long x = pData->PartialSeed ? pData->PartialSeed : PARTIAL_SEED;
+
+	x ^= (x << 13) & 0xFFFFFFFFul;
+	x ^= x >> 17;
+	x ^= (x << 5) & 0xFFFFFFFFul;
+	pData->PartialSeed = (unsigned int)x;
 
+	return (unsigned int)(x % blocks);
+}
+/* End of NextBlock()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* RankPush
+*
+* @param[in,out] pData pointer to AdaptiveFilter parameter/state struct
+*
+* @returns       none
+*
+* @note          Keeps the buffer slots split into a min-heap of the RankTop
+*  largest |inputs| and a max-heap of the rest. pRank[0..Length) holds the
+*  top heap from the front and the other heap from the back, and
+*  pRank[Length + slot] is the slot's index there. A new sample changes
+*  the key of one slot: it is sifted within its heap, after which only the
+*  two roots can be out of order, and swapping them restores the split, so
+*  a sample costs O(log Length) comparisons. The first call builds the
+*  heaps; RankResize() then follows changes of UpdateTaps.
+*
+* @warning       none
+*******************************************************************************/
+static void RankPush(AfData *pData) {
+	const unsigned int length = pData->Length, top = pData->RankTop;
+	unsigned int index, bottom, k;
+
+	if (top == 0) {
+		/* every slot goes into the bottom heap */
+		for ( k = 0; k < length; k++ ) {
+			pData->pRank[length - 1 - k] = k;
+			pData->pRank[length + k] = length - 1 - k;
+			RankSift(pData, 1, k, k + 1);
+		}
+	}
+	else {
+		index = pData->pRank[length + pData->BufferIdx];
+		bottom = index >= top;
+		k = bottom ? length - 1 - index : index;
+		RankSift(pData, bottom, k, bottom ? length - top : top);
+		if (top < length &&
+		    fabs(pData->pBuffer[pData->pRank[0]]) < fabs(pData->pBuffer[pData->pRank[length - 1]])) {
+			RankSwap(pData, 0, length - 1);
+			RankSift(pData, 0, 0, top);
+			RankSift(pData, 1, 0, length - top);
+		}
+	}
+
+	RankResize(pData);
+}
+/* End of RankPush()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* RankResize
+*
+* @param[in,out] pData pointer to AdaptiveFilter parameter/state struct
+*
+* @returns       none
+*
+* @note          Moves roots between the heaps until the top heap holds
+*  UpdateTaps slots (1 to Length), O(log Length) per slot moved. The two
+*  heaps meet at index RankTop, so a root is moved by swapping it with the
+*  last element of its heap and letting the boundary shift over it.
+*
+* @warning       none
+*******************************************************************************/
+static void RankResize(AfData *pData) {
+	const unsigned int length = pData->Length;
+	unsigned int target = pData->UpdateTaps, top = pData->RankTop;
+
+	if (target == 0 || target > length) {
+		target = length;
+	}
+
+	while (top < target) {
+		/* bottom root joins the top heap */
+		RankSwap(pData, length - 1, top);
+		top++;
+		RankSift(pData, 1, 0, length - top);
+		RankSift(pData, 0, top - 1, top);
+	}
+	while (top > target) {
+		/* top root joins the bottom heap */
+		RankSwap(pData, 0, top - 1);
+		top--;
+		RankSift(pData, 0, 0, top);
+		RankSift(pData, 1, length - 1 - top, length - top);
+	}
+
+	pData->RankTop = top;
+}
+/* End of RankResize()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* RankSift
+*
+* @param[in,out] pData  pointer to AdaptiveFilter parameter/state struct
+* @param[in]     bottom 0: the top (min-)heap, 1: the bottom (max-)heap
+* @param[in]     k      heap element whose key may be out of order
+* @param[in]     size   number of elements in the heap
+*
+* @returns       none
+*
+* @note          Sifts element k up if it belongs above its parent, otherwise
+*  down below any child that belongs above it.
+*
+* @warning       none
+*******************************************************************************/
+static void RankSift(AfData *pData, unsigned int bottom, unsigned int k, unsigned int size) {
+	unsigned int parent, child;
+
+	while (k > 0) {
+		parent = (k - 1) / 2;
+		if (!RankAbove(pData, bottom, k, parent)) {
+			break;
+		}
+		RankSwap(pData, RankIndex(pData, bottom, k), RankIndex(pData, bottom, parent));
+		k = parent;
+	}
+	for ( ; ; ) {
+		child = 2 * k + 1;
+		if (child >= size) {
+			break;
+		}
+		if (child + 1 < size && RankAbove(pData, bottom, child + 1, child)) {
+			child++;
+		}
+		if (!RankAbove(pData, bottom, child, k)) {
+			break;
+		}
+		RankSwap(pData, RankIndex(pData, bottom, k), RankIndex(pData, bottom, child));
+		k = child;
+	}
+}
+/* End of RankSift()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* RankAbove
+*
+* @param[in]     pData  pointer to AdaptiveFilter parameter/state struct
+* @param[in]     bottom 0: the top (min-)heap, 1: the bottom (max-)heap
+* @param[in]     a      heap element
+* @param[in]     b      another element of the same heap
+*
+* @returns       nonzero if element a belongs nearer the root than element b
+*
+* @note          none
+*
+* @warning       none
+*******************************************************************************/
+static int RankAbove(const AfData *pData, unsigned int bottom, unsigned int a, unsigned int b) {
+	const double keyA = fabs(pData->pBuffer[pData->pRank[RankIndex(pData, bottom, a)]]);
+	const double keyB = fabs(pData->pBuffer[pData->pRank[RankIndex(pData, bottom, b)]]);
+
+	return bottom ? keyA > keyB : keyA < keyB;
+}
+/* End of RankAbove()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* RankIndex
+*
+* @param[in]     pData  pointer to AdaptiveFilter parameter/state struct
+* @param[in]     bottom 0: the top heap, 1: the bottom heap
+* @param[in]     k      heap element
+*
+* @returns       pRank index of element k, counted from the front for the
+*  top heap and from the back for the bottom heap
+*
+* @note          none
+*
+* @warning       none
+*******************************************************************************/
+static unsigned int RankIndex(const AfData *pData, unsigned int bottom, unsigned int k) {
+	return bottom ? pData->Length - 1 - k : k;
+}
+/* End of RankIndex()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* RankSwap
+*
+* @param[in,out] pData pointer to AdaptiveFilter parameter/state struct
+* @param[in]     i     pRank index
+* @param[in]     j     pRank index
+*
+* @returns       none
+*
+* @note          Swaps two slots and updates their recorded positions.
+*
+* @warning       none
+*******************************************************************************/
+static void RankSwap(AfData *pData, unsigned int i, unsigned int j) {
+	unsigned int *pRank = pData->pRank, slot = pRank[i];
+
+	pRank[i] = pRank[j];
+	pRank[j] = slot;
+	pRank[pData->Length + pRank[i]] = i;
+	pRank[pData->Length + slot] = j;
+}
+/* End of RankSwap()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Freeze
+*
+* @param[in,out] pData pointer to AdaptiveFilter parameter/state struct
+*
+* @returns       none
+*
+* @note          Called before inputs are pushed without an update. Applies a
+*  pending fused update while its window is still current, then drops the
+*  state that only the update uses so it is rebuilt on the next adapted
+*  sample: the running norm is recomputed exactly, the fused norm measured
+*  again and the M-max heaps rebuilt from the delay line. Thawing therefore
+*  needs nothing beyond clearing pData->Frozen.
+*
+* @warning       none
+*******************************************************************************/
+static void Freeze(AfData *pData) {
+	AdaptiveFilterFlush(pData);
+	pData->NormCount = 0;
+	if (pData->Fused && pData->NormRefresh == 0) {
+		pData->Energy = -1.0;
+	}
+	pData->RankTop = 0;
+}
+/* End of Freeze()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* FirTimeDomain
+*
+* @param[in]     input  n input samples
+* @param[out]    output n outputs, may alias input
+* @param[in]     n      number of samples
+* @param[in,out] pData  pointer to AdaptiveFilter parameter/state struct
+*
+* @returns       none
+*
+* @note          One push and one dot product per sample, as Filter().
+*
+* @warning       none
+*******************************************************************************/
+static void FirTimeDomain(const double *input, double *output, size_t n, AfData *pData) {
+	double *pSeg0, *pSeg1;
+	unsigned int n0;
+	size_t i;
+
+	for ( i = 0; i < n; i++ ) {
+		PushInput(input[i], pData);
+		n0 = Window(pData, &pSeg0, &pSeg1);
+		output[i] = pData->pKernels->Dot(pData->pWeights, pSeg0, n0) +
+		            pData->pKernels->Dot(pData->pWeights + n0, pSeg1, pData->Length - n0);
+	}
+}
+/* End of FirTimeDomain()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* FirFftBlock
+*
+* @param[in]     input  n input samples, n <= pFir->Block
+* @param[out]    output n outputs, may alias input
+* @param[in]     n      number of samples
+* @param[in,out] pFir   block FIR
+*
+* @returns       none
+*
+* @note          Overlap-save: the Length-1 newest samples of the delay line,
+*  oldest first, then the n inputs and zeros fill a block of Size. Its
+*  circular convolution with the padded weights holds the n outputs from
+*  index Length-1 on. The inputs are pushed before the transform so that
+*  output may overwrite input.
+*
+* @warning       none
+*******************************************************************************/
+static void FirFftBlock(const double *input, double *output, size_t n, AfFir *pFir) {
+	AfData *pData = pFir->pData;
+	const unsigned int length = pData->Length, size = pFir->Size;
+	const double *pW = pFir->pWeightSpectrum;
+	double *pX = pFir->pSpectrum, *pT = pFir->pTime;
+	double *pSeg0, *pSeg1, xr, xi;
+	unsigned int n0, i, k, tap;
+
+	if (pFir->Stale) {
+		for ( i = 0; i < size; i++ ) {
+			pT[i] = (i < length) ? pData->pWeights[i] : 0.0;
+		}
+		AfFftForward(&pFir->Fft, pT, pFir->pWeightSpectrum);
+		pFir->Adaptations = pData->Adaptations;
+		pFir->Stale = 0;
+	}
+
+	/* history, oldest first: taps Length-2 down to 0 of the current window */
+	n0 = Window(pData, &pSeg0, &pSeg1);
+	for ( i = 0; i + 1 < length; i++ ) {
+		tap = length - 2 - i;
+		pT[i] = (tap < n0) ? pSeg0[tap] : pSeg1[tap - n0];
+	}
+	for ( i = 0; i < size - (length - 1); i++ ) {
+		pT[length - 1 + i] = (i < n) ? input[i] : 0.0;
+	}
+	for ( i = 0; i < n; i++ ) {
+		PushInput(input[i], pData);
+	}
+
+	AfFftForward(&pFir->Fft, pT, pX);
+	for ( k = 0; k <= size / 2; k++ ) {
+		xr = pX[2 * k];
+		xi = pX[2 * k + 1];
+		pX[2 * k] = xr * pW[2 * k] - xi * pW[2 * k + 1];
+		pX[2 * k + 1] = xr * pW[2 * k + 1] + xi * pW[2 * k];
+	}
+	AfFftInverse(&pFir->Fft, pX, pT);
+
+	for ( i = 0; i < n; i++ ) {
+		output[i] = pT[length - 1 + i];
+	}
+	pFir->FftBlocks++;
+}
+/* End of FirFftBlock()*/
+/******************************************************************************/
@@ -10,20 +10,117 @@
 #ifndef ADAPTIVEFILTER_H_
 #define ADAPTIVEFILTER_H_
 
-/* Contains Adaptive Filter parameters (StepSize,Regularization,Length)
- * and state info (Buffer, BufferIdx, Weights, and Error)
+#include <stddef.h>
+#include "AfArena.h"
+#include "AfFft.h"
+#include "AfKernels.h"
+
+#define AF_FIR_FFT_COST (15.0) /* cost of a forward and inverse FFT pair of
+                                * size N in time-domain taps per N*log2(N),
+                                * measured against the SIMD dot product */
+
+/* Delay line (input buffer) layouts. Both keep the newest sample at
+ * pBuffer[BufferIdx] with older samples following it, so the filter and
+ * weight update run over contiguous slices with no per-tap index wrapping.
+ */
+typedef enum {
+	AF_DELAY_CIRCULAR = 0, /* pBuffer holds Length samples; window wraps once */
+	AF_DELAY_MIRRORED /* pBuffer holds 2*Length samples, each input written
+	                   * twice, so the window is always one contiguous slice */
+} AfDelayLayout;
+
+/* Partial-update modes: each sample only UpdateTaps (M) of the Length weights
+ * are adapted, while the output still uses every tap. Convergence slows by
+ * up to Length/M in exchange for an update that costs M instead of Length
+ * multiply-adds.
+ */
+typedef enum {
+	AF_PARTIAL_NONE = 0, /* every tap is updated */
+	AF_PARTIAL_MMAX, /* the M taps with the largest |input|, tracked by a
+	                  * pair of heaps over pRank at O(log Length) per sample */
+	AF_PARTIAL_SEQUENTIAL, /* blocks of M consecutive taps in round-robin */
+	AF_PARTIAL_STOCHASTIC /* one of the same blocks picked at random */
+} AfPartialUpdate;
+
+/* Contains Adaptive Filter parameters (StepSize,Regularization,Length,Layout,
+ * NormRefresh,Fused,Partial,UpdateTaps,ErrorBound,Frozen) and state info (Buffer,
+ * BufferIdx, Weights, Error, running norm, pending update, partial-update
+ * state and update counters).
+ * Fields after Error may be left out of an initializer; zero selects the
+ * original behavior.
  */
 typedef struct {
 	const double StepSize; /* adaptive filter step size */
     const double Regularization; /* regularization constant */
 	const unsigned int Length; /* length of filter */
-	double *pBuffer; /* pointer to input buffer */
-    unsigned int BufferIdx; /* circular index into input buffer */
+	double *pBuffer; /* pointer to input buffer (2*Length if mirrored) */
+    unsigned int BufferIdx; /* index of newest sample in input buffer */
 	double *pWeights; /* pointer to adaptive filter weights */
 	double Error; /* pointer to output error (desired - output) state */
+	const AfDelayLayout Layout; /* delay line layout of pBuffer */
+	const unsigned int NormRefresh; /* 0: exact input norm every sample,
+	                                 * K: running norm, exact every K samples */
+	double Energy; /* running squared norm of the input vector */
+	double EnergyComp; /* compensation term of the running norm */
+	unsigned int NormCount; /* samples since the last exact norm */
+	const AfKernels *pKernels; /* vector kernels, NULL: best for the host,
+	                            * selected on first use (see AfKernelsGet) */
+	const unsigned int Fused; /* nonzero: single-pass filter-and-adapt with
+	                           * the update deferred one sample */
+	double PendingStep; /* deferred update scale (step * error) */
+	const AfPartialUpdate Partial; /* taps adapted per sample, see above */
+	unsigned int UpdateTaps; /* M, may be changed between samples;
+	                          * 0 or >= Length: every tap */
+	unsigned int *pRank; /* AF_PARTIAL_MMAX: 2*Length workspace, the heaps
+	                      * of buffer slots and each slot's heap position */
+	unsigned int RankTop; /* slots in the top-M heap, 0: not yet built */
+	unsigned int PartialIdx; /* first tap of the next sequential block */
+	unsigned int PartialSeed; /* stochastic block PRNG state, 0: default */
+	double ErrorBound; /* set-membership bound gamma, 0: off. Samples with
+	                    * |Error| <= gamma skip the update and norm; others
+	                    * step by 1 - gamma/|Error| in place of StepSize */
+	unsigned long Adaptations; /* samples seen by the weight update */
+	unsigned long Skipped; /* of which skipped by the set-membership bound */
+	unsigned int Frozen; /* nonzero: filter only, no update and no norm;
+	                      * may be toggled between samples */
 } AfData;
 
+/* Block FIR over the weights and delay line of an AfData, for running a
+ * converged filter as a fixed FIR. Set up with AdaptiveFilterFirInit() in
+ * caller-provided memory. Each call picks time-domain dot products or
+ * overlap-save FFT convolution, whichever the cost model says is cheaper
+ * for the filter length and block size.
+ */
+typedef struct {
+	AfData *pData; /* filter whose weights and delay line are used */
+	unsigned int Size; /* FFT size N, a power of two >= 2*Length */
+	unsigned int Block; /* outputs per FFT block, N - Length + 1 */
+	double FftCost; /* modelled cost of one FFT block, in taps */
+	AfFft Fft; /* real FFT of size N */
+	double *pWeightSpectrum; /* N/2+1 complex bins of the padded weights */
+	double *pSpectrum; /* N/2+1 complex bins: scratch spectrum */
+	double *pTime; /* N: scratch time-domain block */
+	unsigned long Adaptations; /* pData->Adaptations at the last transform */
+	unsigned int Stale; /* nonzero: transform the weights again before use;
+	                     * set it after writing pData->pWeights directly */
+	unsigned long FftBlocks; /* blocks run by FFT convolution */
+} AfFir;
+
+
 double AdaptiveFilterRun (double input, double desired, AfData *pData);
 double AdaptiveFilterRunErrorIn(double input, double error, AfData *pData);
+void AdaptiveFilterRunBlock(const double *input, const double *desired,
+                            double *output, double *error, size_t n,
+                            AfData *pData);
+void AdaptiveFilterFlush(AfData *pData);
+double AdaptiveFilterSkippedFraction(const AfData *pData);
+size_t AdaptiveFilterFirMemSize(unsigned int length);
+int AdaptiveFilterFirInit(AfFir *pFir, AfData *pData, void *pMem);
+void AdaptiveFilterFir(const double *input, double *output, size_t n,
+                       AfFir *pFir);
+size_t AdaptiveFilterArenaSize(unsigned int count, const AfData *pConfig);
+AfData *AdaptiveFilterCreate(AfArena *pArena, const AfData *pConfig);
+AfData *AdaptiveFilterCreateMany(AfArena *pArena, unsigned int count,
+                                 const AfData *pConfig);
 
 #endif /* ADAPTIVEFILTER_H_ */
@@ -0,0 +1,195 @@
+/*
+ * @file AdaptiveFilter.hpp
+ *
+ * Header-only C++ template of the normalized least-mean-square adaptive
+ * filter in AdaptiveFilter.c, parameterized on sample type and tap count.
+ *
+ *   af::AdaptiveFilter<double, 30> fixed(0.3, 1e-10);        // inline state
+ *   af::AdaptiveFilter<float> dynamic(0.3f, 1e-10f, 4096);   // heap state
+ *
+ * With a compile-time tap count the mirrored delay line and the weights are
+ * stored inline in the object and every loop has a constant trip count, so
+ * short filters compile to fully unrolled, register-resident kernels. The
+ * af::Dynamic specialization takes the length at runtime, and has no
+ * constructor without it. Both run the same
+ * algorithm: the mirrored delay line of AF_DELAY_MIRRORED, with the input
+ * energy computed in the same pass as the output.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+#ifndef ADAPTIVEFILTER_HPP_
+#define ADAPTIVEFILTER_HPP_
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace af {
+
+/* tap count that selects the runtime-length specialization */
+constexpr std::size_t Dynamic = 0;
+
+namespace detail {
+
+/* Inline storage for a compile-time tap count; any other length would
+ * run past the arrays, so it throws in every build */
+template <typename T, std::size_t N>
+class Storage {
+public:
+	explicit Storage(std::size_t length) : buffer_(), weights_() {
+		if (length != N) {
+			throw std::invalid_argument("af::AdaptiveFilter: length must equal N");
+		}
+	}
+	static constexpr std::size_t Length() { return N; }
+	T *Buffer() { return buffer_.data(); }
+	T *Weights() { return weights_.data(); }
+	const T *Weights() const { return weights_.data(); }
+
+private:
+	std::array<T, 2 * N> buffer_; /* mirrored delay line */
+	std::array<T, N> weights_;
+};
+
+/* Heap storage for a runtime tap count; a zero length would leave the
+ * delay line index with nowhere to point, so it throws in every build */
+template <typename T>
+class Storage<T, Dynamic> {
+public:
+	explicit Storage(std::size_t length)
+		: length_(length), buffer_(2 * length, T(0)), weights_(length, T(0)) {
+		if (length == 0) {
+			throw std::invalid_argument("af::AdaptiveFilter: length must be at least 1");
+		}
+	}
+	std::size_t Length() const { return length_; }
+	T *Buffer() { return buffer_.data(); }
+	T *Weights() { return weights_.data(); }
+	const T *Weights() const { return weights_.data(); }
+
+private:
+	std::size_t length_;
+	std::vector<T> buffer_; /* mirrored delay line */
+	std::vector<T> weights_;
+};
+
+} /* namespace detail */
+
+template <typename T, std::size_t N = Dynamic>
+class AdaptiveFilter : private detail::Storage<T, N> {
+	typedef detail::Storage<T, N> Storage;
+
+public:
+	/*
+	 * @param[in] stepSize       adaptive filter step size
+	 * @param[in] regularization regularization constant
+	 *
+	 * Compile-time tap count only; af::Dynamic filters must be given a length.
+	 */
+	AdaptiveFilter(T stepSize, T regularization)
+		: AdaptiveFilter(stepSize, regularization, N) {
+		static_assert(N != Dynamic, "af::Dynamic filters take the length as a third argument");
+	}
+
+	/*
+	 * @param[in] stepSize       adaptive filter step size
+	 * @param[in] regularization regularization constant
+	 * @param[in] length         number of taps, must equal N unless N is Dynamic
+	 *
+	 * Throws std::invalid_argument if length is not N, or if N is Dynamic
+	 * and length is 0.
+	 */
+	AdaptiveFilter(T stepSize, T regularization, std::size_t length)
+		: Storage(length), stepSize_(stepSize), regularization_(regularization),
+		  bufferIdx_(0), error_(0), energy_(0) {}
+
+	/* Runs the filter on one sample and adapts, see AdaptiveFilterRun() */
+	T Run(T input, T desired) {
+		const T output = Filter(input);
+		error_ = desired - output;
+		AdaptWeights();
+		return output;
+	}
+
+	/* Adapts with an external error, then filters, see AdaptiveFilterRunErrorIn() */
+	T RunErrorIn(T input, T error) {
+		error_ = error;
+		AdaptWeights();
+		return Filter(input);
+	}
+
+	/* Block form of Run(); output and error may be null */
+	void RunBlock(const T *input, const T *desired, T *output, T *error, std::size_t n) {
+		for (std::size_t i = 0; i < n; ++i) {
+			const T y = Run(input[i], desired[i]);
+			if (output) {
+				output[i] = y;
+			}
+			if (error) {
+				error[i] = error_;
+			}
+		}
+	}
+
+	std::size_t Length() const { return Storage::Length(); }
+	const T *Weights() const { return Storage::Weights(); }
+	T Error() const { return error_; }
+
+private:
+	/* lanes of independent partial sums, so reductions vectorize; the final
+	 * reductions below add exactly four */
+	static constexpr std::size_t Lanes = 4;
+
+	/* writes the input to both halves of the mirrored delay line and returns
+	 * the inner product; also measures the input energy for AdaptWeights */
+	T Filter(T input) {
+		const std::size_t length = Length();
+		T *pBuffer = Storage::Buffer();
+		const T *pW = Storage::Weights();
+		T acc[Lanes] = {}, energy[Lanes] = {};
+
+		bufferIdx_ = (bufferIdx_ == 0 ? length : bufferIdx_) - 1;
+		pBuffer[bufferIdx_] = input;
+		pBuffer[bufferIdx_ + length] = input;
+
+		const T *pX = pBuffer + bufferIdx_;
+		std::size_t i = 0;
+		for (; i + Lanes <= length; i += Lanes) {
+			for (std::size_t k = 0; k < Lanes; ++k) {
+				acc[k] += pW[i + k] * pX[i + k];
+				energy[k] += pX[i + k] * pX[i + k];
+			}
+		}
+		for (; i < length; ++i) {
+			acc[0] += pW[i] * pX[i];
+			energy[0] += pX[i] * pX[i];
+		}
+
+		energy_ = (energy[0] + energy[1]) + (energy[2] + energy[3]);
+		return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+	}
+
+	/* canonical NLMS update over the current input vector */
+	void AdaptWeights() {
+		const std::size_t length = Length();
+		const T *pX = Storage::Buffer() + bufferIdx_;
+		T *pW = Storage::Weights();
+		const T scale = stepSize_ / (regularization_ + energy_) * error_;
+
+		for (std::size_t i = 0; i < length; ++i) {
+			pW[i] += scale * pX[i];
+		}
+	}
+
+	T stepSize_;
+	T regularization_;
+	std::size_t bufferIdx_; /* index of newest sample in the delay line */
+	T error_; /* desired - output */
+	T energy_; /* squared norm of the current input vector */
+};
+
+} /* namespace af */
+
+#endif /* ADAPTIVEFILTER_HPP_ */
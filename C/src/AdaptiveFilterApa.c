@@ -0,0 +1,344 @@
+/*
+ * @file AdaptiveFilterApa.c
+ *
+ * Affine projection adaptive filter of order P. With X the Length x P
+ * matrix of the P newest input vectors and d the P newest desired samples:
+ *
+ *   e = d - X' w                          a-priori errors
+ *   R = X' X                              P x P input correlations
+ *   w += StepSize * X (R + Regularization I)^-1 e
+ *
+ * Order 1 is NLMS. Each extra order decorrelates the update against one
+ * more past input vector, which is what speeds convergence on coloured
+ * inputs. The input vectors are overlapping slices of one delay line, so R
+ * is not rebuilt each sample: its lower rows are last sample's upper rows
+ * shifted diagonally, and the first row is a sliding sum refreshed exactly
+ * every Length samples. The per-sample cost is P dot products and P vector
+ * updates of Length (P times NLMS) plus a P x P Cholesky solve.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+/******************************************************************************/
+/* include block */
+#include "AdaptiveFilterApa.h"
+#include <math.h>
+
+/******************************************************************************/
+/** local definitions **/
+static const double *PushInput(double input, AfApaData *pData);
+static void UpdateCorrelation(const double *pU, AfApaData *pData);
+static int Solve(AfApaData *pData);
+
+/******************************************************************************
+ * AdaptiveFilterApaMemSize
+ *
+ * @param[in]     length filter length
+ * @param[in]     order  projection order
+ *
+ * @returns       number of bytes AdaptiveFilterApaInit() needs in pMem
+ *
+ * @note          none
+ *
+ * @warning       none
+ */
+size_t AdaptiveFilterApaMemSize(unsigned int length, unsigned int order) {
+	/* must match the carving in AdaptiveFilterApaInit() */
+	return (3 * (size_t)length + 4 * (size_t)order + 2 * (size_t)order * order) *
+	       sizeof(double);
+}
+/* End of AdaptiveFilterApaMemSize() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterApaInit
+ *
+ * @param[out]    pData          pointer to affine projection AdaptiveFilter
+ *  parameter/state struct to initialize
+ * @param[in]     stepSize       adaptive filter step size, in (0,1]
+ * @param[in]     regularization added to the diagonal of the correlation
+ *  matrix
+ * @param[in]     length         filter length, at least 1
+ * @param[in]     order          projection order, 1 to AF_APA_MAX_ORDER
+ * @param[in]     pMem           AdaptiveFilterApaMemSize(length, order)
+ *  bytes, aligned for double
+ *
+ * @returns       0 on success, -1 if length or order is out of range
+ *
+ * @note          Clears the filter state and weights.
+ *
+ * @warning       pMem must stay valid for as long as pData is used
+ */
+int AdaptiveFilterApaInit(AfApaData *pData, double stepSize,
+                          double regularization, unsigned int length,
+                          unsigned int order, void *pMem) {
+	double *p = (double *)pMem;
+	size_t i, total;
+
+	if (length == 0 || order == 0 || order > AF_APA_MAX_ORDER) {
+		return -1;
+	}
+
+	pData->StepSize = stepSize;
+	pData->Regularization = regularization;
+	pData->Length = length;
+	pData->Order = order;
+	pData->BufferIdx = 0;
+	pData->RefreshCount = 0;
+	pData->pKernels = AfKernelsGet(AF_ISA_AUTO);
+	pData->Error = 0.0;
+
+	pData->pBuffer = p;       p += 2 * (length + order);
+	pData->pWeights = p;      p += length;
+	pData->pDesired = p;      p += order;
+	pData->pCorrelation = p;  p += order * order;
+	pData->pFactor = p;       p += order * order;
+	pData->pErrors = p;       p += order;
+
+	total = (size_t)(p - (double *)pMem);
+	for ( i = 0; i < total; i++ ) {
+		((double *)pMem)[i] = 0.0;
+	}
+
+	return 0;
+}
+/* End of AdaptiveFilterApaInit() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterApaRun
+ *
+ * @param[in]     input  input signal sample
+ * @param[in]     desired desired signal sample
+ * @param[in,out] pData  pointer to affine projection AdaptiveFilter
+ *  parameter/state struct
+ *
+ * @returns       adaptive filter output (estimate of desired signal)
+ *
+ * @note          Filters the input and applies the affine projection update.
+ *  pData->Error is the error of this sample. If the regularized
+ *  correlation matrix is not positive definite the update is skipped.
+ *
+ * @warning       none
+ */
+double AdaptiveFilterApaRun(double input, double desired, AfApaData *pData) {
+	const unsigned int length = pData->Length, order = pData->Order;
+	const AfKernels *pK;
+	const double *pU;
+	double output = 0.0, y;
+	unsigned int j;
+
+	if (!pData->pKernels) {
+		pData->pKernels = AfKernelsGet(AF_ISA_AUTO); /* select SIMD kernels on first use */
+	}
+	pK = pData->pKernels;
+
+	pU = PushInput(input, pData);
+	for ( j = order - 1; j > 0; j-- ) {
+		pData->pDesired[j] = pData->pDesired[j - 1];
+	}
+	pData->pDesired[0] = desired;
+	UpdateCorrelation(pU, pData);
+
+	/* a-priori errors of the Order newest input vectors */
+	for ( j = 0; j < order; j++ ) {
+		y = pK->Dot(pData->pWeights, pU + j, length);
+		if (j == 0) {
+			output = y;
+		}
+		pData->pErrors[j] = pData->pDesired[j] - y;
+	}
+	pData->Error = pData->pErrors[0];
+
+	/* w += StepSize * X (R + Regularization I)^-1 e */
+	if (Solve(pData) == 0) {
+		for ( j = 0; j < order; j++ ) {
+			pK->ScaledAdd(pData->pWeights, pData->StepSize * pData->pErrors[j],
+			              pU + j, length);
+		}
+	}
+
+	return output;
+}
+/* End of AdaptiveFilterApaRun() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterApaRunBlock
+ *
+ * @param[in]     input   block of n input signal samples
+ * @param[in]     desired block of n desired signal samples
+ * @param[out]    output  block of n adaptive filter outputs (may be NULL)
+ * @param[out]    error   block of n errors, desired - output (may be NULL)
+ * @param[in]     n       number of samples in the block
+ * @param[in,out] pData   pointer to affine projection AdaptiveFilter
+ *  parameter/state struct
+ *
+ * @returns       none
+ *
+ * @note          Same results as calling AdaptiveFilterApaRun() once per
+ *  sample.
+ *
+ * @warning       input and desired must not alias output or error
+ */
+void AdaptiveFilterApaRunBlock(const double *input, const double *desired,
+                               double *output, double *error, size_t n,
+                               AfApaData *pData) {
+	double y;
+	size_t i;
+
+	for ( i = 0; i < n; i++ ) {
+		y = AdaptiveFilterApaRun(input[i], desired[i], pData);
+		if (output) {
+			output[i] = y;
+		}
+		if (error) {
+			error[i] = pData->Error;
+		}
+	}
+}
+/* End of AdaptiveFilterApaRunBlock() */
+/******************************************************************************/
+
+/** internal functions **/
+
+/***************************************************************************//**
+* PushInput
+*
+* @param[in]     input new input sample
+* @param[in,out] pData pointer to affine projection AdaptiveFilter
+*  parameter/state struct
+*
+* @returns       the Length + Order newest inputs, newest first, contiguous
+*
+* @note          Mirrored delay line as in AdaptiveFilter.c: each sample is
+*  written twice so the whole history is always one slice.
+*
+* @warning       none
+*******************************************************************************/
+static const double *PushInput(double input, AfApaData *pData) {
+	const unsigned int span = pData->Length + pData->Order;
+	unsigned int idx = pData->BufferIdx;
+
+	/* wrap index */
+	if (idx == 0) {
+		idx = span;
+	}
+	idx--;
+
+	pData->pBuffer[idx] = input;
+	pData->pBuffer[idx + span] = input;
+	pData->BufferIdx = idx;
+
+	return pData->pBuffer + idx;
+}
+/* End of PushInput()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* UpdateCorrelation
+*
+* @param[in]     pU    the Length + Order newest inputs, newest first
+* @param[in,out] pData pointer to affine projection AdaptiveFilter
+*  parameter/state struct
+*
+* @returns       none
+*
+* @note          R[i][j] = sum_k u[i+k] u[j+k], k < Length. Entry (i,j)
+*  equals last sample's (i-1,j-1); row 0 slides by one sample in and one
+*  out, and is recomputed exactly every Length samples so the sliding sums
+*  cannot drift.
+*
+* @warning       none
+*******************************************************************************/
+static void UpdateCorrelation(const double *pU, AfApaData *pData) {
+	const unsigned int length = pData->Length, order = pData->Order;
+	double *pR = pData->pCorrelation;
+	unsigned int i, j;
+
+	for ( i = order - 1; i > 0; i-- ) {
+		for ( j = order - 1; j > 0; j-- ) {
+			pR[i * order + j] = pR[(i - 1) * order + j - 1];
+		}
+	}
+
+	if (++pData->RefreshCount >= length) {
+		for ( j = 0; j < order; j++ ) {
+			pR[j] = pData->pKernels->Dot(pU, pU + j, length);
+		}
+		pData->RefreshCount = 0;
+	}
+	else {
+		for ( j = 0; j < order; j++ ) {
+			pR[j] += pU[0] * pU[j] - pU[length] * pU[length + j];
+		}
+	}
+	for ( j = 1; j < order; j++ ) {
+		pR[j * order] = pR[j];
+	}
+}
+/* End of UpdateCorrelation()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Solve
+*
+* @param[in,out] pData pointer to affine projection AdaptiveFilter
+*  parameter/state struct; pErrors holds e on entry and the solution on
+*  return
+*
+* @returns       0 on success, -1 if R + Regularization I is not positive
+*  definite
+*
+* @note          Cholesky factorization into pFactor and two triangular
+*  solves, O(Order^3 / 6).
+*
+* @warning       none
+*******************************************************************************/
+static int Solve(AfApaData *pData) {
+	const unsigned int order = pData->Order;
+	const double *pR = pData->pCorrelation;
+	double *pL = pData->pFactor;
+	double *pX = pData->pErrors;
+	double sum;
+	unsigned int i, j, k;
+
+	for ( i = 0; i < order; i++ ) {
+		for ( j = 0; j <= i; j++ ) {
+			sum = pR[i * order + j];
+			if (i == j) {
+				sum += pData->Regularization;
+			}
+			for ( k = 0; k < j; k++ ) {
+				sum -= pL[i * order + k] * pL[j * order + k];
+			}
+			if (i == j) {
+				if (!(sum > 0.0)) {
+					return -1;
+				}
+				pL[i * order + i] = sqrt(sum);
+			}
+			else {
+				pL[i * order + j] = sum / pL[j * order + j];
+			}
+		}
+	}
+
+	/* L z = e, then L' x = z, in place */
+	for ( i = 0; i < order; i++ ) {
+		for ( k = 0; k < i; k++ ) {
+			pX[i] -= pL[i * order + k] * pX[k];
+		}
+		pX[i] /= pL[i * order + i];
+	}
+	for ( i = order; i-- > 0; ) {
+		for ( k = i + 1; k < order; k++ ) {
+			pX[i] -= pL[k * order + i] * pX[k];
+		}
+		pX[i] /= pL[i * order + i];
+	}
+
+	return 0;
+}
+/* End of Solve()*/
+/******************************************************************************/
@@ -0,0 +1,52 @@
+/*
+ * @file AdaptiveFilterApa.h
+ *
+ * Header file for AdaptiveFilterApa.c, the affine projection algorithm
+ * (APA) of order Order: NLMS generalized to project onto the last Order
+ * input vectors, for fast convergence on coloured inputs.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+#ifndef ADAPTIVEFILTERAPA_H_
+#define ADAPTIVEFILTERAPA_H_
+
+#include <stddef.h>
+#include "AfKernels.h"
+
+#define AF_APA_MAX_ORDER (16) /* largest projection order */
+
+/* Contains affine projection Adaptive Filter parameters (StepSize,
+ * Regularization, Length, Order) and state info. Set up with
+ * AdaptiveFilterApaInit() in caller-provided memory. The delay line has the
+ * mirrored layout of AfData, Length + Order samples long, so the Order input
+ * vectors are overlapping slices of it.
+ */
+typedef struct {
+	double StepSize; /* adaptive filter step size, in (0,1] */
+	double Regularization; /* added to the diagonal of the correlation matrix */
+	unsigned int Length; /* filter length */
+	unsigned int Order; /* projection order, 1 (NLMS) to AF_APA_MAX_ORDER */
+	double *pBuffer; /* mirrored delay line, 2*(Length+Order) samples */
+	unsigned int BufferIdx; /* index of newest sample in pBuffer */
+	double *pWeights; /* Length adaptive filter weights */
+	double *pDesired; /* Order desired samples, newest first */
+	double *pCorrelation; /* Order x Order input vector correlations */
+	double *pFactor; /* Order x Order scratch: Cholesky factor */
+	double *pErrors; /* Order scratch: a-priori errors, then the solution */
+	unsigned int RefreshCount; /* samples since the exact correlation row */
+	const AfKernels *pKernels; /* vector kernels, NULL: best for the host,
+	                            * selected on first use (see AfKernelsGet) */
+	double Error; /* error of the newest sample (desired - output) */
+} AfApaData;
+
+size_t AdaptiveFilterApaMemSize(unsigned int length, unsigned int order);
+int AdaptiveFilterApaInit(AfApaData *pData, double stepSize,
+                          double regularization, unsigned int length,
+                          unsigned int order, void *pMem);
+double AdaptiveFilterApaRun(double input, double desired, AfApaData *pData);
+void AdaptiveFilterApaRunBlock(const double *input, const double *desired,
+                               double *output, double *error, size_t n,
+                               AfApaData *pData);
+
+#endif /* ADAPTIVEFILTERAPA_H_ */
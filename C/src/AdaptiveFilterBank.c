@@ -0,0 +1,202 @@
+/*
+ * @file AdaptiveFilterBank.c
+ *
+ * Bank of Channels independent normalized least-mean-square adaptive
+ * filters, each Length taps long, advanced one sample (one frame of
+ * Channels samples) at a time. Instead of one AfData per channel with its
+ * own buffers, the weights and delay lines of all channels are interleaved
+ * tap-major, so the filter and update kernels walk contiguous rows with the
+ * SIMD lanes running across channels and no horizontal reductions. Each
+ * channel computes exactly what AdaptiveFilterRun() does, with its input
+ * energy accumulated in the filtering pass.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+/******************************************************************************/
+/* include block */
+#include "AdaptiveFilterBank.h"
+
+/******************************************************************************/
+/** local definitions **/
+static void Step(const double *input, const double *desired, unsigned int idx,
+                 unsigned int first, unsigned int count, AfBank *pBank);
+
+/******************************************************************************
+ * AdaptiveFilterBankRun
+ *
+ * @param[in]     input   one input signal sample per channel
+ * @param[in]     desired one desired signal sample per channel
+ * @param[in,out] pBank   pointer to filter bank parameter/state struct
+ *
+ * @returns       none
+ *
+ * @note          Runs every channel of the bank on one sample and adapts.
+ *  The outputs and errors are left in pBank->pOutput and pBank->pError.
+ *
+ * @warning       none
+ */
+void AdaptiveFilterBankRun(const double *input, const double *desired, AfBank *pBank) {
+	AdaptiveFilterBankRunBlock(input, desired, NULL, NULL, 1, pBank);
+}
+/* End of AdaptiveFilterBankRun() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterBankRunBlock
+ *
+ * @param[in]     input   n frames of Channels interleaved input samples
+ * @param[in]     desired n frames of Channels interleaved desired samples
+ * @param[out]    output  n frames of outputs, same layout (may be NULL)
+ * @param[out]    error   n frames of errors, same layout (may be NULL)
+ * @param[in]     n       number of frames (samples per channel)
+ * @param[in,out] pBank   pointer to filter bank parameter/state struct
+ *
+ * @returns       none
+ *
+ * @note          Block form of AdaptiveFilterBankRun(), identical to n
+ *  per-frame calls.
+ *
+ * @warning       input and desired must not alias output or error
+ */
+void AdaptiveFilterBankRunBlock(const double *input, const double *desired,
+                                double *output, double *error, size_t n,
+                                AfBank *pBank) {
+	AdaptiveFilterBankRunChannels(input, desired, output, error, n,
+	                              0, pBank->Channels, pBank);
+	AdaptiveFilterBankAdvance(n, pBank);
+}
+/* End of AdaptiveFilterBankRunBlock() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterBankRunChannels
+ *
+ * @param[in]     input   n frames of Channels interleaved input samples
+ * @param[in]     desired n frames of Channels interleaved desired samples
+ * @param[out]    output  n frames of outputs, same layout (may be NULL)
+ * @param[out]    error   n frames of errors, same layout (may be NULL)
+ * @param[in]     n       number of frames (samples per channel)
+ * @param[in]     first   first channel to run
+ * @param[in]     count   number of channels to run
+ * @param[in,out] pBank   pointer to filter bank parameter/state struct
+ *
+ * @returns       none
+ *
+ * @note          Runs channels [first, first + count) over n frames, reading
+ *  and writing only their columns of the frames and of the bank state, so
+ *  disjoint channel ranges may run concurrently. The shared delay line
+ *  position is not advanced: once every channel has run the same n frames,
+ *  call AdaptiveFilterBankAdvance(n) once.
+ *
+ * @warning       pBank->pKernels must already be set when ranges run
+ *  concurrently
+ */
+void AdaptiveFilterBankRunChannels(const double *input, const double *desired,
+                                   double *output, double *error, size_t n,
+                                   unsigned int first, unsigned int count,
+                                   AfBank *pBank) {
+	const unsigned int length = pBank->Length, channels = pBank->Channels;
+	unsigned int c, idx = pBank->BufferIdx;
+	size_t t;
+
+	if (!pBank->pKernels) {
+		pBank->pKernels = AfKernelsGet(AF_ISA_AUTO); /* select on first use */
+	}
+
+	for ( t = 0; t < n; t++ ) {
+		/* wrap index */
+		if (idx == 0 || idx > length) {
+			idx = length;
+		}
+		idx--;
+
+		Step(input + t * channels, desired + t * channels, idx, first, count, pBank);
+
+		for ( c = first; c < first + count; c++ ) {
+			if (output) {
+				output[t * channels + c] = pBank->pOutput[c];
+			}
+			if (error) {
+				error[t * channels + c] = pBank->pError[c];
+			}
+		}
+	}
+}
+/* End of AdaptiveFilterBankRunChannels() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterBankAdvance
+ *
+ * @param[in]     n       number of frames every channel has run
+ * @param[in,out] pBank   pointer to filter bank parameter/state struct
+ *
+ * @returns       none
+ *
+ * @note          Moves the shared delay line position on by n frames after
+ *  AdaptiveFilterBankRunChannels() has covered every channel.
+ *
+ * @warning       none
+ */
+void AdaptiveFilterBankAdvance(size_t n, AfBank *pBank) {
+	const unsigned int length = pBank->Length;
+	unsigned int idx = pBank->BufferIdx;
+
+	if (idx == 0 || idx > length) {
+		idx = length;
+	}
+	pBank->BufferIdx = (unsigned int)((idx + length - n % length) % length);
+}
+/* End of AdaptiveFilterBankAdvance() */
+/******************************************************************************/
+
+/** internal functions **/
+
+/***************************************************************************//**
+* Step
+*
+* @param[in]     input   one input signal sample per channel
+* @param[in]     desired one desired signal sample per channel
+* @param[in]     idx     delay line row of the new frame
+* @param[in]     first   first channel to run
+* @param[in]     count   number of channels to run
+* @param[in,out] pBank   pointer to filter bank parameter/state struct
+*
+* @returns       none
+*
+* @note          Writes the frame's samples for the channel range into the
+*  mirrored delay line, then one BankDot sweep computes every channel's
+*  output and input energy and one BankScaledAdd sweep applies every
+*  channel's NLMS update.
+*
+* @warning       none
+*******************************************************************************/
+static void Step(const double *input, const double *desired, unsigned int idx,
+                 unsigned int first, unsigned int count, AfBank *pBank) {
+	const unsigned int length = pBank->Length, channels = pBank->Channels;
+	double *pRow, *pMirror;
+	unsigned int c;
+
+	/* overwrite the oldest frame with the new one (and its mirror) */
+	pRow = pBank->pBuffer + (size_t)idx * channels + first;
+	pMirror = pRow + (size_t)length * channels;
+	for ( c = 0; c < count; c++ ) {
+		pRow[c] = input[first + c];
+		pMirror[c] = input[first + c];
+	}
+
+	pBank->pKernels->BankDot(pBank->pWeights + first, pRow, length, count, channels,
+	                         pBank->pOutput + first, pBank->pEnergy + first);
+
+	for ( c = first; c < first + count; c++ ) {
+		pBank->pError[c] = desired[c] - pBank->pOutput[c];
+		pBank->pScale[c] = pBank->StepSize / (pBank->Regularization + pBank->pEnergy[c]) *
+		                   pBank->pError[c];
+	}
+
+	pBank->pKernels->BankScaledAdd(pBank->pWeights + first, pBank->pScale + first, pRow,
+	                               length, count, channels);
+}
+/* End of Step()*/
+/******************************************************************************/
@@ -0,0 +1,51 @@
+/*
+ * @file AdaptiveFilterBank.h
+ *
+ * Header file for AdaptiveFilterBank.c, a bank of independent normalized
+ * least-mean-square adaptive filters of the same length that advance
+ * together, with their state stored as structure-of-arrays.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+#ifndef ADAPTIVEFILTERBANK_H_
+#define ADAPTIVEFILTERBANK_H_
+
+#include <stddef.h>
+#include "AfKernels.h"
+
+/* Contains filter bank parameters (StepSize,Regularization,Length,Channels)
+ * and state info. Arrays are tap-major with the channels interleaved:
+ * element [i * Channels + c] is tap i of channel c, so one SIMD register
+ * holds the same tap of several channels. The caller provides
+ *   pBuffer   2 * Length * Channels doubles (mirrored delay line, zeroed)
+ *   pWeights  Length * Channels doubles
+ *   pOutput, pError, pEnergy, pScale  Channels doubles each
+ */
+typedef struct {
+	const double StepSize; /* adaptive filter step size, all channels */
+	const double Regularization; /* regularization constant, all channels */
+	const unsigned int Length; /* length of every channel's filter */
+	const unsigned int Channels; /* number of channels */
+	double *pBuffer; /* mirrored delay line, 2*Length rows of Channels */
+	unsigned int BufferIdx; /* row of the newest samples in pBuffer */
+	double *pWeights; /* adaptive filter weights, Length rows of Channels */
+	double *pOutput; /* outputs of the last sample, per channel */
+	double *pError; /* errors (desired - output) of the last sample */
+	double *pEnergy; /* squared norms of the input vectors, per channel */
+	double *pScale; /* scratch: per-channel update gains */
+	const AfKernels *pKernels; /* vector kernels, NULL: best for the host,
+	                            * selected on first use (see AfKernelsGet) */
+} AfBank;
+
+void AdaptiveFilterBankRun(const double *input, const double *desired, AfBank *pBank);
+void AdaptiveFilterBankRunBlock(const double *input, const double *desired,
+                                double *output, double *error, size_t n,
+                                AfBank *pBank);
+void AdaptiveFilterBankRunChannels(const double *input, const double *desired,
+                                   double *output, double *error, size_t n,
+                                   unsigned int first, unsigned int count,
+                                   AfBank *pBank);
+void AdaptiveFilterBankAdvance(size_t n, AfBank *pBank);
+
+#endif /* ADAPTIVEFILTERBANK_H_ */
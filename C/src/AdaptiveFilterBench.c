@@ -0,0 +1,497 @@
+/*
+ * @file AdaptiveFilterBench.c
+ *
+ * Benchmark for AdaptiveFilter: times AdaptiveFilterRun(),
+ * AdaptiveFilterRunErrorIn() and AdaptiveFilterRunBlock() over tap lengths
+ * from 8 to 65536 with every kernel table the host supports, for each filter
+ * variant: both delay line layouts, the fused sweep, the running norm,
+ * partial update, set-membership and a frozen filter. Each case is
+ * warmed up, then timed over BENCH_REPEATS repeats of a batch sized to
+ * about BENCH_REPEAT_NS, and reported as the median and p99 of the repeats
+ * in ns/sample, with samples/s, GFLOP/s and the number of 48 kHz channels
+ * one core could run, as CSV and/or JSON.
+ *
+ * Usage: AdaptiveFilterBench [--csv FILE] [--json FILE] [--min-taps N]
+ *                            [--max-taps N] [--repeats N] [--variant NAME]
+ *
+ * Created on: Oct 16, 2026
+ */
+
+/******************************************************************************/
+/* include block */
+#include "AdaptiveFilter.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/******************************************************************************/
+/** local definitions **/
+#define BENCH_MIN_TAPS (8) /* shortest filter timed */
+#define BENCH_MAX_TAPS (65536) /* longest filter timed */
+#define BENCH_REPEATS (101) /* timed repeats per case, odd for the median */
+#define BENCH_REPEAT_NS (200000.0) /* target duration of one repeat */
+#define BENCH_WARMUP_NS (5000000.0) /* untimed running before the repeats */
+#define BENCH_BLOCK (64) /* samples per AdaptiveFilterRunBlock() call */
+#define BENCH_SIGNAL (4096) /* signal samples, cycled, a multiple of BENCH_BLOCK */
+#define BENCH_SAMPLE_RATE (48000.0) /* real-time rate for the channel count */
+#define BENCH_FLOPS_PER_TAP (6.0) /* dot product, input norm and update,
+                                   * a multiply and an add each; nominal,
+                                   * the same for every variant */
+#define BENCH_NORM_REFRESH (64) /* NormRefresh of the running norm variant */
+#define BENCH_PARTIAL_DIVISOR (4) /* partial variants update Length/4 taps */
+#define BENCH_ERROR_BOUND (0.5) /* set-membership bound; skips about half
+                                 * the updates on the uncorrelated signals */
+#define BENCH_STEPSIZE (0.3)
+#define BENCH_REGULARIZATION (1.0E-10)
+#define BENCH_SEED (824)
+
+/* call pattern being timed */
+typedef enum {
+	BENCH_RUN = 0, /* AdaptiveFilterRun() per sample */
+	BENCH_ERROR_IN, /* AdaptiveFilterRunErrorIn() per sample */
+	BENCH_RUN_BLOCK, /* AdaptiveFilterRunBlock() per BENCH_BLOCK samples */
+	BENCH_MODES
+} BenchMode;
+
+static const char *const modeNames[BENCH_MODES] = { "run", "error_in", "run_block" };
+
+/* filter configuration being timed; fields left out are the defaults */
+typedef struct {
+	const char *Name;
+	AfDelayLayout Layout;
+	unsigned int NormRefresh;
+	unsigned int Fused;
+	AfPartialUpdate Partial;
+	double ErrorBound;
+	unsigned int Frozen;
+} BenchVariant;
+
+static const BenchVariant variants[] = {
+	{ .Name = "mirrored", .Layout = AF_DELAY_MIRRORED },
+	{ .Name = "circular", .Layout = AF_DELAY_CIRCULAR },
+	{ .Name = "fused", .Layout = AF_DELAY_MIRRORED, .Fused = 1 },
+	{ .Name = "norm_refresh", .Layout = AF_DELAY_MIRRORED, .NormRefresh = BENCH_NORM_REFRESH },
+	{ .Name = "partial_mmax", .Layout = AF_DELAY_MIRRORED, .Partial = AF_PARTIAL_MMAX },
+	{ .Name = "partial_sequential", .Layout = AF_DELAY_MIRRORED, .Partial = AF_PARTIAL_SEQUENTIAL },
+	{ .Name = "set_membership", .Layout = AF_DELAY_MIRRORED, .ErrorBound = BENCH_ERROR_BOUND },
+	{ .Name = "frozen", .Layout = AF_DELAY_MIRRORED, .Frozen = 1 }
+};
+#define BENCH_VARIANTS (sizeof(variants) / sizeof(variants[0]))
+
+/* One timed case */
+typedef struct {
+	const char *Isa; /* kernel table name */
+	const char *Mode; /* call pattern name */
+	const char *Variant; /* filter variant name */
+	unsigned int Taps; /* filter length */
+	double MedianNs; /* median ns/sample over the repeats */
+	double P99Ns; /* 99th percentile ns/sample over the repeats */
+	double SamplesPerSec; /* at the median */
+	double Gflops; /* at the median, BENCH_FLOPS_PER_TAP per tap */
+	double Channels; /* BENCH_SAMPLE_RATE channels per core at the median */
+} BenchResult;
+
+static double input[BENCH_SIGNAL], desired[BENCH_SIGNAL];
+
+static double NowNs(void);
+static AfData VariantConfig(const BenchVariant *pVariant, unsigned int taps);
+static double RunBatch(AfData *pData, BenchMode mode, size_t samples);
+static void TimeCase(AfData *pData, BenchMode mode, unsigned int repeats,
+                     double *pTimes, BenchResult *pResult);
+static int CompareDouble(const void *pA, const void *pB);
+static int WriteCsv(const char *pPath, const BenchResult *pResults, unsigned int count);
+static int WriteJson(const char *pPath, const BenchResult *pResults, unsigned int count);
+
+/******************************************************************************
+ * main
+ *
+ * @param[in]     argc argument count
+ * @param[in]     argv options, see the file header
+ *
+ * @returns       0 on success, 1 on a bad option or an output error
+ *
+ * @note          Prints one line per case to stdout as it finishes.
+ *
+ * @warning       none
+ */
+int main(int argc, char *argv[]) {
+	static const AfIsa isas[] = {
+		AF_ISA_SCALAR, AF_ISA_SSE2, AF_ISA_AVX2, AF_ISA_AVX512, AF_ISA_NEON
+	};
+	const char *pCsv = NULL, *pJson = NULL, *pVariant = NULL;
+	unsigned int minTaps = BENCH_MIN_TAPS, maxTaps = BENCH_MAX_TAPS;
+	unsigned int repeats = BENCH_REPEATS, count = 0, capacity, taps, k, m, v;
+	unsigned int selected = 0;
+	size_t arenaSize, size;
+	const AfKernels *pKernels;
+	BenchResult *pResults;
+	double *pTimes;
+	AfArena arena;
+	AfData *pData;
+	int i, status = 0;
+
+	for ( i = 1; i < argc; i++ ) {
+		if (i + 1 < argc && strcmp(argv[i], "--csv") == 0) {
+			pCsv = argv[++i];
+		}
+		else if (i + 1 < argc && strcmp(argv[i], "--json") == 0) {
+			pJson = argv[++i];
+		}
+		else if (i + 1 < argc && strcmp(argv[i], "--min-taps") == 0) {
+			minTaps = (unsigned int)strtoul(argv[++i], NULL, 0);
+		}
+		else if (i + 1 < argc && strcmp(argv[i], "--max-taps") == 0) {
+			maxTaps = (unsigned int)strtoul(argv[++i], NULL, 0);
+		}
+		else if (i + 1 < argc && strcmp(argv[i], "--repeats") == 0) {
+			repeats = (unsigned int)strtoul(argv[++i], NULL, 0);
+		}
+		else if (i + 1 < argc && strcmp(argv[i], "--variant") == 0) {
+			pVariant = argv[++i];
+		}
+		else {
+			fprintf(stderr, "usage: %s [--csv FILE] [--json FILE] [--min-taps N] "
+			        "[--max-taps N] [--repeats N] [--variant NAME]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (minTaps == 0 || maxTaps < minTaps || repeats == 0) {
+		fprintf(stderr, "%s: need 0 < min-taps <= max-taps and repeats > 0\n", argv[0]);
+		return 1;
+	}
+	for ( v = 0; v < BENCH_VARIANTS; v++ ) {
+		if (!pVariant || strcmp(pVariant, variants[v].Name) == 0) {
+			selected++;
+		}
+	}
+	if (selected == 0) {
+		fprintf(stderr, "%s: unknown variant %s\n", argv[0], pVariant);
+		return 1;
+	}
+
+	srand(BENCH_SEED);
+	for ( k = 0; k < BENCH_SIGNAL; k++ ) {
+		input[k] = ( 2 * (double)rand() / (double)RAND_MAX ) - 1;
+		desired[k] = ( 2 * (double)rand() / (double)RAND_MAX ) - 1;
+	}
+
+	capacity = 0;
+	for ( taps = minTaps; taps <= maxTaps && taps != 0; taps *= 2 ) {
+		capacity++;
+	}
+	capacity *= (unsigned int)(sizeof(isas) / sizeof(isas[0])) * BENCH_MODES * selected;
+	pResults = (BenchResult *)malloc(capacity * sizeof(BenchResult));
+	pTimes = (double *)malloc(repeats * sizeof(double));
+	if (!pResults || !pTimes) {
+		fprintf(stderr, "%s: out of memory\n", argv[0]);
+		free(pResults);
+		free(pTimes);
+		return 1;
+	}
+
+	printf("isa,mode,variant,taps,median_ns,p99_ns,samples_per_s,gflops,channels_48k\n");
+	for ( taps = minTaps; taps <= maxTaps && taps != 0; taps *= 2 ) {
+		/* one arena per length, sized for the largest variant */
+		arenaSize = 0;
+		for ( v = 0; v < BENCH_VARIANTS; v++ ) {
+			const AfData config = VariantConfig(&variants[v], taps);
+
+			size = AdaptiveFilterArenaSize(1, &config);
+			arenaSize = (size > arenaSize) ? size : arenaSize;
+		}
+		if (AfArenaInit(&arena, arenaSize, 0) != 0) {
+			fprintf(stderr, "%s: cannot allocate %u taps\n", argv[0], taps);
+			status = 1;
+			break;
+		}
+		for ( k = 0; k < sizeof(isas) / sizeof(isas[0]); k++ ) {
+			pKernels = AfKernelsGet(isas[k]);
+			if (!pKernels) {
+				continue; /* not built for or not supported by this host */
+			}
+			for ( v = 0; v < BENCH_VARIANTS; v++ ) {
+				const AfData config = VariantConfig(&variants[v], taps);
+
+				if (pVariant && strcmp(pVariant, variants[v].Name) != 0) {
+					continue;
+				}
+				for ( m = 0; m < BENCH_MODES; m++ ) {
+					AfArenaReset(&arena);
+					pData = AdaptiveFilterCreate(&arena, &config);
+					pData->pKernels = pKernels;
+
+					TimeCase(pData, (BenchMode)m, repeats, pTimes, &pResults[count]);
+					pResults[count].Isa = pKernels->Name;
+					pResults[count].Variant = variants[v].Name;
+					printf("%s,%s,%s,%u,%.2f,%.2f,%.0f,%.3f,%.1f\n", pResults[count].Isa,
+					       pResults[count].Mode, pResults[count].Variant, taps,
+					       pResults[count].MedianNs, pResults[count].P99Ns,
+					       pResults[count].SamplesPerSec, pResults[count].Gflops,
+					       pResults[count].Channels);
+					fflush(stdout);
+					count++;
+				}
+			}
+		}
+		AfArenaDestroy(&arena);
+	}
+
+	if (pCsv && WriteCsv(pCsv, pResults, count) != 0) {
+		fprintf(stderr, "%s: cannot write %s\n", argv[0], pCsv);
+		status = 1;
+	}
+	if (pJson && WriteJson(pJson, pResults, count) != 0) {
+		fprintf(stderr, "%s: cannot write %s\n", argv[0], pJson);
+		status = 1;
+	}
+
+	free(pResults);
+	free(pTimes);
+	return status;
+}
+/* End of main() */
+/******************************************************************************/
+
+/** internal functions **/
+
+/***************************************************************************//**
+* NowNs
+*
+* @param[in]     none
+*
+* @returns       monotonic time in nanoseconds
+*
+* @note          none
+*
+* @warning       none
+*******************************************************************************/
+static double NowNs(void) {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec * 1.0E9 + (double)now.tv_nsec;
+}
+/* End of NowNs()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* VariantConfig
+*
+* @param[in]     pVariant filter variant
+* @param[in]     taps     filter length
+*
+* @returns       configuration for AdaptiveFilterArenaSize() and
+*  AdaptiveFilterCreate()
+*
+* @note          Partial-update variants adapt taps / BENCH_PARTIAL_DIVISOR
+*  taps per sample, at least one.
+*
+* @warning       none
+*******************************************************************************/
+static AfData VariantConfig(const BenchVariant *pVariant, unsigned int taps) {
+	const AfData config = {
+		.StepSize = BENCH_STEPSIZE,
+		.Regularization = BENCH_REGULARIZATION,
+		.Length = taps,
+		.Layout = pVariant->Layout,
+		.NormRefresh = pVariant->NormRefresh,
+		.Fused = pVariant->Fused,
+		.Partial = pVariant->Partial,
+		.UpdateTaps = (pVariant->Partial == AF_PARTIAL_NONE || taps < BENCH_PARTIAL_DIVISOR)
+		              ? 0 : taps / BENCH_PARTIAL_DIVISOR,
+		.ErrorBound = pVariant->ErrorBound,
+		.Frozen = pVariant->Frozen
+	};
+
+	return config;
+}
+/* End of VariantConfig()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* RunBatch
+*
+* @param[in,out] pData   filter to run
+* @param[in]     mode    call pattern
+* @param[in]     samples number of samples, a multiple of BENCH_BLOCK
+*
+* @returns       elapsed nanoseconds
+*
+* @note          Cycles through the benchmark signals. The error-in pattern
+*  feeds back the error against the previous output, as a caller measuring
+*  the error acoustically would.
+*
+* @warning       none
+*******************************************************************************/
+static double RunBatch(AfData *pData, BenchMode mode, size_t samples) {
+	static double output[BENCH_BLOCK];
+	static unsigned int position;
+	static double previous;
+	double start = NowNs();
+	size_t i;
+
+	for ( i = 0; i < samples; i += BENCH_BLOCK ) {
+		if (mode == BENCH_RUN_BLOCK) {
+			AdaptiveFilterRunBlock(input + position, desired + position, output,
+			                       NULL, BENCH_BLOCK, pData);
+		}
+		else if (mode == BENCH_ERROR_IN) {
+			unsigned int k;
+
+			for ( k = 0; k < BENCH_BLOCK; k++ ) {
+				previous = AdaptiveFilterRunErrorIn(input[position + k],
+				                                    desired[position + k] - previous, pData);
+			}
+		}
+		else {
+			unsigned int k;
+
+			for ( k = 0; k < BENCH_BLOCK; k++ ) {
+				AdaptiveFilterRun(input[position + k], desired[position + k], pData);
+			}
+		}
+		position = (position + BENCH_BLOCK) % BENCH_SIGNAL;
+	}
+
+	return NowNs() - start;
+}
+/* End of RunBatch()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* TimeCase
+*
+* @param[in,out] pData   filter to run
+* @param[in]     mode    call pattern
+* @param[in]     repeats number of timed repeats
+* @param[out]    pTimes  repeats ns/sample values (scratch)
+* @param[out]    pResult Mode, Taps and the statistics
+*
+* @returns       none
+*
+* @note          Runs blocks untimed for BENCH_WARMUP_NS, which also
+*  estimates the cost per sample, then sizes each repeat to about
+*  BENCH_REPEAT_NS. Percentiles are nearest-rank.
+*
+* @warning       none
+*******************************************************************************/
+static void TimeCase(AfData *pData, BenchMode mode, unsigned int repeats,
+                     double *pTimes, BenchResult *pResult) {
+	double elapsed = 0.0, perSample, median;
+	size_t warmup = 0, samples;
+	unsigned int r, rank;
+
+	while (elapsed < BENCH_WARMUP_NS) {
+		elapsed += RunBatch(pData, mode, BENCH_BLOCK);
+		warmup += BENCH_BLOCK;
+	}
+	perSample = elapsed / (double)warmup;
+	samples = (size_t)(BENCH_REPEAT_NS / perSample / BENCH_BLOCK + 1) * BENCH_BLOCK;
+
+	for ( r = 0; r < repeats; r++ ) {
+		pTimes[r] = RunBatch(pData, mode, samples) / (double)samples;
+	}
+	qsort(pTimes, repeats, sizeof(double), CompareDouble);
+
+	median = pTimes[(repeats - 1) / 2];
+	rank = (99 * repeats + 99) / 100; /* ceil(0.99 * repeats) */
+	pResult->Mode = modeNames[mode];
+	pResult->Taps = pData->Length;
+	pResult->MedianNs = median;
+	pResult->P99Ns = pTimes[rank - 1];
+	pResult->SamplesPerSec = 1.0E9 / median;
+	pResult->Gflops = BENCH_FLOPS_PER_TAP * pData->Length / median;
+	pResult->Channels = pResult->SamplesPerSec / BENCH_SAMPLE_RATE;
+}
+/* End of TimeCase()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* CompareDouble
+*
+* @param[in]     pA first double
+* @param[in]     pB second double
+*
+* @returns       qsort() order, ascending
+*
+* @note          none
+*
+* @warning       none
+*******************************************************************************/
+static int CompareDouble(const void *pA, const void *pB) {
+	const double a = *(const double *)pA, b = *(const double *)pB;
+
+	return (a > b) - (a < b);
+}
+/* End of CompareDouble()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* WriteCsv
+*
+* @param[in]     pPath    output file
+* @param[in]     pResults count results
+* @param[in]     count    number of results
+*
+* @returns       0 on success, -1 if the file cannot be written
+*
+* @note          Header row, then one row per case, as printed to stdout.
+*
+* @warning       none
+*******************************************************************************/
+static int WriteCsv(const char *pPath, const BenchResult *pResults, unsigned int count) {
+	FILE *pFile = fopen(pPath, "w");
+	unsigned int k;
+
+	if (!pFile) {
+		return -1;
+	}
+	fprintf(pFile, "isa,mode,variant,taps,median_ns,p99_ns,samples_per_s,gflops,channels_48k\n");
+	for ( k = 0; k < count; k++ ) {
+		fprintf(pFile, "%s,%s,%s,%u,%.3f,%.3f,%.0f,%.4f,%.2f\n", pResults[k].Isa,
+		        pResults[k].Mode, pResults[k].Variant, pResults[k].Taps, pResults[k].MedianNs,
+		        pResults[k].P99Ns, pResults[k].SamplesPerSec, pResults[k].Gflops,
+		        pResults[k].Channels);
+	}
+
+	return (fclose(pFile) == 0) ? 0 : -1;
+}
+/* End of WriteCsv()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* WriteJson
+*
+* @param[in]     pPath    output file
+* @param[in]     pResults count results
+* @param[in]     count    number of results
+*
+* @returns       0 on success, -1 if the file cannot be written
+*
+* @note          An array of objects with the CSV column names as keys.
+*
+* @warning       none
+*******************************************************************************/
+static int WriteJson(const char *pPath, const BenchResult *pResults, unsigned int count) {
+	FILE *pFile = fopen(pPath, "w");
+	unsigned int k;
+
+	if (!pFile) {
+		return -1;
+	}
+	fprintf(pFile, "[\n");
+	for ( k = 0; k < count; k++ ) {
+		fprintf(pFile, "  {\"isa\": \"%s\", \"mode\": \"%s\", \"variant\": \"%s\", "
+		        "\"taps\": %u, \"median_ns\": %.3f, \"p99_ns\": %.3f, \"samples_per_s\": %.0f, "
+		        "\"gflops\": %.4f, \"channels_48k\": %.2f}%s\n", pResults[k].Isa,
+		        pResults[k].Mode, pResults[k].Variant, pResults[k].Taps, pResults[k].MedianNs,
+		        pResults[k].P99Ns, pResults[k].SamplesPerSec, pResults[k].Gflops,
+		        pResults[k].Channels, (k + 1 < count) ? "," : "");
+	}
+	fprintf(pFile, "]\n");
+
+	return (fclose(pFile) == 0) ? 0 : -1;
+}
+/* End of WriteJson()*/
+/******************************************************************************/
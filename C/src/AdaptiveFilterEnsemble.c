@@ -0,0 +1,508 @@
+/*
+ * @file AdaptiveFilterEnsemble.c
+ *
+ * Monte-Carlo ensemble of system-identification scenarios:
+ *   1. Runs R independent trials, trial r with seed Seed + r, on a set of
+ *      worker threads, each keeping its learning curves (squared error and
+ *      misalignment every Decimation samples) in its own rows
+ *   2. Reduces every curve point over the trials, again across the
+ *      workers: the mean of the linear values and the AF_ENSEMBLE_BAND_LOW,
+ *      median and AF_ENSEMBLE_BAND_HIGH percentiles, all in dB
+ *   3. Writes the bands to a CSV or binary file and reports pass/fail over
+ *      the trials
+ *
+ * Every sum runs over the trials in order and the percentiles come from a
+ * sorted copy, so the bands are bit-identical for any thread count.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+/******************************************************************************/
+/* include block */
+#include "AdaptiveFilterEnsemble.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/******************************************************************************/
+/** local definitions **/
+#define ENSEMBLE_METRICS (2) /* squared error and misalignment */
+
+/* Shared by the workers of one AfEnsembleRun() phase */
+typedef struct {
+	AfEnsemble *pEnsemble;
+	void *(*pPhase)(void *pArg); /* TrialWorker or ReduceWorker */
+	atomic_uint Next; /* next trial or curve point */
+} EnsembleQueue;
+
+static const char *const columnNames[AF_ENSEMBLE_COLUMNS] = {
+	"squared_error_db_mean", "squared_error_db_low", "squared_error_db_median",
+	"squared_error_db_high", "misalignment_db_mean", "misalignment_db_low",
+	"misalignment_db_median", "misalignment_db_high"
+};
+
+static void RunPhase(EnsembleQueue *pQueue, unsigned int threads);
+static void *TrialWorker(void *pArg);
+static void *ReduceWorker(void *pArg);
+static void RunTrial(AfEnsemble *pEnsemble, unsigned int trial);
+static void ReducePoint(AfEnsemble *pEnsemble, unsigned int point, double *pSorted);
+static double Percentile(const double *pSorted, unsigned int count, double percentile);
+static int CompareDouble(const void *pA, const void *pB);
+
+/******************************************************************************
+ * AfEnsembleInit
+ *
+ * @param[out]    pEnsemble  ensemble to set up
+ * @param[in]     pParams    scenario parameters for every trial; trial r
+ *  uses seed pParams->Seed + r
+ * @param[in]     trials     number of trials, at least 1
+ * @param[in]     decimation a curve point every decimation samples, 0 or 1:
+ *  every sample
+ *
+ * @returns       0 on success, -1 if a parameter is out of range or the
+ *  curves cannot be allocated
+ *
+ * @note          Allocates Trials * Points * 2 doubles for the curves, so
+ *  long runs with many trials want a decimation.
+ *
+ * @warning       Release with AfEnsembleDestroy()
+ */
+int AfEnsembleInit(AfEnsemble *pEnsemble, const AfScenarioParams *pParams,
+                   unsigned int trials, unsigned int decimation) {
+	memset(pEnsemble, 0, sizeof(*pEnsemble));
+	if (decimation < 1) {
+		decimation = 1;
+	}
+	if (trials == 0 || pParams->Iterations < decimation) {
+		return -1;
+	}
+
+	pEnsemble->Params = *pParams;
+	pEnsemble->Trials = trials;
+	pEnsemble->Decimation = decimation;
+	pEnsemble->Points = pParams->Iterations / decimation;
+	pEnsemble->pCurves = (double *)calloc((size_t)trials * pEnsemble->Points * ENSEMBLE_METRICS,
+	                                      sizeof(double));
+	pEnsemble->pResults = (double *)calloc((size_t)trials * AF_ENSEMBLE_RESULTS, sizeof(double));
+	pEnsemble->pBands = (double *)calloc((size_t)pEnsemble->Points * AF_ENSEMBLE_COLUMNS,
+	                                     sizeof(double));
+	if (!pEnsemble->pCurves || !pEnsemble->pResults || !pEnsemble->pBands) {
+		AfEnsembleDestroy(pEnsemble);
+		return -1;
+	}
+
+	return 0;
+}
+/* End of AfEnsembleInit() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfEnsembleRun
+ *
+ * @param[in,out] pEnsemble ensemble set up by AfEnsembleInit()
+ * @param[in]     threads   worker threads, 0: one per online CPU, capped at
+ *  AF_ENSEMBLE_MAX_THREADS
+ *
+ * @returns       none
+ *
+ * @note          Runs all trials, then reduces the curves into pBands and
+ *  counts Passed and Converged. Sets Failed if a trial could not be set
+ *  up; its rows stay zero.
+ *
+ * @warning       none
+ */
+void AfEnsembleRun(AfEnsemble *pEnsemble, unsigned int threads) {
+	EnsembleQueue queue;
+	unsigned int r;
+	long online;
+
+	if (threads == 0) {
+		online = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = (online > 0) ? (unsigned int)online : 1;
+	}
+	if (threads > AF_ENSEMBLE_MAX_THREADS) {
+		threads = AF_ENSEMBLE_MAX_THREADS;
+	}
+
+	queue.pEnsemble = pEnsemble;
+	queue.pPhase = TrialWorker;
+	RunPhase(&queue, (threads < pEnsemble->Trials) ? threads : pEnsemble->Trials);
+	queue.pPhase = ReduceWorker;
+	RunPhase(&queue, (threads < pEnsemble->Points) ? threads : pEnsemble->Points);
+
+	pEnsemble->Passed = pEnsemble->Converged = 0;
+	pEnsemble->Failed = 0;
+	for ( r = 0; r < pEnsemble->Trials; r++ ) {
+		const double *pResult = pEnsemble->pResults + (size_t)r * AF_ENSEMBLE_RESULTS;
+
+		if (pResult[2] < 0) {
+			pEnsemble->Failed = 1;
+		}
+		else if (pResult[0] <= pEnsemble->Params.MisalignmentThresh &&
+		    pResult[1] <= pEnsemble->Params.SquaredErrorThresh) {
+			pEnsemble->Passed++;
+		}
+		if (pResult[2] > 0) {
+			pEnsemble->Converged++;
+		}
+	}
+}
+/* End of AfEnsembleRun() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfEnsembleWrite
+ *
+ * @param[in]     pEnsemble ensemble after AfEnsembleRun()
+ * @param[in]     pPath     output file
+ * @param[in]     format    AF_METRICS_CSV, or AF_METRICS_BINARY for records
+ *  of 1 + AF_ENSEMBLE_COLUMNS native doubles
+ *
+ * @returns       0 on success, -1 if the file cannot be written
+ *
+ * @note          One record per curve point: the sample number, then the
+ *  mean, low band, median and high band of the squared error and of the
+ *  misalignment, in dB.
+ *
+ * @warning       none
+ */
+int AfEnsembleWrite(const AfEnsemble *pEnsemble, const char *pPath,
+                    AfMetricsFormat format) {
+	FILE *pFile = fopen(pPath, (format == AF_METRICS_BINARY) ? "wb" : "w");
+	const double *pBand;
+	double record[1 + AF_ENSEMBLE_COLUMNS];
+	unsigned int p, c;
+	int failed = 0;
+
+	if (!pFile) {
+		return -1;
+	}
+	if (format == AF_METRICS_CSV) {
+		fprintf(pFile, "sample");
+		for ( c = 0; c < AF_ENSEMBLE_COLUMNS; c++ ) {
+			fprintf(pFile, ",%s", columnNames[c]);
+		}
+		fprintf(pFile, "\n");
+	}
+	for ( p = 0; p < pEnsemble->Points && !failed; p++ ) {
+		pBand = pEnsemble->pBands + (size_t)p * AF_ENSEMBLE_COLUMNS;
+		if (format == AF_METRICS_BINARY) {
+			record[0] = (double)(p + 1) * pEnsemble->Decimation;
+			memcpy(record + 1, pBand, sizeof(double) * AF_ENSEMBLE_COLUMNS);
+			failed = fwrite(record, sizeof(record), 1, pFile) != 1;
+		}
+		else {
+			fprintf(pFile, "%u", (p + 1) * pEnsemble->Decimation);
+			for ( c = 0; c < AF_ENSEMBLE_COLUMNS; c++ ) {
+				fprintf(pFile, ",%f", pBand[c]);
+			}
+			failed = fprintf(pFile, "\n") < 0;
+		}
+	}
+
+	return (fclose(pFile) != 0 || failed) ? -1 : 0;
+}
+/* End of AfEnsembleWrite() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfEnsembleReport
+ *
+ * @param[in]     pEnsemble ensemble after AfEnsembleRun()
+ *
+ * @returns       none
+ *
+ * @note          Prints the final misalignment bands and the median samples
+ *  to ConvergenceThresh over the trials that got there, then a PASS line if
+ *  every trial met the thresholds.
+ *
+ * @warning       none
+ */
+void AfEnsembleReport(const AfEnsemble *pEnsemble) {
+	const AfScenarioParams *pParams = &pEnsemble->Params;
+	const unsigned int trials = pEnsemble->Trials;
+	double *pSorted = (double *)malloc(trials * sizeof(double));
+	double misalignment[3] = { 0 }, converged = 0;
+	unsigned int r, count = 0;
+
+	if (pSorted) {
+		for ( r = 0; r < trials; r++ ) {
+			pSorted[r] = pEnsemble->pResults[(size_t)r * AF_ENSEMBLE_RESULTS];
+		}
+		qsort(pSorted, trials, sizeof(double), CompareDouble);
+		misalignment[0] = Percentile(pSorted, trials, AF_ENSEMBLE_BAND_LOW);
+		misalignment[1] = Percentile(pSorted, trials, 50.0);
+		misalignment[2] = Percentile(pSorted, trials, AF_ENSEMBLE_BAND_HIGH);
+
+		for ( r = 0; r < trials; r++ ) {
+			if (pEnsemble->pResults[(size_t)r * AF_ENSEMBLE_RESULTS + 2] > 0) {
+				pSorted[count++] = pEnsemble->pResults[(size_t)r * AF_ENSEMBLE_RESULTS + 2];
+			}
+		}
+		qsort(pSorted, count, sizeof(double), CompareDouble);
+		converged = count ? Percentile(pSorted, count, 50.0) : 0;
+		free(pSorted);
+	}
+
+	printf("Ensemble of %u trials (taps %u, step %g, reg %g, iterations %u, seeds %u-%u): "
+	       "final misalignment p%g %.1fdB, median %.1fdB, p%g %.1fdB; "
+	       "samples to %gdB median %.0f (%u converged)\n",
+	       trials, pParams->Taps, pParams->StepSize, pParams->Regularization,
+	       pParams->Iterations, pParams->Seed, pParams->Seed + trials - 1,
+	       AF_ENSEMBLE_BAND_LOW, misalignment[0], misalignment[1],
+	       AF_ENSEMBLE_BAND_HIGH, misalignment[2],
+	       pParams->ConvergenceThresh, converged, pEnsemble->Converged);
+	printf("%s: Ensemble %u of %u trials Misalignment < %g and Squared Error < %g\n",
+	       (pEnsemble->Passed == trials && !pEnsemble->Failed) ? "PASS" : "FAIL",
+	       pEnsemble->Passed, trials, pParams->MisalignmentThresh, pParams->SquaredErrorThresh);
+}
+/* End of AfEnsembleReport() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfEnsembleDestroy
+ *
+ * @param[in,out] pEnsemble ensemble set up by AfEnsembleInit()
+ *
+ * @returns       none
+ *
+ * @note          none
+ *
+ * @warning       none
+ */
+void AfEnsembleDestroy(AfEnsemble *pEnsemble) {
+	free(pEnsemble->pCurves);
+	free(pEnsemble->pResults);
+	free(pEnsemble->pBands);
+	pEnsemble->pCurves = pEnsemble->pResults = pEnsemble->pBands = NULL;
+}
+/* End of AfEnsembleDestroy() */
+/******************************************************************************/
+
+/** internal functions **/
+
+/***************************************************************************//**
+* RunPhase
+*
+* @param[in,out] pQueue  queue naming the phase's worker
+* @param[in]     threads threads to run it on, the caller included
+*
+* @returns       none
+*
+* @note          If threads cannot be started the caller does their share.
+*
+* @warning       none
+*******************************************************************************/
+static void RunPhase(EnsembleQueue *pQueue, unsigned int threads) {
+	pthread_t workers[AF_ENSEMBLE_MAX_THREADS];
+	unsigned int t, started = 0;
+
+	atomic_init(&pQueue->Next, 0);
+	for ( t = 1; t < threads; t++ ) {
+		if (pthread_create(&workers[started], NULL, pQueue->pPhase, pQueue) == 0) {
+			started++;
+		}
+	}
+	pQueue->pPhase(pQueue);
+	for ( t = 0; t < started; t++ ) {
+		pthread_join(workers[t], NULL);
+	}
+}
+/* End of RunPhase()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* TrialWorker
+*
+* @param[in,out] pArg EnsembleQueue shared by the workers
+*
+* @returns       NULL
+*
+* @note          Runs trials until none are left.
+*
+* @warning       none
+*******************************************************************************/
+static void *TrialWorker(void *pArg) {
+	EnsembleQueue *pQueue = (EnsembleQueue *)pArg;
+	unsigned int trial;
+
+	while ((trial = atomic_fetch_add(&pQueue->Next, 1)) < pQueue->pEnsemble->Trials) {
+		RunTrial(pQueue->pEnsemble, trial);
+	}
+
+	return NULL;
+}
+/* End of TrialWorker()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* ReduceWorker
+*
+* @param[in,out] pArg EnsembleQueue shared by the workers
+*
+* @returns       NULL
+*
+* @note          Reduces curve points until none are left, sorting in a
+*  buffer of its own.
+*
+* @warning       none
+*******************************************************************************/
+static void *ReduceWorker(void *pArg) {
+	EnsembleQueue *pQueue = (EnsembleQueue *)pArg;
+	AfEnsemble *pEnsemble = pQueue->pEnsemble;
+	double *pSorted = (double *)malloc(pEnsemble->Trials * sizeof(double));
+	unsigned int point;
+
+	if (!pSorted) {
+		return NULL; /* the other workers, or the caller, take the points */
+	}
+	while ((point = atomic_fetch_add(&pQueue->Next, 1)) < pEnsemble->Points) {
+		ReducePoint(pEnsemble, point, pSorted);
+	}
+	free(pSorted);
+
+	return NULL;
+}
+/* End of ReduceWorker()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* RunTrial
+*
+* @param[in,out] pEnsemble ensemble
+* @param[in]     trial     trial number, from 0
+*
+* @returns       none
+*
+* @note          Runs a scenario with seed Seed + trial and stores every
+*  Decimation-th sample's linear metrics and the final results in the
+*  trial's own rows. A trial that cannot be set up stores -1 samples to
+*  convergence.
+*
+* @warning       none
+*******************************************************************************/
+static void RunTrial(AfEnsemble *pEnsemble, unsigned int trial) {
+	double *pCurve = pEnsemble->pCurves + (size_t)trial * pEnsemble->Points * ENSEMBLE_METRICS;
+	double *pResult = pEnsemble->pResults + (size_t)trial * AF_ENSEMBLE_RESULTS;
+	AfScenarioParams params = pEnsemble->Params;
+	unsigned int i;
+	AfScenario scenario;
+	double desired;
+
+	params.Seed += trial;
+	if (AfScenarioInit(&scenario, &params) != 0) {
+		pResult[2] = -1; /* counted as Failed once the workers are done */
+		return;
+	}
+	scenario.Decimation = pEnsemble->Decimation;
+	for ( i = 0; i < params.Iterations; i++ ) {
+		AfScenarioStep(&scenario, &desired);
+		if (scenario.Kept) {
+			*pCurve++ = scenario.SquaredError;
+			*pCurve++ = scenario.Misalignment;
+		}
+	}
+	AfScenarioEnd(&scenario);
+
+	pResult[0] = scenario.MisalignmentDb;
+	pResult[1] = scenario.SquaredErrorDb;
+	pResult[2] = scenario.Converged;
+	AfScenarioDestroy(&scenario);
+}
+/* End of RunTrial()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* ReducePoint
+*
+* @param[in,out] pEnsemble ensemble
+* @param[in]     point     curve point to reduce
+* @param[in]     pSorted   scratch of Trials doubles
+*
+* @returns       none
+*
+* @note          The mean is taken over the linear values in trial order.
+*  The percentiles are picked from the sorted linear values, then converted
+*  to dB, which keeps their order.
+*
+* @warning       none
+*******************************************************************************/
+static void ReducePoint(AfEnsemble *pEnsemble, unsigned int point, double *pSorted) {
+	const size_t stride = (size_t)pEnsemble->Points * ENSEMBLE_METRICS;
+	const double *pCurves = pEnsemble->pCurves + (size_t)point * ENSEMBLE_METRICS;
+	double *pBand = pEnsemble->pBands + (size_t)point * AF_ENSEMBLE_COLUMNS;
+	unsigned int r, m;
+	double sum;
+
+	for ( m = 0; m < ENSEMBLE_METRICS; m++ ) {
+		sum = 0.0;
+		for ( r = 0; r < pEnsemble->Trials; r++ ) {
+			pSorted[r] = pCurves[r * stride + m];
+			sum += pSorted[r];
+		}
+		qsort(pSorted, pEnsemble->Trials, sizeof(double), CompareDouble);
+
+		pBand[m * AF_ENSEMBLE_STATS + 0] = sum / pEnsemble->Trials;
+		pBand[m * AF_ENSEMBLE_STATS + 1] = Percentile(pSorted, pEnsemble->Trials, AF_ENSEMBLE_BAND_LOW);
+		pBand[m * AF_ENSEMBLE_STATS + 2] = Percentile(pSorted, pEnsemble->Trials, 50.0);
+		pBand[m * AF_ENSEMBLE_STATS + 3] = Percentile(pSorted, pEnsemble->Trials, AF_ENSEMBLE_BAND_HIGH);
+		for ( r = 0; r < AF_ENSEMBLE_STATS; r++ ) {
+			pBand[m * AF_ENSEMBLE_STATS + r] =
+				10 * log10( AF_METRICS_DB_EPSILON + pBand[m * AF_ENSEMBLE_STATS + r] );
+		}
+	}
+}
+/* End of ReducePoint()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Percentile
+*
+* @param[in]     pSorted    values in ascending order
+* @param[in]     count      number of values, at least 1
+* @param[in]     percentile 0 to 100
+*
+* @returns       nearest-rank percentile
+*
+* @note          none
+*
+* @warning       none
+*******************************************************************************/
+static double Percentile(const double *pSorted, unsigned int count, double percentile) {
+	double rank = ceil(percentile / 100.0 * count);
+
+	if (rank < 1) {
+		rank = 1;
+	}
+	if (rank > count) {
+		rank = count;
+	}
+
+	return pSorted[(unsigned int)rank - 1];
+}
+/* End of Percentile()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* CompareDouble
+*
+* @param[in]     pA first double
+* @param[in]     pB second double
+*
+* @returns       qsort() ordering of *pA and *pB
+*
+* @note          none
+*
+* @warning       none
+*******************************************************************************/
+static int CompareDouble(const void *pA, const void *pB) {
+	const double a = *(const double *)pA, b = *(const double *)pB;
+
+	return (a > b) - (a < b);
+}
+/* End of CompareDouble()*/
+/******************************************************************************/
@@ -0,0 +1,60 @@
+/*
+ * @file AdaptiveFilterEnsemble.h
+ *
+ * Header file for AdaptiveFilterEnsemble.c, a Monte-Carlo runner that
+ * repeats the system-identification scenario over many seeds on all cores
+ * and reduces the learning curves to a mean and percentile bands.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+#ifndef ADAPTIVEFILTERENSEMBLE_H_
+#define ADAPTIVEFILTERENSEMBLE_H_
+
+#include "AdaptiveFilterScenario.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AF_ENSEMBLE_BAND_LOW (5.0) /* percentile of the lower band */
+#define AF_ENSEMBLE_BAND_HIGH (95.0) /* percentile of the upper band */
+#define AF_ENSEMBLE_STATS (4) /* per metric: mean, low band, median, high band */
+#define AF_ENSEMBLE_COLUMNS (2 * AF_ENSEMBLE_STATS) /* squared error, misalignment */
+#define AF_ENSEMBLE_RESULTS (3) /* per trial: misalignment, squared error,
+                                 * samples to convergence */
+#define AF_ENSEMBLE_MAX_THREADS (256) /* most threads AfEnsembleRun() starts */
+
+/* Contains ensemble parameters, per-trial curves and the reduced bands.
+ * Trial r runs the scenario with seed Params.Seed + r. Each trial writes
+ * only its own rows and each curve point is reduced over the trials in
+ * order, so the results are the same for any thread count.
+ */
+typedef struct {
+	AfScenarioParams Params; /* parameters shared by the trials */
+	unsigned int Trials;
+	unsigned int Decimation; /* a curve point every Decimation samples */
+	unsigned int Points; /* Params.Iterations / Decimation */
+	double *pCurves; /* Trials x Points x 2 linear squared error and
+	                  * misalignment, trial-major */
+	double *pResults; /* Trials x 3: final misalignment and squared error
+	                   * in dB, samples to ConvergenceThresh (0: never) */
+	double *pBands; /* Points x AF_ENSEMBLE_COLUMNS, in dB */
+	unsigned int Passed; /* trials meeting both thresholds */
+	unsigned int Converged; /* trials reaching ConvergenceThresh */
+	int Failed; /* a trial could not be set up */
+} AfEnsemble;
+
+int AfEnsembleInit(AfEnsemble *pEnsemble, const AfScenarioParams *pParams,
+                   unsigned int trials, unsigned int decimation);
+void AfEnsembleRun(AfEnsemble *pEnsemble, unsigned int threads);
+int AfEnsembleWrite(const AfEnsemble *pEnsemble, const char *pPath,
+                    AfMetricsFormat format);
+void AfEnsembleReport(const AfEnsemble *pEnsemble);
+void AfEnsembleDestroy(AfEnsemble *pEnsemble);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ADAPTIVEFILTERENSEMBLE_H_ */
@@ -0,0 +1,473 @@
+/*
+ * @file AdaptiveFilterF.c
+ *  
+ * Single precision build of the normalized least-mean-square adaptive filter
+ * in AdaptiveFilter.c. The algorithm, delay line layouts, running norm and
+ * fused mode are identical; state and kernels use float, which halves the
+ * memory footprint and doubles the SIMD lane count.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+/******************************************************************************/
+/* include block */
+#include "AdaptiveFilterF.h"
+#include <math.h>
+
+/******************************************************************************/
+/** local definitions **/
+static void AdaptWeights(AfDataF *pData);
+static float Filter(float input, AfDataF *pData);
+static float PushInput(float input, AfDataF *pData);
+static unsigned int Window(const AfDataF *pData, float **ppSeg0, float **ppSeg1);
+static float WindowNorm(const AfDataF *pData);
+static void UpdateNorm(float newest, float oldest, AfDataF *pData);
+static float InputNorm(const AfDataF *pData);
+static void BindKernels(AfDataF *pData);
+static float FilterFused(float oldest, AfDataF *pData);
+
+/******************************************************************************
+ * AdaptiveFilterRunF
+ *
+ * @param[in]     input  input signal sample
+ * @param[in]     desired desired signal sample
+ * @param[in,out] pData  pointer to AdaptiveFilter parameter/state struct
+ *
+ * @returns       adaptive filter output (estimate of desired signal)
+ *
+ * @note          Runs the normalized least mean square adaptive filter and
+ *  computes a new output.
+ *
+ * @warning       none
+ */
+float AdaptiveFilterRunF(float input, float desired, AfDataF *pData) {
+	float output;
+
+	BindKernels(pData); /* select SIMD kernels on first use */
+
+	output = Filter(input, pData); /* filter the input */
+	pData->Error = desired - output; /* update the error */
+	AdaptWeights(pData); /* update adaptive filter weights */
+
+	return output;
+}
+/* End of AdaptiveFilterRunF() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterRunErrorInF
+ *
+ * @param[in]     input  input signal sample
+ * @param[in]     error error signal sample (desired - output)
+ * @param[in,out] pData  pointer to AdaptiveFilter parameter/state struct
+ *
+ * @returns       adaptive filter output (estimate of desired signal)
+ *
+ * @note          Runs the normalized least mean square adaptive filter and
+ *  computes a new output.
+ *
+ * @warning       none
+ */
+float AdaptiveFilterRunErrorInF(float input, float error, AfDataF *pData) {
+	float output;
+
+	BindKernels(pData); /* select SIMD kernels on first use */
+
+	pData->Error = error; /* update the error */
+	AdaptWeights(pData); /* update adaptive filter weights */
+	output = Filter(input, pData); /* filter the input */
+
+	return output;
+}
+/* End of AdaptiveFilterRunErrorInF() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterRunBlockF
+ *
+ * @param[in]     input   block of n input signal samples
+ * @param[in]     desired block of n desired signal samples
+ * @param[out]    output  block of n adaptive filter outputs (may be NULL)
+ * @param[out]    error   block of n errors, desired - output (may be NULL)
+ * @param[in]     n       number of samples in the block
+ * @param[in,out] pData   pointer to AdaptiveFilter parameter/state struct
+ *
+ * @returns       none
+ *
+ * @note          Runs the normalized least mean square adaptive filter over
+ *  a whole block of samples. State is carried across calls, so splitting a
+ *  signal into blocks of any size gives exactly the same outputs, errors and
+ *  weights as calling AdaptiveFilterRunF() once per sample.
+ *
+ * @warning       input and desired must not alias output or error
+ */
+void AdaptiveFilterRunBlockF(const float *input, const float *desired,
+                             float *output, float *error, size_t n,
+                             AfDataF *pData) {
+	float y;
+	size_t i;
+
+	BindKernels(pData); /* select SIMD kernels on first use */
+
+	for ( i = 0; i < n; i++ ) {
+		y = Filter(input[i], pData); /* filter the input */
+		pData->Error = desired[i] - y; /* update the error */
+		AdaptWeights(pData); /* update adaptive filter weights */
+
+		if (output) {
+			output[i] = y;
+		}
+		if (error) {
+			error[i] = pData->Error;
+		}
+	}
+}
+/* End of AdaptiveFilterRunBlockF() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterFlushF
+ *
+ * @param[in,out] pData  pointer to AdaptiveFilter parameter/state struct
+ *
+ * @returns       none
+ *
+ * @note          In fused mode each call leaves its weight update pending
+ *  until the next sample's sweep, so pData->pWeights lags by one update.
+ *  This applies the pending update so the weights can be read or copied.
+ *  Outputs are unaffected; filtering may continue afterwards.
+ *
+ * @warning       none
+ */
+void AdaptiveFilterFlushF(AfDataF *pData) {
+	float *pSeg0, *pSeg1;
+	unsigned int n0;
+
+	BindKernels(pData); /* select SIMD kernels on first use */
+
+	if (pData->PendingStep != 0.0f) {
+		n0 = Window(pData, &pSeg0, &pSeg1);
+		pData->pKernels->ScaledAddF(pData->pWeights, pData->PendingStep, pSeg0, n0);
+		pData->pKernels->ScaledAddF(pData->pWeights + n0, pData->PendingStep, pSeg1, pData->Length - n0);
+		pData->PendingStep = 0.0f;
+	}
+}
+/* End of AdaptiveFilterFlushF() */
+/******************************************************************************/
+
+/** internal functions **/
+
+/***************************************************************************//**
+* AdaptWeights
+* 
+* @param[in,out]     pData pointer to AdaptiveFilter parameter/state struct
+*
+* @returns       none
+* 
+* @note          Updates the filter weights in pData->pWeights using the
+*  canonical normalized least mean square algorithm. In fused mode the
+*  update is only recorded in pData->PendingStep and the next Filter() sweep
+*  applies it.
+* 
+* @warning       none
+*******************************************************************************/
+static void AdaptWeights(AfDataF *pData) {
+	float sn, normStepSize;
+	float *pSeg0, *pSeg1;
+	unsigned int n0;
+
+	sn = InputNorm(pData); /* compute norm term */
+	normStepSize = (pData->StepSize)/(pData->Regularization + sn); /* normalize step size */
+
+	if (pData->Fused) {
+		pData->PendingStep = normStepSize * (pData->Error); /* deferred update */
+		return;
+	}
+
+	n0 = Window(pData, &pSeg0, &pSeg1); /* newest-first input vector */
+
+	/* Normalized Least Mean Square update equation */
+	pData->pKernels->ScaledAddF(pData->pWeights, normStepSize * (pData->Error), pSeg0, n0);
+	pData->pKernels->ScaledAddF(pData->pWeights + n0, normStepSize * (pData->Error), pSeg1, pData->Length - n0);
+}
+/* End of AdaptWeights()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Filter
+* 
+* @param[in]     input input signal sample
+* @param[in,out]     pData pointer to AdaptiveFilter parameter/state struct
+*
+* @returns       new filter output
+* 
+* @note          Computes a new output sample using the input and current
+*  filter weights.
+*
+* 
+* @warning       none
+*******************************************************************************/
+static float Filter(float input, AfDataF *pData) {
+	float output, oldest;
+	float *pSeg0, *pSeg1;
+	unsigned int n0;
+
+	oldest = PushInput(input, pData); /* overwrite oldest input with new input */
+	UpdateNorm(input, oldest, pData); /* keep running norm in step */
+
+	if (pData->Fused) {
+		return FilterFused(oldest, pData); /* apply pending update while filtering */
+	}
+
+	n0 = Window(pData, &pSeg0, &pSeg1); /* newest-first input vector */
+
+	/* compute inner product of weight vector and buffer */
+	output = pData->pKernels->DotF(pData->pWeights, pSeg0, n0);
+	output += pData->pKernels->DotF(pData->pWeights + n0, pSeg1, pData->Length - n0);
+
+	return output;
+}
+/* End of Filter()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* PushInput
+* 
+* @param[in]     input input signal sample
+* @param[in,out]     pData pointer to AdaptiveFilter parameter/state struct
+*
+* @returns       the oldest input sample, which input replaces
+* 
+* @note          Moves pData->BufferIdx back one slot and writes the new input
+*  there, so BufferIdx always indexes the newest sample and older samples
+*  follow it at increasing addresses. The mirrored layout also writes the
+*  copy Length slots further on.
+* 
+* @warning       none
+*******************************************************************************/
+static float PushInput(float input, AfDataF *pData) {
+	float oldest;
+	unsigned int idx = pData->BufferIdx;
+
+	/* wrap index */
+	if (idx == 0 || idx > pData->Length) {
+		idx = pData->Length;
+	}
+	idx--;
+
+	oldest = pData->pBuffer[idx];
+	pData->pBuffer[idx] = input;
+	if (pData->Layout == AF_DELAY_MIRRORED) {
+		pData->pBuffer[idx + pData->Length] = input;
+	}
+	pData->BufferIdx = idx;
+
+	return oldest;
+}
+/* End of PushInput()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Window
+* 
+* @param[in]     pData pointer to AdaptiveFilter parameter/state struct
+* @param[out]    ppSeg0 first contiguous slice of the input vector
+* @param[out]    ppSeg1 second contiguous slice of the input vector
+*
+* @returns       number of samples in the first slice
+* 
+* @note          Describes the current input vector, newest sample first, as
+*  at most two contiguous slices so that weight i pairs with element i. The
+*  mirrored layout always yields a single slice of Length samples; the
+*  circular layout splits where the buffer wraps.
+* 
+* @warning       none
+*******************************************************************************/
+static unsigned int Window(const AfDataF *pData, float **ppSeg0, float **ppSeg1) {
+	unsigned int idx = pData->BufferIdx;
+
+	if (idx >= pData->Length) {
+		idx = 0; /* guard against an out-of-range index */
+	}
+	*ppSeg0 = pData->pBuffer + idx;
+	if (pData->Layout == AF_DELAY_MIRRORED) {
+		*ppSeg1 = pData->pBuffer + idx + pData->Length;
+		return pData->Length;
+	}
+	*ppSeg1 = pData->pBuffer;
+	return pData->Length - idx;
+}
+/* End of Window()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* WindowNorm
+* 
+* @param[in]     pData pointer to AdaptiveFilter parameter/state struct
+*
+* @returns       squared L2-norm of the current input vector
+* 
+* @note          Exact O(Length) recomputation over the delay line window.
+* 
+* @warning       none
+*******************************************************************************/
+static float WindowNorm(const AfDataF *pData) {
+	float *pSeg0, *pSeg1;
+	unsigned int n0;
+
+	n0 = Window(pData, &pSeg0, &pSeg1);
+
+	return pData->pKernels->SquaredNormF(pSeg0, n0) + pData->pKernels->SquaredNormF(pSeg1, pData->Length - n0);
+}
+/* End of WindowNorm()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* UpdateNorm
+* 
+* @param[in]     newest input sample just written to the delay line
+* @param[in]     oldest input sample it replaced
+* @param[in,out] pData pointer to AdaptiveFilter parameter/state struct
+*
+* @returns       none
+* 
+* @note          Maintains the running squared norm when pData->NormRefresh is
+*  nonzero. Each sample adds newest^2 - oldest^2 using Neumaier compensated
+*  summation (the lost low-order bits are carried in EnergyComp), and every
+*  NormRefresh samples the norm is recomputed exactly, discarding any drift.
+*  Between refreshes the drift is bounded by roughly
+*  NormRefresh * 2^-23 * max(input^2), independent of filter length.
+* 
+* @warning       none
+*******************************************************************************/
+static void UpdateNorm(float newest, float oldest, AfDataF *pData) {
+	float delta, sum;
+
+	if (pData->NormRefresh == 0) {
+		return; /* exact norm is recomputed on demand */
+	}
+
+	if (pData->NormCount == 0) {
+		/* bounded exact recompute */
+		pData->Energy = WindowNorm(pData);
+		pData->EnergyComp = 0.0f;
+	}
+	else {
+		/* recursive update: add newest^2, subtract oldest^2 */
+		delta = newest * newest - oldest * oldest;
+		sum = pData->Energy + delta;
+		if (fabsf(pData->Energy) >= fabsf(delta)) {
+			pData->EnergyComp += (pData->Energy - sum) + delta;
+		}
+		else {
+			pData->EnergyComp += (delta - sum) + pData->Energy;
+		}
+		pData->Energy = sum;
+	}
+
+	if (++pData->NormCount >= pData->NormRefresh) {
+		pData->NormCount = 0;
+	}
+}
+/* End of UpdateNorm()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* InputNorm
+* 
+* @param[in]     pData pointer to AdaptiveFilter parameter/state struct
+*
+* @returns       squared L2-norm of the current input vector
+* 
+* @note          Returns the running norm when enabled, otherwise recomputes
+*  it exactly.
+* 
+* @warning       none
+*******************************************************************************/
+static float InputNorm(const AfDataF *pData) {
+	float sn;
+
+	if (pData->NormRefresh == 0) {
+		/* the fused sweep already measured the current window */
+		return pData->Fused ? pData->Energy : WindowNorm(pData);
+	}
+
+	sn = pData->Energy + pData->EnergyComp;
+
+	return (sn > 0.0f) ? sn : 0.0f; /* rounding must never make it negative */
+}
+/* End of InputNorm()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* BindKernels
+* 
+* @param[in,out] pData pointer to AdaptiveFilter parameter/state struct
+*
+* @returns       none
+* 
+* @note          Leaves a caller-chosen kernel table alone, otherwise selects
+*  the best table for the host (see AfKernelsGet()).
+* 
+* @warning       none
+*******************************************************************************/
+static void BindKernels(AfDataF *pData) {
+	if (!pData->pKernels) {
+		pData->pKernels = AfKernelsGet(AF_ISA_AUTO);
+	}
+}
+/* End of BindKernels()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* FilterFused
+* 
+* @param[in]     oldest input sample that the newest input just replaced
+* @param[in,out] pData pointer to AdaptiveFilter parameter/state struct
+*
+* @returns       new filter output
+* 
+* @note          Single pass over the weights that first applies the pending
+*  update from the previous sample, w[i] += PendingStep * xPrev[i], and then
+*  accumulates w[i] * x[i] and x[i]^2. The previous input vector is the
+*  current one shifted by one tap, with the replaced sample in the last tap,
+*  so each weight is loaded and stored once per sample instead of twice.
+*  The arithmetic matches Filter() followed by AdaptWeights() up to the
+*  kernel tolerance.
+* 
+* @warning       none
+*******************************************************************************/
+static float FilterFused(float oldest, AfDataF *pData) {
+	const float step = pData->PendingStep;
+	float *pW = pData->pWeights;
+	float *pSeg0, *pSeg1;
+	float output, energy = 0.0f, prevLast;
+	unsigned int n0, n1;
+
+	n0 = Window(pData, &pSeg0, &pSeg1); /* newest-first input vector */
+	n1 = pData->Length - n0;
+
+	/* first slice; its last tap's previous input is the next slice's first */
+	output = pData->pKernels->UpdateDotF(pW, pSeg0, pSeg0 + 1, step, n0 - 1, &energy);
+	prevLast = (n1 > 0) ? pSeg1[0] : oldest;
+	pW[n0 - 1] += step * prevLast;
+	output += pW[n0 - 1] * pSeg0[n0 - 1];
+	energy += pSeg0[n0 - 1] * pSeg0[n0 - 1];
+
+	/* second slice, present only when the circular buffer wraps */
+	if (n1 > 0) {
+		output += pData->pKernels->UpdateDotF(pW + n0, pSeg1, pSeg1 + 1, step, n1 - 1, &energy);
+		pW[pData->Length - 1] += step * oldest;
+		output += pW[pData->Length - 1] * pSeg1[n1 - 1];
+		energy += pSeg1[n1 - 1] * pSeg1[n1 - 1];
+	}
+
+	pData->PendingStep = 0.0f;
+	if (pData->NormRefresh == 0) {
+		pData->Energy = energy; /* exact norm of the current window */
+	}
+
+	return output;
+}
+/* End of FilterFused()*/
+/******************************************************************************/
@@ -0,0 +1,45 @@
+/*
+ * @file AdaptiveFilterF.h
+ *
+ * Header file for AdaptiveFilterF.c, the single precision counterpart of
+ * AdaptiveFilter.h. AfDataF has the same fields and meaning as AfData with
+ * float samples, weights and state.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+#ifndef ADAPTIVEFILTERF_H_
+#define ADAPTIVEFILTERF_H_
+
+#include "AdaptiveFilter.h"
+
+/* Single precision Adaptive Filter parameter/state struct (see AfData) */
+typedef struct {
+	const float StepSize; /* adaptive filter step size */
+	const float Regularization; /* regularization constant */
+	const unsigned int Length; /* length of filter */
+	float *pBuffer; /* pointer to input buffer (2*Length if mirrored) */
+	unsigned int BufferIdx; /* index of newest sample in input buffer */
+	float *pWeights; /* pointer to adaptive filter weights */
+	float Error; /* output error (desired - output) state */
+	const AfDelayLayout Layout; /* delay line layout of pBuffer */
+	const unsigned int NormRefresh; /* 0: exact input norm every sample,
+	                                 * K: running norm, exact every K samples */
+	float Energy; /* running squared norm of the input vector */
+	float EnergyComp; /* compensation term of the running norm */
+	unsigned int NormCount; /* samples since the last exact norm */
+	const AfKernels *pKernels; /* vector kernels, NULL: best for the host,
+	                            * selected on first use (see AfKernelsGet) */
+	const unsigned int Fused; /* nonzero: single-pass filter-and-adapt with
+	                           * the update deferred one sample */
+	float PendingStep; /* deferred update scale (step * error) */
+} AfDataF;
+
+float AdaptiveFilterRunF(float input, float desired, AfDataF *pData);
+float AdaptiveFilterRunErrorInF(float input, float error, AfDataF *pData);
+void AdaptiveFilterRunBlockF(const float *input, const float *desired,
+                             float *output, float *error, size_t n,
+                             AfDataF *pData);
+void AdaptiveFilterFlushF(AfDataF *pData);
+
+#endif /* ADAPTIVEFILTERF_H_ */
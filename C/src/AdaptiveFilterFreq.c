@@ -0,0 +1,310 @@
+/*
+ * @file AdaptiveFilterFreq.c
+ *
+ * Frequency-domain block LMS adaptive filter (overlap-save FLMS) for long
+ * filters. Input is processed in blocks of Length samples with real FFTs of
+ * size 2*Length, so the cost per sample is O(log Length) instead of the
+ * O(Length) of AdaptiveFilter.c:
+ *
+ *   X = FFT([previous block, current block])
+ *   y = last half of IFFT(X .* W),  e = d - y
+ *   E = FFT([zeros, e])
+ *   P = Forgetting * P + (1 - Forgetting) * |X|^2       per bin
+ *   G = StepSize * conj(X) .* E ./ (P + Regularization)
+ *   W += FFT([first half of IFFT(G), zeros])            constrained gradient
+ *
+ * The gradient constraint discards the circular-correlation half of the
+ * gradient, so the result is the same linear convolution adaptive filter as
+ * the time-domain version rather than a circular one.
+ *
+ * Outputs are produced a block at a time, so both entry points return
+ * outputs and errors with a latency of Length samples.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+/******************************************************************************/
+/* include block */
+#include "AdaptiveFilterFreq.h"
+
+/******************************************************************************/
+/** local definitions **/
+static void ProcessBlock(AfFreqData *pData);
+
+/******************************************************************************
+ * AdaptiveFilterFreqMemSize
+ *
+ * @param[in]     length filter length, a power of two >= 2
+ *
+ * @returns       number of bytes AdaptiveFilterFreqInit() needs in pMem
+ *
+ * @note          none
+ *
+ * @warning       none
+ */
+size_t AdaptiveFilterFreqMemSize(unsigned int length) {
+	/* must match the carving in AdaptiveFilterFreqInit() */
+	return (14 * (size_t)length + 7) * sizeof(double) + AfFftMemSize(2 * length);
+}
+/* End of AdaptiveFilterFreqMemSize() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterFreqInit
+ *
+ * @param[out]    pData          pointer to frequency-domain AdaptiveFilter
+ *  parameter/state struct to initialize
+ * @param[in]     stepSize       adaptive filter step size
+ * @param[in]     regularization added to the smoothed power of every bin
+ * @param[in]     length         filter length, a power of two >= 2
+ * @param[in]     pMem           AdaptiveFilterFreqMemSize(length) bytes,
+ *  aligned for double
+ *
+ * @returns       0 on success, -1 if length is not a power of two >= 2
+ *
+ * @note          Clears the filter state and weights and sets Forgetting to
+ *  AF_FREQ_FORGETTING.
+ *
+ * @warning       pMem must stay valid for as long as pData is used
+ */
+int AdaptiveFilterFreqInit(AfFreqData *pData, double stepSize,
+                           double regularization, unsigned int length,
+                           void *pMem) {
+	double *p = (double *)pMem;
+	size_t i, total;
+
+	if (length < 2 || (length & (length - 1)) != 0) {
+		return -1;
+	}
+
+	pData->StepSize = stepSize;
+	pData->Regularization = regularization;
+	pData->Forgetting = AF_FREQ_FORGETTING;
+	pData->Length = length;
+	pData->Fill = 0;
+	pData->Blocks = 0;
+	pData->Error = 0.0;
+
+	pData->pInput = p;        p += 2 * length;
+	pData->pDesired = p;      p += length;
+	pData->pOutput = p;       p += length;
+	pData->pErrorBlock = p;   p += length;
+	pData->pWeights = p;      p += 2 * length + 2;
+	pData->pPower = p;        p += length + 1;
+	pData->pSpectrum = p;     p += 2 * length + 2;
+	pData->pWork = p;         p += 2 * length + 2;
+	pData->pTime = p;         p += 2 * length;
+
+	total = (size_t)(p - (double *)pMem);
+	for ( i = 0; i < total; i++ ) {
+		((double *)pMem)[i] = 0.0;
+	}
+
+	return AfFftInit(&pData->Fft, 2 * length, p);
+}
+/* End of AdaptiveFilterFreqInit() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterFreqRun
+ *
+ * @param[in]     input  input signal sample
+ * @param[in]     desired desired signal sample
+ * @param[in,out] pData  pointer to frequency-domain AdaptiveFilter
+ *  parameter/state struct
+ *
+ * @returns       adaptive filter output for the input Length samples ago
+ *  (0 during the first block)
+ *
+ * @note          Buffers the sample pair and runs the filter and the weight
+ *  update once a block is complete. pData->Error is the error matching the
+ *  returned output.
+ *
+ * @warning       none
+ */
+double AdaptiveFilterFreqRun(double input, double desired, AfFreqData *pData) {
+	const unsigned int fill = pData->Fill;
+	double output;
+
+	pData->pInput[pData->Length + fill] = input;
+	pData->pDesired[fill] = desired;
+	output = pData->pOutput[fill];
+	pData->Error = pData->pErrorBlock[fill];
+
+	if (++pData->Fill == pData->Length) {
+		ProcessBlock(pData);
+	}
+
+	return output;
+}
+/* End of AdaptiveFilterFreqRun() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterFreqRunBlock
+ *
+ * @param[in]     input   block of n input signal samples
+ * @param[in]     desired block of n desired signal samples
+ * @param[out]    output  block of n adaptive filter outputs (may be NULL)
+ * @param[out]    error   block of n errors, desired - output (may be NULL)
+ * @param[in]     n       number of samples in the block
+ * @param[in,out] pData   pointer to frequency-domain AdaptiveFilter
+ *  parameter/state struct
+ *
+ * @returns       none
+ *
+ * @note          Block form of AdaptiveFilterFreqRun() with the same
+ *  latency; n need not be a multiple of Length, and any split of a signal
+ *  gives exactly the same results as per-sample calls.
+ *
+ * @warning       input and desired must not alias output or error
+ */
+void AdaptiveFilterFreqRunBlock(const double *input, const double *desired,
+                                double *output, double *error, size_t n,
+                                AfFreqData *pData) {
+	const unsigned int length = pData->Length;
+	unsigned int fill, chunk, i;
+
+	while (n > 0) {
+		fill = pData->Fill;
+		chunk = length - fill;
+		if (chunk > n) {
+			chunk = (unsigned int)n;
+		}
+
+		for ( i = 0; i < chunk; i++ ) {
+			pData->pInput[length + fill + i] = input[i];
+			pData->pDesired[fill + i] = desired[i];
+			if (output) {
+				output[i] = pData->pOutput[fill + i];
+			}
+			if (error) {
+				error[i] = pData->pErrorBlock[fill + i];
+			}
+		}
+		pData->Error = pData->pErrorBlock[fill + chunk - 1];
+
+		pData->Fill += chunk;
+		if (pData->Fill == length) {
+			ProcessBlock(pData);
+		}
+
+		input += chunk;
+		desired += chunk;
+		if (output) {
+			output += chunk;
+		}
+		if (error) {
+			error += chunk;
+		}
+		n -= chunk;
+	}
+}
+/* End of AdaptiveFilterFreqRunBlock() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterFreqWeights
+ *
+ * @param[in,out] pData    pointer to frequency-domain AdaptiveFilter
+ *  parameter/state struct
+ * @param[out]    pWeights Length time-domain weights, ordered as
+ *  AfData.pWeights (pWeights[0] multiplies the newest input)
+ *
+ * @returns       none
+ *
+ * @note          Transforms the frequency-domain weights back to the time
+ *  domain. Uses the scratch buffers, so it must not run concurrently with
+ *  the filter.
+ *
+ * @warning       none
+ */
+void AdaptiveFilterFreqWeights(AfFreqData *pData, double *pWeights) {
+	unsigned int i;
+
+	AfFftInverse(&pData->Fft, pData->pWeights, pData->pTime);
+	for ( i = 0; i < pData->Length; i++ ) {
+		pWeights[i] = pData->pTime[i];
+	}
+}
+/* End of AdaptiveFilterFreqWeights() */
+/******************************************************************************/
+
+/** internal functions **/
+
+/***************************************************************************//**
+* ProcessBlock
+*
+* @param[in,out] pData pointer to frequency-domain AdaptiveFilter
+*  parameter/state struct
+*
+* @returns       none
+*
+* @note          Filters the completed block, computes its errors and
+*  applies the constrained, power-normalized gradient (see the file header).
+*  Five real FFTs of size 2*Length per block.
+*
+* @warning       none
+*******************************************************************************/
+static void ProcessBlock(AfFreqData *pData) {
+	const unsigned int length = pData->Length;
+	const AfFft *pFft = &pData->Fft;
+	const double lambda = (pData->Blocks == 0) ? 0.0 : pData->Forgetting;
+	const double *pX = pData->pSpectrum;
+	double *pW = pData->pWeights;
+	double *pG = pData->pWork;
+	double *pT = pData->pTime;
+	double xr, xi, er, ei, gain;
+	unsigned int i, k;
+
+	/* filter: output is the last half of the circular convolution */
+	AfFftForward(pFft, pData->pInput, pData->pSpectrum);
+	for ( k = 0; k <= length; k++ ) {
+		xr = pX[2 * k];
+		xi = pX[2 * k + 1];
+		pG[2 * k] = xr * pW[2 * k] - xi * pW[2 * k + 1];
+		pG[2 * k + 1] = xr * pW[2 * k + 1] + xi * pW[2 * k];
+	}
+	AfFftInverse(pFft, pG, pT);
+
+	for ( i = 0; i < length; i++ ) {
+		pData->pOutput[i] = pT[length + i];
+		pData->pErrorBlock[i] = pData->pDesired[i] - pT[length + i];
+		pT[i] = 0.0;
+		pT[length + i] = pData->pErrorBlock[i];
+	}
+	AfFftForward(pFft, pT, pG);
+
+	/* normalized gradient conj(X) E / (P + Regularization), per bin; the
+	 * first block seeds the power estimate directly */
+	for ( k = 0; k <= length; k++ ) {
+		xr = pX[2 * k];
+		xi = pX[2 * k + 1];
+		pData->pPower[k] = lambda * pData->pPower[k] +
+		                   (1.0 - lambda) * (xr * xr + xi * xi);
+		gain = pData->StepSize / (pData->pPower[k] + pData->Regularization);
+		er = pG[2 * k];
+		ei = pG[2 * k + 1];
+		pG[2 * k] = gain * (xr * er + xi * ei);
+		pG[2 * k + 1] = gain * (xr * ei - xi * er);
+	}
+
+	/* constrain the gradient to Length causal taps and apply it */
+	AfFftInverse(pFft, pG, pT);
+	for ( i = length; i < 2 * length; i++ ) {
+		pT[i] = 0.0;
+	}
+	AfFftForward(pFft, pT, pG);
+	for ( k = 0; k < 2 * length + 2; k++ ) {
+		pW[k] += pG[k];
+	}
+
+	/* the current block becomes the previous one */
+	for ( i = 0; i < length; i++ ) {
+		pData->pInput[i] = pData->pInput[length + i];
+	}
+	pData->Fill = 0;
+	pData->Blocks++;
+}
+/* End of ProcessBlock()*/
+/******************************************************************************/
@@ -0,0 +1,53 @@
+/*
+ * @file AdaptiveFilterFreq.h
+ *
+ * Header file for AdaptiveFilterFreq.c, the frequency-domain block LMS
+ * (overlap-save FLMS) counterpart of AdaptiveFilter.h for long filters.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+#ifndef ADAPTIVEFILTERFREQ_H_
+#define ADAPTIVEFILTERFREQ_H_
+
+#include <stddef.h>
+#include "AfFft.h"
+
+#define AF_FREQ_FORGETTING (0.9) /* default per-bin power smoothing factor */
+
+/* Contains frequency-domain Adaptive Filter parameters (StepSize,
+ * Regularization, Forgetting, Length) and state info. Set up with
+ * AdaptiveFilterFreqInit() in caller-provided memory; Forgetting may be
+ * changed after Init.
+ */
+typedef struct {
+	double StepSize; /* adaptive filter step size */
+	double Regularization; /* added to the smoothed power of every bin */
+	double Forgetting; /* power smoothing factor in [0,1) */
+	unsigned int Length; /* filter length and block length, a power of two */
+	AfFft Fft; /* real FFT of size 2*Length */
+	double *pInput; /* 2*Length: previous and current input block, oldest first */
+	double *pDesired; /* Length: desired samples of the current block */
+	double *pOutput; /* Length: outputs of the last completed block */
+	double *pErrorBlock; /* Length: errors of the last completed block */
+	double *pWeights; /* Length+1 complex bins: frequency-domain weights */
+	double *pPower; /* Length+1: smoothed power of each input bin */
+	double *pSpectrum; /* Length+1 complex bins: current input spectrum */
+	double *pWork; /* Length+1 complex bins: scratch spectrum */
+	double *pTime; /* 2*Length: scratch time-domain block */
+	unsigned int Fill; /* samples received in the current block */
+	unsigned long Blocks; /* number of completed blocks */
+	double Error; /* error of the sample whose output was returned last */
+} AfFreqData;
+
+size_t AdaptiveFilterFreqMemSize(unsigned int length);
+int AdaptiveFilterFreqInit(AfFreqData *pData, double stepSize,
+                           double regularization, unsigned int length,
+                           void *pMem);
+double AdaptiveFilterFreqRun(double input, double desired, AfFreqData *pData);
+void AdaptiveFilterFreqRunBlock(const double *input, const double *desired,
+                                double *output, double *error, size_t n,
+                                AfFreqData *pData);
+void AdaptiveFilterFreqWeights(AfFreqData *pData, double *pWeights);
+
+#endif /* ADAPTIVEFILTERFREQ_H_ */
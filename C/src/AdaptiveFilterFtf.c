@@ -0,0 +1,319 @@
+/*
+ * @file AdaptiveFilterFtf.c
+ *
+ * Stabilized fast transversal filter (FTF): exponentially weighted RLS in
+ * about 8 * Length multiplies per sample instead of the Length^2 of
+ * conventional RLS. Forward and backward linear predictors of order Length
+ * track the shift structure of the input so that the normalized gain
+ * C = R^-1 x / lambda can be order-updated rather than recomputed:
+ *
+ *   e_f = a' x+              forward a-priori error (x+ = Length+1 inputs)
+ *   [C; c] = [0; C] + a e_f / (lambda alpha)            extended gain
+ *   1/gamma+ = 1/gamma + e_f^2 / (lambda alpha)
+ *   1/alpha = 1/(lambda alpha) - gamma+ (e_f / (lambda alpha))^2
+ *   a -= gamma e_f [0; C]
+ *   e_b = lambda beta c      backward error from the gain, and directly as
+ *   e_b' = b' x+             their mixes e_b(K) = K e_b' + (1 - K) e_b
+ *   1/gamma = 1/gamma+ - c e_b(1)
+ *   C = C - c b              (drop back to order Length)
+ *   b -= gamma e_b(1.5) [C; 0],  beta = lambda beta + gamma e_b(2.5)^2
+ *   e = d - w' x,  w += gamma e C
+ *
+ * Plain FTF is numerically unstable: roundoff makes the two backward
+ * errors disagree and the disagreement grows without bound. Feeding the
+ * difference back with the K = 1.5 / 2.5 / 1 mix of Slock and Kailath keeps
+ * it bounded for Forgetting >= 1 - 1/(2 * Length). As a last line of
+ * defence the conversion factor and energies are checked every sample and
+ * the predictors restarted (weights kept) if they leave their valid range.
+ * The restart clears the delay line too: the initial energies assume the
+ * inputs before it were zero, and old samples left in the line make the
+ * two backward errors disagree from the first sample on.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+/******************************************************************************/
+/* include block */
+#include "AdaptiveFilterFtf.h"
+#include <math.h>
+
+/******************************************************************************/
+/** local definitions **/
+#define K1 (1.5) /* backward error mix for the backward predictor update */
+#define K2 (2.5) /* backward error mix for the backward energy update */
+#define K3 (1.0) /* backward error mix for the conversion factor update */
+static const double *PushInput(double input, AfFtfData *pData);
+
+/******************************************************************************
+ * AdaptiveFilterFtfMemSize
+ *
+ * @param[in]     length filter length
+ *
+ * @returns       number of bytes AdaptiveFilterFtfInit() needs in pMem
+ *
+ * @note          none
+ *
+ * @warning       none
+ */
+size_t AdaptiveFilterFtfMemSize(unsigned int length) {
+	/* must match the carving in AdaptiveFilterFtfInit() */
+	return (6 * (size_t)length + 5) * sizeof(double);
+}
+/* End of AdaptiveFilterFtfMemSize() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterFtfInit
+ *
+ * @param[out]    pData          pointer to FTF AdaptiveFilter parameter/state
+ *  struct to initialize
+ * @param[in]     forgetting     forgetting factor lambda, at least
+ *  1 - 1/(2*length) and below 1 (AF_FTF_FORGETTING is a typical value)
+ * @param[in]     regularization initial prediction error energy; larger
+ *  values damp the first few Length samples
+ * @param[in]     length         filter length, at least 1
+ * @param[in]     pMem           AdaptiveFilterFtfMemSize(length) bytes,
+ *  aligned for double
+ *
+ * @returns       0 on success, -1 if length is 0
+ *
+ * @note          Clears the filter state and weights. A smaller forgetting
+ *  factor tracks faster and forgets the initial regularization sooner, a
+ *  larger one averages more noise.
+ *
+ * @warning       pMem must stay valid for as long as pData is used
+ */
+int AdaptiveFilterFtfInit(AfFtfData *pData, double forgetting,
+                          double regularization, unsigned int length,
+                          void *pMem) {
+	double *p = (double *)pMem;
+	size_t i, total;
+
+	if (length == 0) {
+		return -1;
+	}
+
+	pData->Forgetting = forgetting;
+	pData->Regularization = regularization;
+	pData->Length = length;
+	pData->BufferIdx = 0;
+	pData->Rescues = 0;
+	pData->pKernels = AfKernelsGet(AF_ISA_AUTO);
+	pData->Error = 0.0;
+
+	pData->pBuffer = p;     p += 2 * (length + 1);
+	pData->pWeights = p;    p += length;
+	pData->pForward = p;    p += length + 1;
+	pData->pBackward = p;   p += length + 1;
+	pData->pGain = p;       p += length + 1;
+
+	total = (size_t)(p - (double *)pMem);
+	for ( i = 0; i < total; i++ ) {
+		((double *)pMem)[i] = 0.0;
+	}
+
+	AdaptiveFilterFtfRescue(pData);
+	pData->Rescues = 0;
+
+	return 0;
+}
+/* End of AdaptiveFilterFtfInit() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterFtfRun
+ *
+ * @param[in]     input  input signal sample
+ * @param[in]     desired desired signal sample
+ * @param[in,out] pData  pointer to FTF AdaptiveFilter parameter/state struct
+ *
+ * @returns       adaptive filter output (estimate of desired signal)
+ *
+ * @note          Runs one stabilized FTF iteration (see the file header).
+ *  pData->Error is the a-priori error of this sample. If the recursion
+ *  leaves its valid range the predictors are restarted and
+ *  pData->Rescues is incremented.
+ *
+ * @warning       none
+ */
+double AdaptiveFilterFtfRun(double input, double desired, AfFtfData *pData) {
+	const unsigned int length = pData->Length;
+	const double lambda = pData->Forgetting;
+	const AfKernels *pK;
+	double *pA = pData->pForward, *pB = pData->pBackward, *pC = pData->pGain;
+	const double *pX;
+	double ef, epsf, kf, c, ebGain, ebDirect, eb1, eb2, eb3;
+	double inverseGamma, output, epsilon;
+	unsigned int i;
+
+	if (!pData->pKernels) {
+		pData->pKernels = AfKernelsGet(AF_ISA_AUTO); /* select SIMD kernels on first use */
+	}
+	pK = pData->pKernels;
+
+	pX = PushInput(input, pData);
+
+	/* forward prediction and the order-extended gain; the loop reads the
+	 * old gain before it is shifted over */
+	ef = pK->Dot(pA, pX, length + 1);
+	epsf = pData->Gamma * ef;
+	kf = ef / (lambda * pData->ForwardEnergy);
+	inverseGamma = 1.0 / pData->Gamma + kf * ef;
+	for ( i = length; i > 0; i-- ) {
+		c = pC[i - 1] + kf * pA[i];
+		pA[i] -= epsf * pC[i - 1];
+		pC[i] = c;
+	}
+	pC[0] = kf; /* pA[0] == 1 */
+	pData->ForwardEnergy = 1.0 / (1.0 / (lambda * pData->ForwardEnergy) - kf * kf / inverseGamma);
+
+	/* backward prediction error two ways, mixed for stability */
+	c = pC[length];
+	ebGain = lambda * pData->BackwardEnergy * c;
+	ebDirect = pK->Dot(pB, pX, length + 1);
+	eb1 = K1 * ebDirect + (1.0 - K1) * ebGain;
+	eb2 = K2 * ebDirect + (1.0 - K2) * ebGain;
+	eb3 = K3 * ebDirect + (1.0 - K3) * ebGain;
+
+	/* drop back to order Length and update the backward predictor */
+	inverseGamma -= c * eb3;
+	pData->Gamma = 1.0 / inverseGamma;
+	pK->ScaledAdd(pC, -c, pB, length);
+	pK->ScaledAdd(pB, -pData->Gamma * eb1, pC, length);
+	pData->BackwardEnergy = lambda * pData->BackwardEnergy + pData->Gamma * eb2 * eb2;
+
+	/* joint process: filter and weight update */
+	output = pK->Dot(pData->pWeights, pX, length);
+	pData->Error = desired - output;
+	epsilon = pData->Gamma * pData->Error;
+	pK->ScaledAdd(pData->pWeights, epsilon, pC, length);
+
+	if (!(pData->Gamma > 0.0 && pData->Gamma <= 1.0) ||
+	    !(pData->ForwardEnergy > 0.0) || !(pData->BackwardEnergy > 0.0) ||
+	    !isfinite(pData->pWeights[0])) {
+		AdaptiveFilterFtfRescue(pData);
+	}
+
+	return output;
+}
+/* End of AdaptiveFilterFtfRun() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterFtfRunBlock
+ *
+ * @param[in]     input   block of n input signal samples
+ * @param[in]     desired block of n desired signal samples
+ * @param[out]    output  block of n adaptive filter outputs (may be NULL)
+ * @param[out]    error   block of n errors, desired - output (may be NULL)
+ * @param[in]     n       number of samples in the block
+ * @param[in,out] pData   pointer to FTF AdaptiveFilter parameter/state struct
+ *
+ * @returns       none
+ *
+ * @note          Same results as calling AdaptiveFilterFtfRun() once per
+ *  sample.
+ *
+ * @warning       input and desired must not alias output or error
+ */
+void AdaptiveFilterFtfRunBlock(const double *input, const double *desired,
+                               double *output, double *error, size_t n,
+                               AfFtfData *pData) {
+	double y;
+	size_t i;
+
+	for ( i = 0; i < n; i++ ) {
+		y = AdaptiveFilterFtfRun(input[i], desired[i], pData);
+		if (output) {
+			output[i] = y;
+		}
+		if (error) {
+			error[i] = pData->Error;
+		}
+	}
+}
+/* End of AdaptiveFilterFtfRunBlock() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterFtfRescue
+ *
+ * @param[in,out] pData pointer to FTF AdaptiveFilter parameter/state struct
+ *
+ * @returns       none
+ *
+ * @note          Restarts the predictors, gain, conversion factor, energies
+ *  and delay line from their initial values and increments
+ *  pData->Rescues. The weights are kept, so the filter output carries on
+ *  once the delay line has refilled and the gain rebuilds over the next
+ *  few Length samples. Called
+ *  automatically on divergence; may also be called to re-seed the
+ *  recursion, e.g. after a step change in input level.
+ *
+ * @warning       a weight vector that is itself non-finite is cleared
+ */
+void AdaptiveFilterFtfRescue(AfFtfData *pData) {
+	const unsigned int length = pData->Length;
+	unsigned int i;
+
+	for ( i = 0; i <= length; i++ ) {
+		pData->pForward[i] = 0.0;
+		pData->pBackward[i] = 0.0;
+		pData->pGain[i] = 0.0;
+	}
+	pData->pForward[0] = 1.0;
+	pData->pBackward[length] = 1.0;
+	for ( i = 0; i < 2 * (length + 1); i++ ) {
+		pData->pBuffer[i] = 0.0;
+	}
+	for ( i = 0; i < length; i++ ) {
+		if (!isfinite(pData->pWeights[i])) {
+			for ( i = 0; i < length; i++ ) {
+				pData->pWeights[i] = 0.0;
+			}
+			break;
+		}
+	}
+
+	/* initial correlation delta * diag(1, 1/lambda, ..., 1/lambda^Length),
+	 * which is consistent with both the forward and backward orderings */
+	pData->Gamma = 1.0;
+	pData->ForwardEnergy = pData->Regularization;
+	pData->BackwardEnergy = pData->Regularization * pow(pData->Forgetting, -(double)length);
+	pData->Rescues++;
+}
+/* End of AdaptiveFilterFtfRescue() */
+/******************************************************************************/
+
+/** internal functions **/
+
+/***************************************************************************//**
+* PushInput
+*
+* @param[in]     input new input sample
+* @param[in,out] pData pointer to FTF AdaptiveFilter parameter/state struct
+*
+* @returns       the Length + 1 newest inputs, newest first, contiguous
+*
+* @note          Mirrored delay line as in AdaptiveFilter.c.
+*
+* @warning       none
+*******************************************************************************/
+static const double *PushInput(double input, AfFtfData *pData) {
+	const unsigned int span = pData->Length + 1;
+	unsigned int idx = pData->BufferIdx;
+
+	/* wrap index */
+	if (idx == 0) {
+		idx = span;
+	}
+	idx--;
+
+	pData->pBuffer[idx] = input;
+	pData->pBuffer[idx + span] = input;
+	pData->BufferIdx = idx;
+
+	return pData->pBuffer + idx;
+}
+/* End of PushInput()*/
+/******************************************************************************/
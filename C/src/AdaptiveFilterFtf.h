@@ -0,0 +1,55 @@
+/*
+ * @file AdaptiveFilterFtf.h
+ *
+ * Header file for AdaptiveFilterFtf.c, the stabilized fast transversal
+ * filter (FTF), an exponentially weighted recursive least squares adaptive
+ * filter with O(Length) cost per sample.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+#ifndef ADAPTIVEFILTERFTF_H_
+#define ADAPTIVEFILTERFTF_H_
+
+#include <stddef.h>
+#include "AfKernels.h"
+
+#define AF_FTF_FORGETTING (0.999) /* typical forgetting factor; stable for
+                                   * 1 - 1/(2*Length) <= Forgetting < 1 */
+
+/* Contains fast transversal filter parameters (Forgetting, Regularization,
+ * Length) and state info. Set up with AdaptiveFilterFtfInit() in
+ * caller-provided memory. The delay line has the mirrored layout of AfData,
+ * Length + 1 samples long.
+ */
+typedef struct {
+	double Forgetting; /* exponential forgetting factor lambda */
+	double Regularization; /* initial prediction error energy delta */
+	unsigned int Length; /* filter length */
+	double *pBuffer; /* mirrored delay line, 2*(Length+1) samples */
+	unsigned int BufferIdx; /* index of newest sample in pBuffer */
+	double *pWeights; /* Length adaptive filter weights */
+	double *pForward; /* Length+1 forward predictor, pForward[0] = 1 */
+	double *pBackward; /* Length+1 backward predictor, pBackward[Length] = 1 */
+	double *pGain; /* Length+1 normalized gain; the first Length are the
+	                * gain of the filter, the last is scratch */
+	double Gamma; /* conversion factor, in (0,1] while stable */
+	double ForwardEnergy; /* forward prediction error energy */
+	double BackwardEnergy; /* backward prediction error energy */
+	unsigned long Rescues; /* times the predictors were restarted */
+	const AfKernels *pKernels; /* vector kernels, NULL: best for the host,
+	                            * selected on first use (see AfKernelsGet) */
+	double Error; /* error of the newest sample (desired - output) */
+} AfFtfData;
+
+size_t AdaptiveFilterFtfMemSize(unsigned int length);
+int AdaptiveFilterFtfInit(AfFtfData *pData, double forgetting,
+                          double regularization, unsigned int length,
+                          void *pMem);
+double AdaptiveFilterFtfRun(double input, double desired, AfFtfData *pData);
+void AdaptiveFilterFtfRunBlock(const double *input, const double *desired,
+                               double *output, double *error, size_t n,
+                               AfFtfData *pData);
+void AdaptiveFilterFtfRescue(AfFtfData *pData);
+
+#endif /* ADAPTIVEFILTERFTF_H_ */
@@ -0,0 +1,432 @@
+/*
+ * @file AdaptiveFilterLatency.c
+ *
+ * Latency harness for AdaptiveFilter, for qualifying a host for real-time
+ * traffic. Every call to AdaptiveFilterRun() (or AdaptiveFilterRunBlock()
+ * with --block N) is timestamped and its duration recorded in an
+ * HDR-style histogram. The run reports p50/p90/p99/p99.9/p99.99 and the
+ * maximum, and counts the calls that overran their deadline (block /
+ * rate). The thread can be pinned to a CPU and run under SCHED_FIFO, and
+ * timing can use the TSC instead of clock_gettime().
+ *
+ * Usage: AdaptiveFilterLatency [--taps N] [--block N] [--calls N]
+ *                              [--isa NAME] [--rate HZ] [--cpu K]
+ *                              [--fifo PRIORITY] [--tsc] [--hist FILE]
+ *
+ * Exit status: 0, or 2 if any call missed its deadline, 1 on an error.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* pthread_setaffinity_np() */
+#endif
+
+/******************************************************************************/
+/* include block */
+#include "AdaptiveFilter.h"
+#include "AfHistogram.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <x86intrin.h>
+#define LATENCY_HAVE_TSC (1)
+#endif
+
+/******************************************************************************/
+/** local definitions **/
+#define LATENCY_TAPS (512) /* default filter length */
+#define LATENCY_CALLS (1000000) /* default timed calls */
+#define LATENCY_WARMUP_CALLS (10000) /* untimed calls before timing */
+#define LATENCY_RATE (48000.0) /* default sample rate for the deadline */
+#define LATENCY_SIGNAL (4096) /* signal samples, cycled */
+#define LATENCY_CALIBRATE_NS (50000000.0) /* TSC calibration interval */
+#define LATENCY_OVERHEAD_SAMPLES (10000) /* timer reads for the overhead */
+#define LATENCY_STEPSIZE (0.3)
+#define LATENCY_REGULARIZATION (1.0E-10)
+#define LATENCY_SEED (824)
+
+static const double percentiles[] = { 50.0, 90.0, 99.0, 99.9, 99.99 };
+static double input[LATENCY_SIGNAL], desired[LATENCY_SIGNAL];
+static AfHistogram histogram;
+static int useTsc;
+static double tscNsPerTick;
+
+static uint64_t NowTicks(void);
+static double CalibrateTsc(void);
+static uint64_t TimerOverhead(void);
+static const AfKernels *FindKernels(const char *pName);
+static int PinAndSchedule(int cpu, int priority);
+static int WriteHistogram(const char *pPath, const AfHistogram *pHist);
+
+/******************************************************************************
+ * main
+ *
+ * @param[in]     argc argument count
+ * @param[in]     argv options, see the file header
+ *
+ * @returns       0, 2 on deadline misses, 1 on a bad option or an error
+ *
+ * @note          none
+ *
+ * @warning       SCHED_FIFO at a high priority can starve other threads on
+ *  the CPU for the length of the run
+ */
+int main(int argc, char *argv[]) {
+	unsigned int taps = LATENCY_TAPS, block = 1;
+	unsigned long calls = LATENCY_CALLS, call, misses = 0;
+	const char *pIsa = "auto", *pHistPath = NULL;
+	double rate = LATENCY_RATE, deadlineNs;
+	int cpu = -1, priority = 0, i, status = 0;
+	static double output[LATENCY_SIGNAL];
+	unsigned int position = 0, k;
+	uint64_t start, ticks, ns, overhead;
+	const AfKernels *pKernels;
+	AfArena arena;
+	AfData *pData;
+
+	for ( i = 1; i < argc; i++ ) {
+		if (i + 1 < argc && strcmp(argv[i], "--taps") == 0) {
+			taps = (unsigned int)strtoul(argv[++i], NULL, 0);
+		}
+		else if (i + 1 < argc && strcmp(argv[i], "--block") == 0) {
+			block = (unsigned int)strtoul(argv[++i], NULL, 0);
+		}
+		else if (i + 1 < argc && strcmp(argv[i], "--calls") == 0) {
+			calls = strtoul(argv[++i], NULL, 0);
+		}
+		else if (i + 1 < argc && strcmp(argv[i], "--isa") == 0) {
+			pIsa = argv[++i];
+		}
+		else if (i + 1 < argc && strcmp(argv[i], "--rate") == 0) {
+			rate = strtod(argv[++i], NULL);
+		}
+		else if (i + 1 < argc && strcmp(argv[i], "--cpu") == 0) {
+			cpu = atoi(argv[++i]);
+		}
+		else if (i + 1 < argc && strcmp(argv[i], "--fifo") == 0) {
+			priority = atoi(argv[++i]);
+		}
+		else if (i + 1 < argc && strcmp(argv[i], "--hist") == 0) {
+			pHistPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--tsc") == 0) {
+			useTsc = 1;
+		}
+		else {
+			fprintf(stderr, "usage: %s [--taps N] [--block N] [--calls N] [--isa NAME] "
+			        "[--rate HZ] [--cpu K] [--fifo PRIORITY] [--tsc] [--hist FILE]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (taps == 0 || block == 0 || block > LATENCY_SIGNAL ||
+	    LATENCY_SIGNAL % block != 0 || calls == 0 || rate <= 0.0) {
+		fprintf(stderr, "%s: need taps, calls, rate > 0 and a block dividing %u\n",
+		        argv[0], LATENCY_SIGNAL);
+		return 1;
+	}
+	pKernels = FindKernels(pIsa);
+	if (!pKernels) {
+		fprintf(stderr, "%s: kernel table %s not available on this host\n", argv[0], pIsa);
+		return 1;
+	}
+#ifndef LATENCY_HAVE_TSC
+	if (useTsc) {
+		fprintf(stderr, "%s: no TSC on this target, using clock_gettime\n", argv[0]);
+		useTsc = 0;
+	}
+#endif
+
+	/* scheduling first, so the filter memory is touched on the pinned CPU */
+	if (PinAndSchedule(cpu, priority) != 0) {
+		status = 1; /* reported; the run goes on without it */
+	}
+
+	{
+		const AfData config = {
+			.StepSize = LATENCY_STEPSIZE,
+			.Regularization = LATENCY_REGULARIZATION,
+			.Length = taps,
+			.Layout = AF_DELAY_MIRRORED
+		};
+
+		if (AfArenaInit(&arena, AdaptiveFilterArenaSize(1, &config), AF_ARENA_HUGE_PAGES) != 0) {
+			fprintf(stderr, "%s: cannot allocate %u taps\n", argv[0], taps);
+			return 1;
+		}
+		pData = AdaptiveFilterCreate(&arena, &config);
+		pData->pKernels = pKernels;
+	}
+
+	srand(LATENCY_SEED);
+	for ( k = 0; k < LATENCY_SIGNAL; k++ ) {
+		input[k] = ( 2 * (double)rand() / (double)RAND_MAX ) - 1;
+		desired[k] = ( 2 * (double)rand() / (double)RAND_MAX ) - 1;
+	}
+	if (useTsc) {
+		tscNsPerTick = CalibrateTsc();
+	}
+	overhead = TimerOverhead();
+	deadlineNs = 1.0E9 * block / rate;
+	AfHistogramInit(&histogram);
+
+	for ( call = 0; call < LATENCY_WARMUP_CALLS + calls; call++ ) {
+		start = NowTicks();
+		if (block == 1) {
+			AdaptiveFilterRun(input[position], desired[position], pData);
+		}
+		else {
+			AdaptiveFilterRunBlock(input + position, desired + position, output,
+			                       NULL, block, pData);
+		}
+		ticks = NowTicks() - start;
+		position = (position + block) % LATENCY_SIGNAL;
+
+		if (call >= LATENCY_WARMUP_CALLS) {
+			ns = useTsc ? (uint64_t)((double)ticks * tscNsPerTick) : ticks;
+			AfHistogramRecord(&histogram, ns);
+			if ((double)ns > deadlineNs) {
+				misses++;
+			}
+		}
+	}
+
+	printf("taps %u, block %u, isa %s, timer %s (overhead %llu ns), cpu %d, %s %d\n",
+	       taps, block, pKernels->Name, useTsc ? "tsc" : "clock_gettime",
+	       (unsigned long long)overhead, cpu, priority ? "SCHED_FIFO" : "nice", priority);
+	printf("calls %lu, latency ns: min %llu mean %.1f", calls,
+	       (unsigned long long)histogram.Min, histogram.Sum / (double)histogram.Count);
+	for ( k = 0; k < sizeof(percentiles) / sizeof(percentiles[0]); k++ ) {
+		printf(" p%g %llu", percentiles[k],
+		       (unsigned long long)AfHistogramPercentile(&histogram, percentiles[k]));
+	}
+	printf(" max %llu\n", (unsigned long long)histogram.Max);
+	printf("deadline %.0f ns (%u samples at %.0f Hz): %lu misses\n",
+	       deadlineNs, block, rate, misses);
+
+	if (pHistPath && WriteHistogram(pHistPath, &histogram) != 0) {
+		fprintf(stderr, "%s: cannot write %s\n", argv[0], pHistPath);
+		status = 1;
+	}
+	AfArenaDestroy(&arena);
+
+	return (status == 0 && misses > 0) ? 2 : status;
+}
+/* End of main() */
+/******************************************************************************/
+
+/** internal functions **/
+
+/***************************************************************************//**
+* NowTicks
+*
+* @param[in]     none
+*
+* @returns       TSC ticks with --tsc, otherwise monotonic nanoseconds
+*
+* @note          The TSC read is fenced so the timed call cannot be
+*  reordered around it.
+*
+* @warning       none
+*******************************************************************************/
+static uint64_t NowTicks(void) {
+	struct timespec now;
+
+#ifdef LATENCY_HAVE_TSC
+	if (useTsc) {
+		uint64_t tsc;
+
+		_mm_lfence();
+		tsc = __rdtsc();
+		_mm_lfence();
+		return tsc;
+	}
+#endif
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+/* End of NowTicks()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* CalibrateTsc
+*
+* @param[in]     none
+*
+* @returns       nanoseconds per TSC tick
+*
+* @note          Counts ticks over LATENCY_CALIBRATE_NS of CLOCK_MONOTONIC.
+*  Assumes an invariant TSC, as on any host worth qualifying.
+*
+* @warning       none
+*******************************************************************************/
+static double CalibrateTsc(void) {
+	struct timespec begin, now;
+	uint64_t ticks;
+	double elapsed;
+
+	clock_gettime(CLOCK_MONOTONIC, &begin);
+	ticks = NowTicks();
+	do {
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		elapsed = (double)(now.tv_sec - begin.tv_sec) * 1.0E9 +
+		          (double)(now.tv_nsec - begin.tv_nsec);
+	} while (elapsed < LATENCY_CALIBRATE_NS);
+	ticks = NowTicks() - ticks;
+
+	return elapsed / (double)ticks;
+}
+/* End of CalibrateTsc()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* TimerOverhead
+*
+* @param[in]     none
+*
+* @returns       smallest back-to-back timer read difference, in ns
+*
+* @note          Included in every recorded latency, so small blocks should
+*  be judged against it.
+*
+* @warning       none
+*******************************************************************************/
+static uint64_t TimerOverhead(void) {
+	uint64_t best = UINT64_MAX, start, ticks;
+	unsigned int k;
+
+	for ( k = 0; k < LATENCY_OVERHEAD_SAMPLES; k++ ) {
+		start = NowTicks();
+		ticks = NowTicks() - start;
+		if (ticks < best) {
+			best = ticks;
+		}
+	}
+
+	return useTsc ? (uint64_t)((double)best * tscNsPerTick) : best;
+}
+/* End of TimerOverhead()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* FindKernels
+*
+* @param[in]     pName kernel table name (scalar, sse2, avx2, avx512, neon)
+*  or auto
+*
+* @returns       the kernel table, or NULL if unknown or unsupported
+*
+* @note          none
+*
+* @warning       none
+*******************************************************************************/
+static const AfKernels *FindKernels(const char *pName) {
+	static const AfIsa isas[] = {
+		AF_ISA_SCALAR, AF_ISA_SSE2, AF_ISA_AVX2, AF_ISA_AVX512, AF_ISA_NEON
+	};
+	const AfKernels *pKernels;
+	unsigned int k;
+
+	if (strcmp(pName, "auto") == 0) {
+		return AfKernelsGet(AF_ISA_AUTO);
+	}
+	for ( k = 0; k < sizeof(isas) / sizeof(isas[0]); k++ ) {
+		pKernels = AfKernelsGet(isas[k]);
+		if (pKernels && strcmp(pKernels->Name, pName) == 0) {
+			return pKernels;
+		}
+	}
+
+	return NULL;
+}
+/* End of FindKernels()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* PinAndSchedule
+*
+* @param[in]     cpu      CPU to pin the thread to, -1: leave it
+* @param[in]     priority SCHED_FIFO priority, 0: leave the policy
+*
+* @returns       0 on success, -1 if a request was refused
+*
+* @note          Refusals (no permission, no such CPU, pinning unsupported
+*  outside Linux) are printed to stderr and the run continues without them.
+*
+* @warning       none
+*******************************************************************************/
+static int PinAndSchedule(int cpu, int priority) {
+	struct sched_param param;
+	int status = 0;
+
+	if (cpu >= 0) {
+#if defined(__linux__)
+		cpu_set_t set;
+
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+		if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+			fprintf(stderr, "cannot pin to cpu %d\n", cpu);
+			status = -1;
+		}
+#else
+		fprintf(stderr, "cpu pinning is only supported on Linux\n");
+		status = -1;
+#endif
+	}
+	if (priority > 0) {
+		memset(&param, 0, sizeof(param));
+		param.sched_priority = priority;
+		if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+			fprintf(stderr, "cannot set SCHED_FIFO priority %d (needs CAP_SYS_NICE)\n", priority);
+			status = -1;
+		}
+	}
+
+	return status;
+}
+/* End of PinAndSchedule()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* WriteHistogram
+*
+* @param[in]     pPath output file
+* @param[in]     pHist histogram
+*
+* @returns       0 on success, -1 if the file cannot be written
+*
+* @note          CSV of the non-empty buckets: largest value in ns, count
+*  and the cumulative percentile up to that bucket. The overflow bucket has
+*  no upper bound, so its row carries the recorded maximum.
+*
+* @warning       none
+*******************************************************************************/
+static int WriteHistogram(const char *pPath, const AfHistogram *pHist) {
+	FILE *pFile = fopen(pPath, "w");
+	uint64_t seen = 0, value;
+	unsigned int k;
+
+	if (!pFile) {
+		return -1;
+	}
+	fprintf(pFile, "value_ns,count,percentile\n");
+	for ( k = 0; k < AF_HIST_BUCKETS; k++ ) {
+		if (pHist->Counts[k] == 0) {
+			continue;
+		}
+		seen += pHist->Counts[k];
+		value = (k == AF_HIST_BUCKETS - 1) ? pHist->Max : AfHistogramBucketValue(k);
+		fprintf(pFile, "%llu,%llu,%.5f\n", (unsigned long long)value,
+		        (unsigned long long)pHist->Counts[k], 100.0 * (double)seen / (double)pHist->Count);
+	}
+
+	return (fclose(pFile) == 0) ? 0 : -1;
+}
+/* End of WriteHistogram()*/
+/******************************************************************************/
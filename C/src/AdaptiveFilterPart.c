@@ -0,0 +1,347 @@
+/*
+ * @file AdaptiveFilterPart.c
+ *
+ * Partitioned-block frequency-domain adaptive filter (PBFDAF, also known as
+ * the multi-delay filter). The Length = Partitions * BlockSize taps are
+ * split into partitions of BlockSize taps, and the input spectra of the
+ * last Partitions blocks are kept in a frequency-domain delay line, so the
+ * latency is one block rather than the whole filter length of
+ * AdaptiveFilterFreq.c. Per block, with FFTs of size 2*BlockSize:
+ *
+ *   X_0 = FFT([previous block, current block]), X_p = X_0 of p blocks ago
+ *   y = last half of IFFT(sum_p X_p .* W_p),  e = d - y
+ *   E = FFT([zeros, e])
+ *   P_0 = Forgetting * P_1 + (1 - Forgetting) * |X_0|^2   per bin
+ *   W_p += FFT([first half of IFFT(mu * conj(X_p) .* E ./ (P_p + Regularization)), zeros])
+ *
+ * Each partition is normalized by the smoothed power of its own delay line
+ * spectrum, and mu = StepSize / Partitions so that StepSize has the same
+ * meaning as in the single-partition filter: the partitions share one error
+ * and their corrections add up.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+/******************************************************************************/
+/* include block */
+#include "AdaptiveFilterPart.h"
+
+/******************************************************************************/
+/** local definitions **/
+static void ProcessBlock(AfPartData *pData);
+
+/******************************************************************************
+ * AdaptiveFilterPartMemSize
+ *
+ * @param[in]     blockSize  partition size, a power of two >= 2
+ * @param[in]     partitions number of partitions, >= 1
+ *
+ * @returns       number of bytes AdaptiveFilterPartInit() needs in pMem
+ *
+ * @note          none
+ *
+ * @warning       none
+ */
+size_t AdaptiveFilterPartMemSize(unsigned int blockSize, unsigned int partitions) {
+	/* must match the carving in AdaptiveFilterPartInit() */
+	return ((11 * (size_t)blockSize + 4) + (size_t)partitions * (5 * blockSize + 5)) *
+	       sizeof(double) + AfFftMemSize(2 * blockSize);
+}
+/* End of AdaptiveFilterPartMemSize() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterPartInit
+ *
+ * @param[out]    pData          pointer to partitioned AdaptiveFilter
+ *  parameter/state struct to initialize
+ * @param[in]     stepSize       adaptive filter step size
+ * @param[in]     regularization added to the smoothed power of every bin
+ * @param[in]     blockSize      partition size and latency, a power of
+ *  two >= 2
+ * @param[in]     partitions     number of partitions, >= 1
+ * @param[in]     pMem           AdaptiveFilterPartMemSize(blockSize,
+ *  partitions) bytes, aligned for double
+ *
+ * @returns       0 on success, -1 on invalid sizes
+ *
+ * @note          Clears the filter state and weights and sets Forgetting to
+ *  AF_PART_FORGETTING.
+ *
+ * @warning       pMem must stay valid for as long as pData is used
+ */
+int AdaptiveFilterPartInit(AfPartData *pData, double stepSize,
+                           double regularization, unsigned int blockSize,
+                           unsigned int partitions, void *pMem) {
+	const size_t bins = 2 * (size_t)blockSize + 2;
+	double *p = (double *)pMem;
+	size_t i, total;
+
+	if (blockSize < 2 || (blockSize & (blockSize - 1)) != 0 || partitions == 0) {
+		return -1;
+	}
+
+	pData->StepSize = stepSize;
+	pData->Regularization = regularization;
+	pData->Forgetting = AF_PART_FORGETTING;
+	pData->Length = blockSize * partitions;
+	pData->BlockSize = blockSize;
+	pData->Partitions = partitions;
+	pData->Head = 0;
+	pData->Fill = 0;
+	pData->Blocks = 0;
+	pData->Error = 0.0;
+
+	pData->pInput = p;        p += 2 * blockSize;
+	pData->pDesired = p;      p += blockSize;
+	pData->pOutput = p;       p += blockSize;
+	pData->pErrorBlock = p;   p += blockSize;
+	pData->pWork = p;         p += bins;
+	pData->pGradient = p;     p += bins;
+	pData->pTime = p;         p += 2 * blockSize;
+	pData->pSpectra = p;      p += partitions * bins;
+	pData->pPower = p;        p += partitions * (blockSize + 1);
+	pData->pWeights = p;      p += partitions * bins;
+
+	total = (size_t)(p - (double *)pMem);
+	for ( i = 0; i < total; i++ ) {
+		((double *)pMem)[i] = 0.0;
+	}
+
+	return AfFftInit(&pData->Fft, 2 * blockSize, p);
+}
+/* End of AdaptiveFilterPartInit() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterPartRun
+ *
+ * @param[in]     input  input signal sample
+ * @param[in]     desired desired signal sample
+ * @param[in,out] pData  pointer to partitioned AdaptiveFilter parameter/state
+ *  struct
+ *
+ * @returns       adaptive filter output for the input BlockSize samples ago
+ *  (0 during the first block)
+ *
+ * @note          Buffers the sample pair and runs the filter and the weight
+ *  update once a block is complete. pData->Error is the error matching the
+ *  returned output.
+ *
+ * @warning       none
+ */
+double AdaptiveFilterPartRun(double input, double desired, AfPartData *pData) {
+	const unsigned int fill = pData->Fill;
+	double output;
+
+	pData->pInput[pData->BlockSize + fill] = input;
+	pData->pDesired[fill] = desired;
+	output = pData->pOutput[fill];
+	pData->Error = pData->pErrorBlock[fill];
+
+	if (++pData->Fill == pData->BlockSize) {
+		ProcessBlock(pData);
+	}
+
+	return output;
+}
+/* End of AdaptiveFilterPartRun() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterPartRunBlock
+ *
+ * @param[in]     input   block of n input signal samples
+ * @param[in]     desired block of n desired signal samples
+ * @param[out]    output  block of n adaptive filter outputs (may be NULL)
+ * @param[out]    error   block of n errors, desired - output (may be NULL)
+ * @param[in]     n       number of samples in the block
+ * @param[in,out] pData   pointer to partitioned AdaptiveFilter
+ *  parameter/state struct
+ *
+ * @returns       none
+ *
+ * @note          Block form of AdaptiveFilterPartRun() with the same
+ *  latency; n need not be a multiple of BlockSize, and any split of a signal
+ *  gives exactly the same results as per-sample calls.
+ *
+ * @warning       input and desired must not alias output or error
+ */
+void AdaptiveFilterPartRunBlock(const double *input, const double *desired,
+                                double *output, double *error, size_t n,
+                                AfPartData *pData) {
+	const unsigned int blockSize = pData->BlockSize;
+	unsigned int fill, chunk, i;
+
+	while (n > 0) {
+		fill = pData->Fill;
+		chunk = blockSize - fill;
+		if (chunk > n) {
+			chunk = (unsigned int)n;
+		}
+
+		for ( i = 0; i < chunk; i++ ) {
+			pData->pInput[blockSize + fill + i] = input[i];
+			pData->pDesired[fill + i] = desired[i];
+			if (output) {
+				output[i] = pData->pOutput[fill + i];
+			}
+			if (error) {
+				error[i] = pData->pErrorBlock[fill + i];
+			}
+		}
+		pData->Error = pData->pErrorBlock[fill + chunk - 1];
+
+		pData->Fill += chunk;
+		if (pData->Fill == blockSize) {
+			ProcessBlock(pData);
+		}
+
+		input += chunk;
+		desired += chunk;
+		if (output) {
+			output += chunk;
+		}
+		if (error) {
+			error += chunk;
+		}
+		n -= chunk;
+	}
+}
+/* End of AdaptiveFilterPartRunBlock() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterPartWeights
+ *
+ * @param[in,out] pData    pointer to partitioned AdaptiveFilter
+ *  parameter/state struct
+ * @param[out]    pWeights Length time-domain weights, ordered as
+ *  AfData.pWeights (pWeights[0] multiplies the newest input)
+ *
+ * @returns       none
+ *
+ * @note          Transforms each partition's weights back to the time
+ *  domain. Uses the scratch buffers, so it must not run concurrently with
+ *  the filter.
+ *
+ * @warning       none
+ */
+void AdaptiveFilterPartWeights(AfPartData *pData, double *pWeights) {
+	const unsigned int blockSize = pData->BlockSize;
+	unsigned int i, p;
+
+	for ( p = 0; p < pData->Partitions; p++ ) {
+		AfFftInverse(&pData->Fft, pData->pWeights + p * (2 * blockSize + 2), pData->pTime);
+		for ( i = 0; i < blockSize; i++ ) {
+			pWeights[p * blockSize + i] = pData->pTime[i];
+		}
+	}
+}
+/* End of AdaptiveFilterPartWeights() */
+/******************************************************************************/
+
+/** internal functions **/
+
+/***************************************************************************//**
+* ProcessBlock
+*
+* @param[in,out] pData pointer to partitioned AdaptiveFilter parameter/state
+*  struct
+*
+* @returns       none
+*
+* @note          Pushes the completed block's spectrum into the delay line,
+*  filters, computes the errors and applies the constrained, per-partition
+*  normalized gradient (see the file header). 3 + 2 * Partitions real FFTs of
+*  size 2*BlockSize per block.
+*
+* @warning       none
+*******************************************************************************/
+static void ProcessBlock(AfPartData *pData) {
+	const unsigned int blockSize = pData->BlockSize;
+	const unsigned int partitions = pData->Partitions;
+	const unsigned int bins = 2 * blockSize + 2;
+	const AfFft *pFft = &pData->Fft;
+	const double lambda = (pData->Blocks == 0) ? 0.0 : pData->Forgetting;
+	const double mu = pData->StepSize / partitions;
+	const double *pX, *pW, *pPow, *pPrevPow;
+	double *pY = pData->pWork, *pE = pData->pWork, *pG = pData->pGradient;
+	double *pT = pData->pTime;
+	double *pXnew, *pPowNew, *pWp;
+	double xr, xi, er, ei, gain;
+	unsigned int i, k, p, slot, prev;
+
+	/* push the newest spectrum and its smoothed power into the delay line */
+	prev = pData->Head;
+	slot = (prev == 0 ? partitions : prev) - 1;
+	pData->Head = slot;
+	pXnew = pData->pSpectra + slot * bins;
+	pPowNew = pData->pPower + slot * (blockSize + 1);
+	pPrevPow = pData->pPower + prev * (blockSize + 1);
+	AfFftForward(pFft, pData->pInput, pXnew);
+	for ( k = 0; k <= blockSize; k++ ) {
+		xr = pXnew[2 * k];
+		xi = pXnew[2 * k + 1];
+		pPowNew[k] = lambda * pPrevPow[k] + (1.0 - lambda) * (xr * xr + xi * xi);
+	}
+
+	/* filter: sum of the partition products, then one inverse transform */
+	for ( k = 0; k < bins; k++ ) {
+		pY[k] = 0.0;
+	}
+	for ( p = 0, slot = pData->Head; p < partitions; p++ ) {
+		pX = pData->pSpectra + slot * bins;
+		pW = pData->pWeights + p * bins;
+		for ( k = 0; k <= blockSize; k++ ) {
+			pY[2 * k] += pX[2 * k] * pW[2 * k] - pX[2 * k + 1] * pW[2 * k + 1];
+			pY[2 * k + 1] += pX[2 * k] * pW[2 * k + 1] + pX[2 * k + 1] * pW[2 * k];
+		}
+		slot = (slot + 1 == partitions) ? 0 : slot + 1;
+	}
+	AfFftInverse(pFft, pY, pT);
+
+	for ( i = 0; i < blockSize; i++ ) {
+		pData->pOutput[i] = pT[blockSize + i];
+		pData->pErrorBlock[i] = pData->pDesired[i] - pT[blockSize + i];
+		pT[i] = 0.0;
+		pT[blockSize + i] = pData->pErrorBlock[i];
+	}
+	AfFftForward(pFft, pT, pE); /* E replaces Y in pWork */
+
+	/* per-partition normalized, constrained gradient */
+	for ( p = 0, slot = pData->Head; p < partitions; p++ ) {
+		pX = pData->pSpectra + slot * bins;
+		pPow = pData->pPower + slot * (blockSize + 1);
+		pWp = pData->pWeights + p * bins;
+
+		for ( k = 0; k <= blockSize; k++ ) {
+			gain = mu / (pPow[k] + pData->Regularization);
+			xr = pX[2 * k];
+			xi = pX[2 * k + 1];
+			er = pE[2 * k];
+			ei = pE[2 * k + 1];
+			pG[2 * k] = gain * (xr * er + xi * ei);
+			pG[2 * k + 1] = gain * (xr * ei - xi * er);
+		}
+		AfFftInverse(pFft, pG, pT);
+		for ( i = blockSize; i < 2 * blockSize; i++ ) {
+			pT[i] = 0.0;
+		}
+		AfFftForward(pFft, pT, pG);
+		for ( k = 0; k < bins; k++ ) {
+			pWp[k] += pG[k];
+		}
+
+		slot = (slot + 1 == partitions) ? 0 : slot + 1;
+	}
+
+	/* the current block becomes the previous one */
+	for ( i = 0; i < blockSize; i++ ) {
+		pData->pInput[i] = pData->pInput[blockSize + i];
+	}
+	pData->Fill = 0;
+	pData->Blocks++;
+}
+/* End of ProcessBlock()*/
+/******************************************************************************/
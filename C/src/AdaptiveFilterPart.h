@@ -0,0 +1,61 @@
+/*
+ * @file AdaptiveFilterPart.h
+ *
+ * Header file for AdaptiveFilterPart.c, the partitioned-block
+ * frequency-domain adaptive filter (PBFDAF / multi-delay filter): a long
+ * filter split into Partitions partitions of BlockSize taps, with a latency
+ * of BlockSize samples.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+#ifndef ADAPTIVEFILTERPART_H_
+#define ADAPTIVEFILTERPART_H_
+
+#include <stddef.h>
+#include "AfFft.h"
+
+#define AF_PART_FORGETTING (0.9) /* default per-bin power smoothing factor */
+
+/* Contains partitioned frequency-domain Adaptive Filter parameters
+ * (StepSize, Regularization, Forgetting, BlockSize, Partitions) and state
+ * info. Set up with AdaptiveFilterPartInit() in caller-provided memory;
+ * Forgetting may be changed after Init.
+ */
+typedef struct {
+	double StepSize; /* adaptive filter step size */
+	double Regularization; /* added to the smoothed power of every bin */
+	double Forgetting; /* power smoothing factor in [0,1) */
+	unsigned int Length; /* filter length, BlockSize * Partitions */
+	unsigned int BlockSize; /* partition size and latency, a power of two */
+	unsigned int Partitions; /* number of partitions */
+	AfFft Fft; /* real FFT of size 2*BlockSize */
+	double *pInput; /* 2*BlockSize: previous and current input block */
+	double *pDesired; /* BlockSize: desired samples of the current block */
+	double *pOutput; /* BlockSize: outputs of the last completed block */
+	double *pErrorBlock; /* BlockSize: errors of the last completed block */
+	double *pSpectra; /* Partitions input spectra of BlockSize+1 complex
+	                   * bins: the frequency-domain delay line */
+	double *pPower; /* Partitions x BlockSize+1 smoothed bin powers, one
+	                 * set per delay line spectrum */
+	double *pWeights; /* Partitions x BlockSize+1 complex bins */
+	double *pWork; /* BlockSize+1 complex bins: scratch spectrum */
+	double *pGradient; /* BlockSize+1 complex bins: scratch gradient */
+	double *pTime; /* 2*BlockSize: scratch time-domain block */
+	unsigned int Head; /* delay line slot of the newest spectrum */
+	unsigned int Fill; /* samples received in the current block */
+	unsigned long Blocks; /* number of completed blocks */
+	double Error; /* error of the sample whose output was returned last */
+} AfPartData;
+
+size_t AdaptiveFilterPartMemSize(unsigned int blockSize, unsigned int partitions);
+int AdaptiveFilterPartInit(AfPartData *pData, double stepSize,
+                           double regularization, unsigned int blockSize,
+                           unsigned int partitions, void *pMem);
+double AdaptiveFilterPartRun(double input, double desired, AfPartData *pData);
+void AdaptiveFilterPartRunBlock(const double *input, const double *desired,
+                                double *output, double *error, size_t n,
+                                AfPartData *pData);
+void AdaptiveFilterPartWeights(AfPartData *pData, double *pWeights);
+
+#endif /* ADAPTIVEFILTERPART_H_ */
@@ -0,0 +1,226 @@
+/*
+ * @file AdaptiveFilterProp.c
+ *
+ * Proportionate normalized LMS. The NLMS update is scaled per tap by a gain
+ * g that grows with the tap's weight magnitude:
+ *
+ *   e = d - w' x
+ *   w += StepSize * e * g .* x / (x' (g .* x) + Regularization)
+ *
+ * so the few large taps of a sparse response converge quickly while the
+ * many near-zero taps take small steps. PNLMS (Duttweiler) uses
+ * g = max(|w|, Rho * max(Delta, max |w|)); its gains are not normalized to
+ * a mean of 1, which the energy in the denominator cancels apart from the
+ * Regularization. IPNLMS (Benesty and Gay) mixes a uniform NLMS part and a
+ * proportionate part, g = (1-Alpha)/(2 Length) + (1+Alpha)|w|/(2 sum |w|),
+ * which behaves well on dispersive responses too.
+ *
+ * The gains and the gain-weighted energy come from one kernel pass, and the
+ * weight update returns the weight norms the next gains need, so the cost
+ * is three vector passes per sample against two for NLMS.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+/******************************************************************************/
+/* include block */
+#include "AdaptiveFilterProp.h"
+#include <float.h>
+
+/******************************************************************************/
+/** local definitions **/
+static const double *PushInput(double input, AfPropData *pData);
+
+/******************************************************************************
+ * AdaptiveFilterPropMemSize
+ *
+ * @param[in]     length filter length
+ *
+ * @returns       number of bytes AdaptiveFilterPropInit() needs in pMem
+ *
+ * @note          none
+ *
+ * @warning       none
+ */
+size_t AdaptiveFilterPropMemSize(unsigned int length) {
+	/* must match the carving in AdaptiveFilterPropInit() */
+	return 4 * (size_t)length * sizeof(double);
+}
+/* End of AdaptiveFilterPropMemSize() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterPropInit
+ *
+ * @param[out]    pData          pointer to proportionate AdaptiveFilter
+ *  parameter/state struct to initialize
+ * @param[in]     variant        AF_PROP_PNLMS or AF_PROP_IPNLMS
+ * @param[in]     stepSize       adaptive filter step size
+ * @param[in]     regularization added to the gain-weighted input energy
+ * @param[in]     length         filter length, at least 1
+ * @param[in]     pMem           AdaptiveFilterPropMemSize(length) bytes,
+ *  aligned for double
+ *
+ * @returns       0 on success, -1 if length is 0 or variant is unknown
+ *
+ * @note          Clears the filter state and weights and sets
+ *  Proportionality to AF_PROP_PNLMS_RHO or AF_PROP_IPNLMS_ALPHA.
+ *
+ * @warning       pMem must stay valid for as long as pData is used
+ */
+int AdaptiveFilterPropInit(AfPropData *pData, AfPropVariant variant,
+                           double stepSize, double regularization,
+                           unsigned int length, void *pMem) {
+	double *p = (double *)pMem;
+	size_t i, total;
+
+	if (length == 0 || (variant != AF_PROP_PNLMS && variant != AF_PROP_IPNLMS)) {
+		return -1;
+	}
+
+	pData->StepSize = stepSize;
+	pData->Regularization = regularization;
+	pData->Length = length;
+	pData->Variant = variant;
+	pData->Proportionality = (variant == AF_PROP_PNLMS) ? AF_PROP_PNLMS_RHO
+	                                                     : AF_PROP_IPNLMS_ALPHA;
+	pData->BufferIdx = 0;
+	pData->Norms[0] = 0.0;
+	pData->Norms[1] = 0.0;
+	pData->pKernels = AfKernelsGet(AF_ISA_AUTO);
+	pData->Error = 0.0;
+
+	pData->pBuffer = p;   p += 2 * length;
+	pData->pWeights = p;  p += length;
+	pData->pGain = p;     p += length;
+
+	total = (size_t)(p - (double *)pMem);
+	for ( i = 0; i < total; i++ ) {
+		((double *)pMem)[i] = 0.0;
+	}
+
+	return 0;
+}
+/* End of AdaptiveFilterPropInit() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterPropRun
+ *
+ * @param[in]     input  input signal sample
+ * @param[in]     desired desired signal sample
+ * @param[in,out] pData  pointer to proportionate AdaptiveFilter
+ *  parameter/state struct
+ *
+ * @returns       adaptive filter output (estimate of desired signal)
+ *
+ * @note          Filters the input and applies the proportionate update.
+ *  pData->Error is the error of this sample.
+ *
+ * @warning       none
+ */
+double AdaptiveFilterPropRun(double input, double desired, AfPropData *pData) {
+	const unsigned int length = pData->Length;
+	const AfKernels *pK;
+	const double *pX;
+	double output, offset, scale, floor, energy, peak;
+
+	if (!pData->pKernels) {
+		pData->pKernels = AfKernelsGet(AF_ISA_AUTO); /* select SIMD kernels on first use */
+	}
+	pK = pData->pKernels;
+
+	pX = PushInput(input, pData);
+	output = pK->Dot(pData->pWeights, pX, length);
+	pData->Error = desired - output;
+
+	if (pData->Variant == AF_PROP_IPNLMS) {
+		offset = (1.0 - pData->Proportionality) / (2.0 * length);
+		scale = (1.0 + pData->Proportionality) / (2.0 * pData->Norms[0] + DBL_MIN);
+		floor = 0.0;
+	}
+	else {
+		peak = pData->Norms[1];
+		offset = 0.0;
+		scale = 1.0;
+		floor = pData->Proportionality * ((peak > AF_PROP_PNLMS_DELTA) ? peak : AF_PROP_PNLMS_DELTA);
+	}
+	energy = pK->PropGain(pData->pGain, pData->pWeights, pX, offset, scale, floor, length);
+
+	pK->PropUpdate(pData->pWeights, pData->StepSize * pData->Error / (energy + pData->Regularization),
+	               pData->pGain, pX, length, pData->Norms);
+
+	return output;
+}
+/* End of AdaptiveFilterPropRun() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterPropRunBlock
+ *
+ * @param[in]     input   block of n input signal samples
+ * @param[in]     desired block of n desired signal samples
+ * @param[out]    output  block of n adaptive filter outputs (may be NULL)
+ * @param[out]    error   block of n errors, desired - output (may be NULL)
+ * @param[in]     n       number of samples in the block
+ * @param[in,out] pData   pointer to proportionate AdaptiveFilter
+ *  parameter/state struct
+ *
+ * @returns       none
+ *
+ * @note          Same results as calling AdaptiveFilterPropRun() once per
+ *  sample.
+ *
+ * @warning       input and desired must not alias output or error
+ */
+void AdaptiveFilterPropRunBlock(const double *input, const double *desired,
+                                double *output, double *error, size_t n,
+                                AfPropData *pData) {
+	double y;
+	size_t i;
+
+	for ( i = 0; i < n; i++ ) {
+		y = AdaptiveFilterPropRun(input[i], desired[i], pData);
+		if (output) {
+			output[i] = y;
+		}
+		if (error) {
+			error[i] = pData->Error;
+		}
+	}
+}
+/* End of AdaptiveFilterPropRunBlock() */
+/******************************************************************************/
+
+/** internal functions **/
+
+/***************************************************************************//**
+* PushInput
+*
+* @param[in]     input new input sample
+* @param[in,out] pData pointer to proportionate AdaptiveFilter
+*  parameter/state struct
+*
+* @returns       the Length newest inputs, newest first, contiguous
+*
+* @note          Mirrored delay line as in AdaptiveFilter.c.
+*
+* @warning       none
+*******************************************************************************/
+static const double *PushInput(double input, AfPropData *pData) {
+	unsigned int idx = pData->BufferIdx;
+
+	/* wrap index */
+	if (idx == 0) {
+		idx = pData->Length;
+	}
+	idx--;
+
+	pData->pBuffer[idx] = input;
+	pData->pBuffer[idx + pData->Length] = input;
+	pData->BufferIdx = idx;
+
+	return pData->pBuffer + idx;
+}
+/* End of PushInput()*/
+/******************************************************************************/
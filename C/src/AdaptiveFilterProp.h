@@ -0,0 +1,60 @@
+/*
+ * @file AdaptiveFilterProp.h
+ *
+ * Header file for AdaptiveFilterProp.c, proportionate NLMS adaptive filters
+ * (PNLMS and IPNLMS) that give each tap a step proportional to its weight
+ * magnitude, for long but sparse impulse responses such as echo paths.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+#ifndef ADAPTIVEFILTERPROP_H_
+#define ADAPTIVEFILTERPROP_H_
+
+#include <stddef.h>
+#include "AfKernels.h"
+
+#define AF_PROP_IPNLMS_ALPHA (-0.5) /* IPNLMS default: -1 is NLMS, towards 1
+                                     * is more proportionate */
+#define AF_PROP_PNLMS_RHO (0.01) /* PNLMS default: smallest tap gain relative
+                                  * to the largest weight */
+#define AF_PROP_PNLMS_DELTA (0.01) /* PNLMS: weight magnitude below which all
+                                    * taps get the same gain (startup) */
+
+/* proportionate gain rules */
+typedef enum {
+	AF_PROP_PNLMS = 0, /* gain max(|w|, Rho * max(Delta, max |w|)) */
+	AF_PROP_IPNLMS /* gain (1-Alpha)/(2 Length) + (1+Alpha) |w| / (2 sum |w|) */
+} AfPropVariant;
+
+/* Contains proportionate Adaptive Filter parameters (StepSize,
+ * Regularization, Length, Variant, Proportionality) and state info. Set up
+ * with AdaptiveFilterPropInit() in caller-provided memory; Proportionality
+ * may be changed after Init.
+ */
+typedef struct {
+	double StepSize; /* adaptive filter step size */
+	double Regularization; /* added to the gain-weighted input energy */
+	unsigned int Length; /* filter length */
+	AfPropVariant Variant; /* gain rule */
+	double Proportionality; /* IPNLMS: Alpha in [-1,1); PNLMS: Rho */
+	double *pBuffer; /* mirrored delay line, 2*Length samples */
+	unsigned int BufferIdx; /* index of newest sample in pBuffer */
+	double *pWeights; /* Length adaptive filter weights */
+	double *pGain; /* Length per-tap gains of the last update */
+	double Norms[2]; /* sum and max of |weights| after the last update */
+	const AfKernels *pKernels; /* vector kernels, NULL: best for the host,
+	                            * selected on first use (see AfKernelsGet) */
+	double Error; /* error of the newest sample (desired - output) */
+} AfPropData;
+
+size_t AdaptiveFilterPropMemSize(unsigned int length);
+int AdaptiveFilterPropInit(AfPropData *pData, AfPropVariant variant,
+                           double stepSize, double regularization,
+                           unsigned int length, void *pMem);
+double AdaptiveFilterPropRun(double input, double desired, AfPropData *pData);
+void AdaptiveFilterPropRunBlock(const double *input, const double *desired,
+                                double *output, double *error, size_t n,
+                                AfPropData *pData);
+
+#endif /* ADAPTIVEFILTERPROP_H_ */
@@ -0,0 +1,275 @@
+/*
+ * @file AdaptiveFilterQ15.c
+ *
+ * Fixed-point normalized least-mean-square adaptive filter for targets where
+ * integer arithmetic beats floating point. Samples are Q15, weights Q31 and
+ * inner products accumulate in 64 bits. The normalization
+ * StepSize / (Regularization + Energy) uses block floating point: the
+ * denominator is split into a Q31 mantissa and a shift, and the mantissa is
+ * inverted with Newton-Raphson iterations instead of a division.
+ *
+ * Every narrowing step saturates rather than wraps, and the clipped results
+ * are counted in AfDataQ15.Saturations. The per-tap loops are branch-free
+ * (clamps are written as selects) so compilers can vectorize them.
+ *
+ * Right shifts of negative values assume arithmetic shifts, as on every
+ * supported compiler and target.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+/******************************************************************************/
+/* include block */
+#include "AdaptiveFilterQ15.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define NEWTON_ITERATIONS (3) /* 4-bit initial guess -> 32 bits */
+
+static void AdaptWeights(AfDataQ15 *pData);
+static int16_t Filter(int16_t input, AfDataQ15 *pData);
+static int16_t Saturate16(int64_t x, AfDataQ15 *pData);
+static int64_t ReciprocalQ30(int64_t mantissa);
+
+/******************************************************************************
+ * AdaptiveFilterRunQ15
+ *
+ * @param[in]     input  input signal sample, Q15
+ * @param[in]     desired desired signal sample, Q15
+ * @param[in,out] pData  pointer to fixed-point AdaptiveFilter parameter/state
+ *  struct
+ *
+ * @returns       adaptive filter output (estimate of desired signal), Q15
+ *
+ * @note          Runs the fixed-point normalized least mean square adaptive
+ *  filter and computes a new output.
+ *
+ * @warning       Length must not exceed 2^17 taps so the 64-bit inner
+ *  product cannot overflow.
+ */
+int16_t AdaptiveFilterRunQ15(int16_t input, int16_t desired, AfDataQ15 *pData) {
+	int16_t output;
+
+	output = Filter(input, pData); /* filter the input */
+	pData->Error = Saturate16((int32_t)desired - output, pData); /* update the error */
+	AdaptWeights(pData); /* update adaptive filter weights */
+
+	return output;
+}
+/* End of AdaptiveFilterRunQ15() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AdaptiveFilterRunBlockQ15
+ *
+ * @param[in]     input   block of n input signal samples, Q15
+ * @param[in]     desired block of n desired signal samples, Q15
+ * @param[out]    output  block of n adaptive filter outputs (may be NULL)
+ * @param[out]    error   block of n errors, desired - output (may be NULL)
+ * @param[in]     n       number of samples in the block
+ * @param[in,out] pData   pointer to fixed-point AdaptiveFilter
+ *  parameter/state struct
+ *
+ * @returns       none
+ *
+ * @note          Block form of AdaptiveFilterRunQ15(), bit-exact with the
+ *  per-sample calls.
+ *
+ * @warning       input and desired must not alias output or error
+ */
+void AdaptiveFilterRunBlockQ15(const int16_t *input, const int16_t *desired,
+                               int16_t *output, int16_t *error, size_t n,
+                               AfDataQ15 *pData) {
+	int16_t y;
+	size_t i;
+
+	for ( i = 0; i < n; i++ ) {
+		y = Filter(input[i], pData);
+		pData->Error = Saturate16((int32_t)desired[i] - y, pData);
+		AdaptWeights(pData);
+
+		if (output) {
+			output[i] = y;
+		}
+		if (error) {
+			error[i] = pData->Error;
+		}
+	}
+}
+/* End of AdaptiveFilterRunBlockQ15() */
+/******************************************************************************/
+
+/** internal functions **/
+
+/***************************************************************************//**
+* AdaptWeights
+*
+* @param[in,out] pData pointer to fixed-point AdaptiveFilter parameter/state
+*  struct
+*
+* @returns       none
+*
+* @note          Updates the Q31 weights with
+*  w[i] += StepSize * Error * x[i] / (Regularization + Energy).
+*  The denominator D (Q30) is normalized to mantissa * 2^-shift with the
+*  mantissa in [2^30, 2^31), so the gain becomes
+*  StepSize * Error * (1/mantissa) followed by one shift per tap.
+*
+* @warning       none
+*******************************************************************************/
+static void AdaptWeights(AfDataQ15 *pData) {
+	const int16_t *pX = pData->pBuffer + pData->BufferIdx;
+	int32_t *pW = pData->pWeights;
+	int64_t denominator, mantissa, gain, delta, sum, clipped;
+	int64_t roundBit;
+	int shift = 0, tapShift;
+	unsigned long saturations = 0;
+	unsigned int i;
+
+	if (pData->Error == 0) {
+		return; /* nothing to learn */
+	}
+
+	/* block floating point: denominator = mantissa * 2^-shift */
+	denominator = pData->Regularization + pData->Energy;
+	if (denominator <= 0) {
+		denominator = 1;
+	}
+	mantissa = denominator;
+	while (mantissa >= ((int64_t)1 << 31)) {
+		mantissa >>= 1;
+		shift--;
+	}
+	while (mantissa < ((int64_t)1 << 30)) {
+		mantissa <<= 1;
+		shift++;
+	}
+
+	/* StepSize (Q31) * Error (Q15) -> Q31, then times 1/mantissa (Q30) -> Q31 */
+	gain = ((int64_t)pData->StepSize * pData->Error) >> 15;
+	gain = (gain * ReciprocalQ30(mantissa)) >> 30;
+
+	/* Q31 weight delta = gain * x(Q15) * 2^(shift - 16), see derivation above */
+	tapShift = 16 - shift;
+	if (tapShift < 0) {
+		/* tiny denominator: the true step would overflow, clip the gain */
+		gain = (gain > 0) ? ((int64_t)1 << 47) : -((int64_t)1 << 47);
+		tapShift = 0;
+		pData->Saturations++;
+	}
+	roundBit = (tapShift > 0) ? ((int64_t)1 << (tapShift - 1)) : 0;
+
+	for ( i = 0; i < pData->Length; i++ ) {
+		delta = (gain * pX[i] + roundBit) >> tapShift;
+		sum = (int64_t)pW[i] + delta;
+		clipped = (sum > INT32_MAX) ? INT32_MAX : ((sum < INT32_MIN) ? INT32_MIN : sum);
+		saturations += (clipped != sum);
+		pW[i] = (int32_t)clipped;
+	}
+	pData->Saturations += saturations;
+}
+/* End of AdaptWeights()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Filter
+*
+* @param[in]     input input signal sample, Q15
+* @param[in,out] pData pointer to fixed-point AdaptiveFilter parameter/state
+*  struct
+*
+* @returns       new filter output, Q15
+*
+* @note          Writes the input to the mirrored delay line, updates the
+*  input energy exactly (add newest^2, subtract oldest^2; integer arithmetic
+*  cannot drift) and accumulates the Q31 x Q15 products in 64 bits.
+*
+* @warning       none
+*******************************************************************************/
+static int16_t Filter(int16_t input, AfDataQ15 *pData) {
+	const int32_t *pW = pData->pWeights;
+	const int16_t *pX;
+	int64_t acc = 0;
+	int16_t oldest;
+	unsigned int i, idx = pData->BufferIdx;
+
+	/* wrap index */
+	if (idx == 0 || idx > pData->Length) {
+		idx = pData->Length;
+	}
+	idx--;
+
+	/* overwrite oldest input with new input (and its mirror) */
+	oldest = pData->pBuffer[idx];
+	pData->pBuffer[idx] = input;
+	pData->pBuffer[idx + pData->Length] = input;
+	pData->BufferIdx = idx;
+	pData->Energy += (int32_t)input * input - (int32_t)oldest * oldest;
+
+	/* compute inner product of weight vector and buffer, Q46 */
+	pX = pData->pBuffer + idx;
+	for ( i = 0; i < pData->Length; i++ ) {
+		acc += (int64_t)pW[i] * pX[i];
+	}
+
+	return Saturate16((acc + ((int64_t)1 << 30)) >> 31, pData); /* round to Q15 */
+}
+/* End of Filter()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Saturate16
+*
+* @param[in]     x value to narrow
+* @param[in,out] pData pointer to fixed-point AdaptiveFilter parameter/state
+*  struct, whose saturation count is incremented when x is clipped
+*
+* @returns       x clipped to the int16_t range
+*
+* @note          none
+*
+* @warning       none
+*******************************************************************************/
+static int16_t Saturate16(int64_t x, AfDataQ15 *pData) {
+	if (x > INT16_MAX) {
+		pData->Saturations++;
+		return INT16_MAX;
+	}
+	if (x < INT16_MIN) {
+		pData->Saturations++;
+		return INT16_MIN;
+	}
+	return (int16_t)x;
+}
+/* End of Saturate16()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* ReciprocalQ30
+*
+* @param[in]     mantissa Q31 value m in [0.5, 1), i.e. [2^30, 2^31)
+*
+* @returns       1/m in Q30, in (2^30, 2^31]
+*
+* @note          Starts from the minimax linear guess 48/17 - 32/17 * m
+*  (about 4 correct bits) and applies NEWTON_ITERATIONS steps of
+*  r = r * (2 - m * r), each doubling the number of correct bits.
+*
+* @warning       none
+*******************************************************************************/
+static int64_t ReciprocalQ30(int64_t mantissa) {
+	const int64_t c48over17 = 3031741621LL; /* 48/17 in Q30 */
+	const int64_t c32over17 = 2021161081LL; /* 32/17 in Q30 */
+	int64_t r, mr;
+	int i;
+
+	r = c48over17 - ((c32over17 * mantissa) >> 31);
+	for ( i = 0; i < NEWTON_ITERATIONS; i++ ) {
+		mr = (mantissa * r) >> 31; /* m * r in Q30 */
+		r = (r * (((int64_t)2 << 30) - mr)) >> 30;
+	}
+
+	return r;
+}
+/* End of ReciprocalQ30()*/
+/******************************************************************************/
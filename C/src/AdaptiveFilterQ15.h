@@ -0,0 +1,46 @@
+/*
+ * @file AdaptiveFilterQ15.h
+ *
+ * Header file for AdaptiveFilterQ15.c, the fixed-point counterpart of
+ * AdaptiveFilter.h: Q15 input, desired, output and error samples, Q31
+ * weights and 64-bit accumulators.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+#ifndef ADAPTIVEFILTERQ15_H_
+#define ADAPTIVEFILTERQ15_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* conversions between real values in [-1,1) and the fixed-point formats,
+ * rounding to nearest */
+#define AF_Q15(x) ((int16_t)((x) * 32768.0 + ((x) < 0 ? -0.5 : 0.5)))
+#define AF_Q31(x) ((int32_t)((x) * 2147483648.0 + ((x) < 0 ? -0.5 : 0.5)))
+#define AF_Q15_TO_DOUBLE(q) ((double)(q) / 32768.0)
+#define AF_Q31_TO_DOUBLE(q) ((double)(q) / 2147483648.0)
+
+/* Contains fixed-point Adaptive Filter parameters (StepSize,Regularization,
+ * Length) and state info (Buffer, BufferIdx, Weights, Error, Energy and the
+ * saturation count). The delay line always uses the mirrored layout.
+ */
+typedef struct {
+	const int32_t StepSize; /* adaptive filter step size, Q31 */
+	const int64_t Regularization; /* regularization constant, Q30 (units of Energy) */
+	const unsigned int Length; /* length of filter */
+	int16_t *pBuffer; /* pointer to input buffer, 2*Length Q15 samples */
+	unsigned int BufferIdx; /* index of newest sample in input buffer */
+	int32_t *pWeights; /* pointer to adaptive filter weights, Q31 */
+	int16_t Error; /* output error (desired - output) state, Q15 */
+	int64_t Energy; /* squared norm of the input vector, Q30; kept
+	                 * recursively in exact integer arithmetic */
+	unsigned long Saturations; /* count of results clipped to their format */
+} AfDataQ15;
+
+int16_t AdaptiveFilterRunQ15(int16_t input, int16_t desired, AfDataQ15 *pData);
+void AdaptiveFilterRunBlockQ15(const int16_t *input, const int16_t *desired,
+                               int16_t *output, int16_t *error, size_t n,
+                               AfDataQ15 *pData);
+
+#endif /* ADAPTIVEFILTERQ15_H_ */
@@ -0,0 +1,623 @@
+/*
+ * @file AdaptiveFilterScenario.c
+ *
+ * System-identification test scenario:
+ *   1. Creates a fixed test filter from the scenario's random generator
+ *   2. Generates a random input signal on (-1,1) and the desired signal as
+ *      the test filter output
+ *   3. Runs the adaptive filter to identify the test filter weights
+ *   4. Tracks squared error and misalignment, optionally writing them to a
+ *      metrics file or printing every iteration
+ *   5. Checks the final values against the scenario's thresholds
+ *
+ * Nothing here is static, so scenarios with different parameters can run
+ * concurrently; AfScenarioRunMany() does so on a set of threads.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+/******************************************************************************/
+/* include block */
+#include "AdaptiveFilterScenario.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************/
+/** local definitions **/
+#define SCENARIO_FIELDS (2) /* squared error and misalignment per iteration */
+#define SCENARIO_MAX_THREADS (64) /* most threads AfScenarioRunMany() starts */
+#define SCENARIO_PATH (4096) /* longest metrics file name */
+
+/* Shared by the AfScenarioRunMany() workers */
+typedef struct {
+	AfScenario *pScenarios;
+	unsigned int Count;
+	const AfTestOptions *pOptions;
+	atomic_uint Next; /* next scenario to run */
+} ScenarioQueue;
+
+static const char *const metricsNames[SCENARIO_FIELDS] = {
+	"squared_error_db", "misalignment_db"
+};
+
+static void *ScenarioWorker(void *pArg);
+static void RunIndexed(AfScenario *pScenario, unsigned int index,
+                       unsigned int count, const AfTestOptions *pOptions);
+
+/******************************************************************************
+ * AfScenarioDefaults
+ *
+ * @param[out]    pParams parameters to fill with the AF_SCENARIO_* defaults
+ *
+ * @returns       none
+ *
+ * @note          none
+ *
+ * @warning       none
+ */
+void AfScenarioDefaults(AfScenarioParams *pParams) {
+	pParams->Taps = AF_SCENARIO_TAPS;
+	pParams->StepSize = AF_SCENARIO_STEPSIZE;
+	pParams->Regularization = AF_SCENARIO_REGULARIZATION;
+	pParams->Iterations = AF_SCENARIO_ITERATIONS;
+	pParams->Seed = AF_SCENARIO_SEED;
+	pParams->MisalignmentThresh = AF_SCENARIO_MISALIGNMENT_THRESH;
+	pParams->SquaredErrorThresh = AF_SCENARIO_SQUARED_ERROR_THRESH;
+	pParams->ConvergenceThresh = AF_SCENARIO_CONVERGENCE_THRESH;
+}
+/* End of AfScenarioDefaults() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfScenarioParse
+ *
+ * @param[in,out] pParams parameters to override
+ * @param[in]     pSpec   comma-separated key=value list, keys: taps, step,
+ *  reg, iterations, seed, misalignment, error, convergence (the last three
+ *  thresholds in dB)
+ *
+ * @returns       0 on success, -1 on an unknown key or a malformed value
+ *
+ * @note          Keys not in the list keep their value, so a spec can be
+ *  applied on top of AfScenarioDefaults().
+ *
+ * @warning       none
+ */
+int AfScenarioParse(AfScenarioParams *pParams, const char *pSpec) {
+	char key[32];
+	const char *pValue, *pEnd;
+	char *pParsed;
+	double value;
+	size_t keyLength;
+
+	while (*pSpec) {
+		pValue = strchr(pSpec, '=');
+		pEnd = strchr(pSpec, ',');
+		if (!pEnd) {
+			pEnd = pSpec + strlen(pSpec);
+		}
+		if (!pValue || pValue > pEnd || (size_t)(pValue - pSpec) >= sizeof(key)) {
+			return -1;
+		}
+		keyLength = (size_t)(pValue - pSpec);
+		memcpy(key, pSpec, keyLength);
+		key[keyLength] = '\0';
+		value = strtod(pValue + 1, &pParsed);
+		if (pParsed != pEnd || pParsed == pValue + 1) {
+			return -1;
+		}
+
+		if (strcmp(key, "taps") == 0 && value >= 1) {
+			pParams->Taps = (unsigned int)value;
+		}
+		else if (strcmp(key, "step") == 0 && value > 0) {
+			pParams->StepSize = value;
+		}
+		else if (strcmp(key, "reg") == 0 && value >= 0) {
+			pParams->Regularization = value;
+		}
+		else if (strcmp(key, "iterations") == 0 && value >= 1) {
+			pParams->Iterations = (unsigned int)value;
+		}
+		else if (strcmp(key, "seed") == 0 && value >= 0) {
+			pParams->Seed = (unsigned int)value;
+		}
+		else if (strcmp(key, "misalignment") == 0) {
+			pParams->MisalignmentThresh = value;
+		}
+		else if (strcmp(key, "error") == 0) {
+			pParams->SquaredErrorThresh = value;
+		}
+		else if (strcmp(key, "convergence") == 0) {
+			pParams->ConvergenceThresh = value;
+		}
+		else {
+			return -1;
+		}
+		pSpec = (*pEnd == ',') ? pEnd + 1 : pEnd;
+	}
+
+	return 0;
+}
+/* End of AfScenarioParse() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfScenarioInit
+ *
+ * @param[out]    pScenario scenario to set up
+ * @param[in]     pParams   scenario parameters
+ *
+ * @returns       0 on success, -1 if a parameter is out of range or the
+ *  memory cannot be allocated
+ *
+ * @note          Seeds the random generator and draws the test filter
+ *  weights from it, so equal parameters give equal runs.
+ *
+ * @warning       Release with AfScenarioDestroy()
+ */
+int AfScenarioInit(AfScenario *pScenario, const AfScenarioParams *pParams) {
+	const AfData config = {
+		.StepSize = pParams->StepSize,
+		.Regularization = pParams->Regularization,
+		.Length = pParams->Taps
+	};
+	size_t bytes;
+	unsigned int i;
+
+	memset(pScenario, 0, sizeof(*pScenario));
+	if (pParams->Taps == 0 || pParams->Iterations == 0 || !(pParams->StepSize > 0.0)) {
+		return -1;
+	}
+	pScenario->Params = *pParams;
+	pScenario->Rng = pParams->Seed;
+	pScenario->ConvergenceLinear = pow(10.0, pParams->ConvergenceThresh / 10);
+
+	bytes = AdaptiveFilterArenaSize(1, &config) +
+	        2 * (pParams->Taps * sizeof(double) + AF_ARENA_ALIGN) +
+	        AfMetricsMemSize(SCENARIO_FIELDS, AF_SCENARIO_METRICS_RECORDS) + AF_ARENA_ALIGN;
+	if (AfArenaInit(&pScenario->Arena, bytes, 0) != 0) {
+		return -1;
+	}
+	pScenario->pData = AdaptiveFilterCreate(&pScenario->Arena, &config);
+	pScenario->pTestWeights = (double *)AfArenaAlloc(&pScenario->Arena, pParams->Taps * sizeof(double));
+	pScenario->pTestBuffer = (double *)AfArenaAlloc(&pScenario->Arena, pParams->Taps * sizeof(double));
+	pScenario->pMetricsMem = AfArenaAlloc(&pScenario->Arena,
+	                                      AfMetricsMemSize(SCENARIO_FIELDS, AF_SCENARIO_METRICS_RECORDS));
+	if (!pScenario->pData || !pScenario->pTestWeights || !pScenario->pTestBuffer ||
+	    !pScenario->pMetricsMem) {
+		AfArenaDestroy(&pScenario->Arena);
+		return -1;
+	}
+
+	for ( i = 0; i < pParams->Taps; i++ ) {
+		/* initialize using random numbers on the interval (-1,1) */
+		pScenario->pTestWeights[i] = AfScenarioRandom(pScenario);
+		pScenario->pTestBuffer[i] = 0.0;
+	}
+
+	return 0;
+}
+/* End of AfScenarioInit() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfScenarioDestroy
+ *
+ * @param[in,out] pScenario scenario set up by AfScenarioInit()
+ *
+ * @returns       none
+ *
+ * @note          Results stay readable; the arrays and pData do not.
+ *
+ * @warning       none
+ */
+void AfScenarioDestroy(AfScenario *pScenario) {
+	AfArenaDestroy(&pScenario->Arena);
+	pScenario->pData = NULL;
+	pScenario->pTestWeights = NULL;
+	pScenario->pTestBuffer = NULL;
+	pScenario->pMetricsMem = NULL;
+}
+/* End of AfScenarioDestroy() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfScenarioRandom
+ *
+ * @param[in,out] pScenario scenario whose generator to advance
+ *
+ * @returns       uniform random number on [-1,1)
+ *
+ * @note          splitmix64: reentrant, and nearby seeds give unrelated
+ *  sequences.
+ *
+ * @warning       none
+ */
+double AfScenarioRandom(AfScenario *pScenario) {
+	uint64_t z = (pScenario->Rng += 0x9E3779B97F4A7C15ull);
+
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	z ^= z >> 31;
+
+	return 2 * ((double)(z >> 11) * (1.0 / 9007199254740992.0)) - 1;
+}
+/* End of AfScenarioRandom() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfScenarioNext
+ *
+ * @param[in,out] pScenario scenario
+ * @param[out]    pDesired  test filter output for the new input
+ *
+ * @returns       new random input sample
+ *
+ * @note          Advances only the signals, not the adaptive filter, so
+ *  other filters can be run on them.
+ *
+ * @warning       none
+ */
+double AfScenarioNext(AfScenario *pScenario, double *pDesired) {
+	const unsigned int taps = pScenario->Params.Taps;
+	double input = AfScenarioRandom(pScenario), output = 0;
+	unsigned int idx = pScenario->TestBufferIdx;
+	int i;
+
+	if (idx >= taps) {
+		idx = 0;
+	}
+	pScenario->pTestBuffer[idx++] = input;
+	pScenario->TestBufferIdx = idx;
+
+	for ( i = (int)taps - 1; i >= 0; i--) {
+		if (idx >= taps) {
+			idx = 0;
+		}
+		output += pScenario->pTestWeights[i] * pScenario->pTestBuffer[idx++];
+	}
+	*pDesired = output;
+
+	return input;
+}
+/* End of AfScenarioNext() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfScenarioStep
+ *
+ * @param[in,out] pScenario scenario
+ * @param[out]    pDesired  desired sample of this iteration
+ *
+ * @returns       input sample of this iteration
+ *
+ * @note          Runs one iteration: new signals, one adaptive filter
+ *  update and the linear metrics, which are recorded or printed as set up
+ *  by AfScenarioBegin(). The convergence check compares linear values, so
+ *  no log10() runs here unless printing. Once converged, misalignment is
+ *  only computed for samples the recorder, the printout or the caller
+ *  (Decimation, see Kept) keeps.
+ *
+ * @warning       none
+ */
+double AfScenarioStep(AfScenario *pScenario, double *pDesired) {
+	double input = AfScenarioNext(pScenario, pDesired), metrics[SCENARIO_FIELDS];
+	int record = pScenario->pMetricsFile && AfMetricsKeepsNext(&pScenario->Recorder);
+
+	AdaptiveFilterRun(input, *pDesired, pScenario->pData);
+	pScenario->Iteration++;
+	pScenario->SquaredError = pScenario->pData->Error * pScenario->pData->Error;
+	pScenario->Kept = pScenario->Decimation && pScenario->Iteration % pScenario->Decimation == 0;
+	if (!pScenario->Converged || record || pScenario->Kept || pScenario->Verbose) {
+		pScenario->Misalignment = AfScenarioMisalignment(pScenario, pScenario->pData->pWeights,
+		                                                 pScenario->Params.Taps);
+	}
+	if (!pScenario->Converged && AF_METRICS_DB_EPSILON + pScenario->Misalignment < pScenario->ConvergenceLinear) {
+		pScenario->Converged = pScenario->Iteration;
+	}
+
+	if (pScenario->pMetricsFile) {
+		metrics[0] = pScenario->SquaredError;
+		metrics[1] = pScenario->Misalignment;
+		AfMetricsRecord(&pScenario->Recorder, metrics); /* writes a batch when full */
+	}
+	if (pScenario->Verbose) {
+		AfScenarioPrintIteration(pScenario);
+	}
+
+	return input;
+}
+/* End of AfScenarioStep() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfScenarioMisalignment
+ *
+ * @param[in]     pScenario scenario
+ * @param[in]     pWeights  adaptive filter weights
+ * @param[in]     length    number of weights, at least Taps
+ *
+ * @returns       filter weight misalignment
+ *
+ * @note          Computes filter weight misalignment between the test filter
+ *  and the adaptive filter, normalized by the squared L2-norm of the test
+ *  filter: (||Wtest - Wadaptive||^2) / (||Wtest||^2). Weights beyond Taps,
+ *  as in the frequency-domain filters, are compared against zero.
+ *
+ * @warning       none
+ */
+double AfScenarioMisalignment(const AfScenario *pScenario, const double *pWeights,
+                              unsigned int length) {
+	const unsigned int taps = pScenario->Params.Taps;
+	double difference, diffSqrdNorm = 0.0, testSqrdNorm = 0.0;
+	unsigned int i;
+
+	for ( i = 0; i < length; i++) {
+		difference = (i < taps ? pScenario->pTestWeights[i] : 0.0) - pWeights[i];
+
+		/* accumulate squared terms */
+		diffSqrdNorm += difference * difference;
+		testSqrdNorm += (i < taps ? pScenario->pTestWeights[i] * pScenario->pTestWeights[i] : 0.0);
+	}
+
+	return ( diffSqrdNorm / testSqrdNorm ); /* return normalized misalignment */
+}
+/* End of AfScenarioMisalignment() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfScenarioPrintIteration
+ *
+ * @param[in]     pScenario scenario
+ *
+ * @returns       none
+ *
+ * @note          Prints the latest metrics in dB with a single printf(), so
+ *  concurrent scenarios do not split each other's lines.
+ *
+ * @warning       none
+ */
+void AfScenarioPrintIteration(const AfScenario *pScenario) {
+	printf("Iteration: %u\nMisalignment (dB): %f\nSquared error (dB): %f\n",
+	       pScenario->Iteration,
+	       10 * log10( AF_METRICS_DB_EPSILON + pScenario->Misalignment ),
+	       10 * log10( AF_METRICS_DB_EPSILON + pScenario->SquaredError ));
+}
+/* End of AfScenarioPrintIteration() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfScenarioBegin
+ *
+ * @param[in,out] pScenario scenario set up by AfScenarioInit()
+ * @param[in]     pOptions  output options, NULL: results only
+ *
+ * @returns       none
+ *
+ * @note          Opens the metrics file, if any, for AfScenarioStep(). A
+ *  file that cannot be opened sets MetricsFailed and the run goes on.
+ *
+ * @warning       none
+ */
+void AfScenarioBegin(AfScenario *pScenario, const AfTestOptions *pOptions) {
+	pScenario->Verbose = pOptions && pOptions->Verbose;
+	pScenario->pMetricsFile = NULL;
+	if (!pOptions || !pOptions->pMetricsPath) {
+		return;
+	}
+
+	pScenario->pMetricsFile = fopen(pOptions->pMetricsPath,
+	                                (pOptions->Format == AF_METRICS_BINARY) ? "wb" : "w");
+	if (!pScenario->pMetricsFile ||
+	    AfMetricsInit(&pScenario->Recorder, SCENARIO_FIELDS, AF_SCENARIO_METRICS_RECORDS,
+	                  pOptions->Decimation, pOptions->Format, pScenario->pMetricsFile,
+	                  metricsNames, pScenario->pMetricsMem) != 0) {
+		pScenario->MetricsFailed = 1;
+		if (pScenario->pMetricsFile) {
+			fclose(pScenario->pMetricsFile);
+			pScenario->pMetricsFile = NULL;
+		}
+	}
+}
+/* End of AfScenarioBegin() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfScenarioEnd
+ *
+ * @param[in,out] pScenario scenario after its last AfScenarioStep()
+ *
+ * @returns       none
+ *
+ * @note          Writes the last metrics batch and closes the file, then
+ *  brings Misalignment up to date and sets SquaredErrorDb, MisalignmentDb
+ *  and Passed.
+ *
+ * @warning       none
+ */
+void AfScenarioEnd(AfScenario *pScenario) {
+	if (pScenario->pMetricsFile) {
+		if (AfMetricsFlush(&pScenario->Recorder) != 0) {
+			pScenario->MetricsFailed = 1;
+		}
+		if (fclose(pScenario->pMetricsFile) != 0) {
+			pScenario->MetricsFailed = 1;
+		}
+		pScenario->pMetricsFile = NULL;
+	}
+	pScenario->Misalignment = AfScenarioMisalignment(pScenario, pScenario->pData->pWeights,
+	                                                 pScenario->Params.Taps);
+	pScenario->SquaredErrorDb = 10 * log10( AF_METRICS_DB_EPSILON + pScenario->SquaredError );
+	pScenario->MisalignmentDb = 10 * log10( AF_METRICS_DB_EPSILON + pScenario->Misalignment );
+	pScenario->Passed = pScenario->MisalignmentDb <= pScenario->Params.MisalignmentThresh &&
+	                    pScenario->SquaredErrorDb <= pScenario->Params.SquaredErrorThresh;
+}
+/* End of AfScenarioEnd() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfScenarioRun
+ *
+ * @param[in,out] pScenario scenario set up by AfScenarioInit()
+ * @param[in]     pOptions  output options, NULL: results only
+ *
+ * @returns       none
+ *
+ * @note          Runs Iterations samples between AfScenarioBegin() and
+ *  AfScenarioEnd().
+ *
+ * @warning       none
+ */
+void AfScenarioRun(AfScenario *pScenario, const AfTestOptions *pOptions) {
+	double desired;
+	unsigned int i;
+
+	AfScenarioBegin(pScenario, pOptions);
+	for ( i = 0; i < pScenario->Params.Iterations; i++) {
+		AfScenarioStep(pScenario, &desired);
+	}
+	AfScenarioEnd(pScenario);
+}
+/* End of AfScenarioRun() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfScenarioRunMany
+ *
+ * @param[in,out] pScenarios scenarios set up by AfScenarioInit()
+ * @param[in]     count      number of scenarios
+ * @param[in]     threads    worker threads, 0: one per scenario, capped at
+ *  SCENARIO_MAX_THREADS
+ * @param[in]     pOptions   output options, NULL: results only
+ *
+ * @returns       none
+ *
+ * @note          Workers take the next unrun scenario until none are left.
+ *  With more than one scenario, scenario k (from 1) writes its metrics to
+ *  the metrics path with ".k" appended. Results do not depend on the
+ *  thread count.
+ *
+ * @warning       none
+ */
+void AfScenarioRunMany(AfScenario *pScenarios, unsigned int count,
+                       unsigned int threads, const AfTestOptions *pOptions) {
+	pthread_t workers[SCENARIO_MAX_THREADS];
+	ScenarioQueue queue;
+	unsigned int t, started = 0;
+
+	queue.pScenarios = pScenarios;
+	queue.Count = count;
+	queue.pOptions = pOptions;
+	atomic_init(&queue.Next, 0);
+
+	if (threads == 0 || threads > count) {
+		threads = count;
+	}
+	if (threads > SCENARIO_MAX_THREADS) {
+		threads = SCENARIO_MAX_THREADS;
+	}
+	for ( t = 1; t < threads; t++ ) {
+		if (pthread_create(&workers[started], NULL, ScenarioWorker, &queue) == 0) {
+			started++;
+		}
+	}
+	ScenarioWorker(&queue); /* the caller works too, and alone if none started */
+	for ( t = 0; t < started; t++ ) {
+		pthread_join(workers[t], NULL);
+	}
+}
+/* End of AfScenarioRunMany() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfScenarioReport
+ *
+ * @param[in]     pScenario scenario after AfScenarioRun()
+ * @param[in]     index     scenario number to print
+ *
+ * @returns       none
+ *
+ * @note          Prints the parameters and results, then a PASS or FAIL
+ *  line against the scenario's thresholds.
+ *
+ * @warning       none
+ */
+void AfScenarioReport(const AfScenario *pScenario, unsigned int index) {
+	const AfScenarioParams *pParams = &pScenario->Params;
+
+	printf("Scenario %u: taps %u, step %g, reg %g, iterations %u, seed %u: "
+	       "misalignment %.1fdB, squared error %.1fdB, samples to %gdB %u\n",
+	       index, pParams->Taps, pParams->StepSize, pParams->Regularization,
+	       pParams->Iterations, pParams->Seed, pScenario->MisalignmentDb,
+	       pScenario->SquaredErrorDb, pParams->ConvergenceThresh, pScenario->Converged);
+	if (pScenario->MetricsFailed) {
+		printf("FAIL: Scenario %u metrics file not written\n", index);
+	}
+	printf("%s: Scenario %u Misalignment < %g and Squared Error < %g\n",
+	       pScenario->Passed ? "PASS" : "FAIL", index,
+	       pParams->MisalignmentThresh, pParams->SquaredErrorThresh);
+}
+/* End of AfScenarioReport() */
+/******************************************************************************/
+
+/** internal functions **/
+
+/***************************************************************************//**
+* ScenarioWorker
+*
+* @param[in,out] pArg ScenarioQueue shared by the workers
+*
+* @returns       NULL
+*
+* @note          none
+*
+* @warning       none
+*******************************************************************************/
+static void *ScenarioWorker(void *pArg) {
+	ScenarioQueue *pQueue = (ScenarioQueue *)pArg;
+	unsigned int index;
+
+	while ((index = atomic_fetch_add(&pQueue->Next, 1)) < pQueue->Count) {
+		RunIndexed(&pQueue->pScenarios[index], index, pQueue->Count, pQueue->pOptions);
+	}
+
+	return NULL;
+}
+/* End of ScenarioWorker()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* RunIndexed
+*
+* @param[in,out] pScenario scenario to run
+* @param[in]     index     its position in the set, from 0
+* @param[in]     count     scenarios in the set
+* @param[in]     pOptions  output options, NULL: results only
+*
+* @returns       none
+*
+* @note          Gives each scenario of a set its own metrics file name.
+*
+* @warning       none
+*******************************************************************************/
+static void RunIndexed(AfScenario *pScenario, unsigned int index,
+                       unsigned int count, const AfTestOptions *pOptions) {
+	char path[SCENARIO_PATH];
+	AfTestOptions options;
+
+	if (!pOptions || !pOptions->pMetricsPath || count == 1) {
+		AfScenarioRun(pScenario, pOptions);
+		return;
+	}
+	options = *pOptions;
+	snprintf(path, sizeof(path), "%s.%u", pOptions->pMetricsPath, index + 1);
+	options.pMetricsPath = path;
+	AfScenarioRun(pScenario, &options);
+}
+/* End of RunIndexed()*/
+/******************************************************************************/
@@ -0,0 +1,104 @@
+/*
+ * @file AdaptiveFilterScenario.h
+ *
+ * Header file for AdaptiveFilterScenario.c, the system-identification test
+ * scenario: an NLMS filter identifying a random fixed FIR filter from white
+ * noise. Every scenario carries its own parameters, random generator and
+ * state, so any number of them can run at once.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+#ifndef ADAPTIVEFILTERSCENARIO_H_
+#define ADAPTIVEFILTERSCENARIO_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include "AdaptiveFilter.h"
+#include "AdaptiveFilterTest.h"
+#include "AfMetrics.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Default Scenario Parameters */
+#define AF_SCENARIO_STEPSIZE (0.3) /* step size for adaptive filter */
+#define AF_SCENARIO_REGULARIZATION (1.0E-10) /* regularization constant */
+#define AF_SCENARIO_TAPS (30) /* number of taps in test and adaptive filters */
+#define AF_SCENARIO_ITERATIONS (5000) /* number of iterations to run */
+#define AF_SCENARIO_SEED (824) /* explicit random seed for repeatability */
+#define AF_SCENARIO_MISALIGNMENT_THRESH (-290.0) /* dB threshold for pass/fail */
+#define AF_SCENARIO_SQUARED_ERROR_THRESH (-290.0) /* dB threshold for pass/fail */
+#define AF_SCENARIO_CONVERGENCE_THRESH (-100.0) /* dB misalignment for the
+                                                 * samples-to-threshold count */
+#define AF_SCENARIO_METRICS_RECORDS (512) /* iterations buffered per metrics
+                                           * file write */
+
+/* Runtime parameters of a scenario. AfScenarioDefaults() fills in the
+ * values above; AfScenarioParse() overrides them from a key=value list.
+ */
+typedef struct {
+	unsigned int Taps;
+	double StepSize;
+	double Regularization;
+	unsigned int Iterations;
+	unsigned int Seed;
+	double MisalignmentThresh; /* dB, final misalignment must be below */
+	double SquaredErrorThresh; /* dB, final squared error must be below */
+	double ConvergenceThresh; /* dB misalignment counted as converged */
+} AfScenarioParams;
+
+/* Contains a scenario's parameters, state and results. Set up with
+ * AfScenarioInit(), which allocates everything from the scenario's arena.
+ */
+typedef struct {
+	AfScenarioParams Params;
+	uint64_t Rng; /* splitmix64 state */
+	double *pTestWeights; /* Taps weights of the fixed test filter */
+	double *pTestBuffer; /* Taps circular delay line of the test filter */
+	unsigned int TestBufferIdx;
+	AfData *pData; /* the adaptive filter under test */
+	void *pMetricsMem; /* AF_SCENARIO_METRICS_RECORDS records of metrics */
+	AfArena Arena;
+	unsigned int Iteration; /* samples run */
+	double SquaredError; /* latest squared error, linear */
+	double Misalignment; /* latest misalignment, linear; computed every
+	                      * sample until Converged, then only for kept
+	                      * and printed samples and by AfScenarioEnd() */
+	unsigned int Converged; /* samples to ConvergenceThresh, 0: never */
+	unsigned int Decimation; /* caller keeps every Decimation-th sample's
+	                          * metrics, 0: none; set after AfScenarioInit() */
+	int Kept; /* the latest sample is one the caller keeps */
+	double ConvergenceLinear; /* ConvergenceThresh as a power ratio */
+	double SquaredErrorDb; /* final values, set by AfScenarioEnd() */
+	double MisalignmentDb;
+	int Passed; /* final values met both thresholds */
+	int Verbose; /* print every iteration */
+	FILE *pMetricsFile; /* open between AfScenarioBegin() and AfScenarioEnd() */
+	AfMetrics Recorder;
+	int MetricsFailed; /* the metrics file could not be written */
+} AfScenario;
+
+void AfScenarioDefaults(AfScenarioParams *pParams);
+int AfScenarioParse(AfScenarioParams *pParams, const char *pSpec);
+int AfScenarioInit(AfScenario *pScenario, const AfScenarioParams *pParams);
+void AfScenarioDestroy(AfScenario *pScenario);
+double AfScenarioRandom(AfScenario *pScenario);
+double AfScenarioNext(AfScenario *pScenario, double *pDesired);
+double AfScenarioStep(AfScenario *pScenario, double *pDesired);
+double AfScenarioMisalignment(const AfScenario *pScenario, const double *pWeights,
+                              unsigned int length);
+void AfScenarioPrintIteration(const AfScenario *pScenario);
+void AfScenarioBegin(AfScenario *pScenario, const AfTestOptions *pOptions);
+void AfScenarioEnd(AfScenario *pScenario);
+void AfScenarioRun(AfScenario *pScenario, const AfTestOptions *pOptions);
+void AfScenarioRunMany(AfScenario *pScenarios, unsigned int count,
+                       unsigned int threads, const AfTestOptions *pOptions);
+void AfScenarioReport(const AfScenario *pScenario, unsigned int index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ADAPTIVEFILTERSCENARIO_H_ */
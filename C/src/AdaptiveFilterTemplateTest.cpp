@@ -0,0 +1,131 @@
+/*
+ * @file AdaptiveFilterTemplateTest.cpp
+ *
+ * Test routine for the C++ AdaptiveFilter template: runs the system
+ * identification scenario of AdaptiveFilterTest.c with a compile-time tap
+ * count, the runtime-length specialization and single precision, and reports
+ * pass/fail against the same kind of misalignment thresholds. It also checks
+ * that the runtime-length specialization rejects a zero length and the
+ * compile-time one any length but its own.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+/******************************************************************************/
+/* include block */
+#include "AdaptiveFilterTest.h"
+#include "AdaptiveFilterScenario.h"
+#include "AdaptiveFilter.hpp"
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+/** local definitions **/
+namespace {
+
+/* Primary Test Parameters, the rest come from AfScenarioDefaults() */
+const std::size_t kNumTaps = AF_SCENARIO_TAPS; /* compile-time tap count */
+const double kFloatMisalignmentPassThresh = -120.0; /* dB threshold, float */
+const double kDbEpsilon = AF_METRICS_DB_EPSILON; /* allows minimum 10*log10() value of -400dB */
+
+/***************************************************************************//**
+* RunScenario
+*
+* @param[in,out] filter adaptive filter under test
+* @param[in]     params scenario parameters, Taps matching the filter
+* @param[in]     name printable name of the configuration
+* @param[in]     threshold misalignment pass threshold in dB
+*
+* @returns       none
+*
+* @note          Identifies the scenario's fixed test filter from its
+*  generator's input and prints the final misalignment with pass/fail
+*  status.
+*
+* @warning       none
+*******************************************************************************/
+template <typename Filter>
+void RunScenario(Filter &filter, const AfScenarioParams &params, const char *name,
+                 double threshold) {
+	AfScenario scenario;
+	double input, desired, misalignmentDb;
+	unsigned int i, k;
+
+	if (AfScenarioInit(&scenario, &params) != 0) { /* draws the fixed test filter */
+		std::printf("FAIL: Template %s cannot create the test scenario\n", name);
+		return;
+	}
+	for (i = 0; i < params.Iterations; i++) {
+		input = AfScenarioNext(&scenario, &desired);
+		filter.Run(input, desired);
+	}
+
+	std::vector<double> weights(params.Taps);
+	for (k = 0; k < params.Taps; k++) {
+		weights[k] = filter.Weights()[k];
+	}
+	misalignmentDb = 10 * std::log10(kDbEpsilon +
+	                                 AfScenarioMisalignment(&scenario, weights.data(), params.Taps));
+	AfScenarioDestroy(&scenario);
+
+	std::printf("%s: Template %s Misalignment %s %.0f\n",
+	            misalignmentDb < threshold ? "PASS" : "FAIL", name,
+	            misalignmentDb < threshold ? "<" : "!<", threshold);
+}
+/* End of RunScenario() */
+/******************************************************************************/
+
+} /* namespace */
+
+/******************************************************************************
+ * AdaptiveFilterTemplateTestRun
+ *
+ * @param[in]     none
+ *
+ * @returns       none
+ *
+ * @note          Runs the template filter configurations through the default
+ *  test scenario and prints their pass/fail status, then checks that a zero
+ *  runtime length and a length other than the compile-time one are
+ *  rejected.
+ *
+ * @warning       none
+ */
+void AdaptiveFilterTemplateTestRun(void) {
+	AfScenarioParams params;
+
+	AfScenarioDefaults(&params);
+
+	af::AdaptiveFilter<double, kNumTaps> fixedFilter(params.StepSize, params.Regularization);
+	af::AdaptiveFilter<double> dynamicFilter(params.StepSize, params.Regularization, params.Taps);
+	af::AdaptiveFilter<float, kNumTaps> floatFilter((float)params.StepSize,
+	                                                (float)params.Regularization);
+
+	RunScenario(fixedFilter, params, "<double,30>", params.MisalignmentThresh);
+	RunScenario(dynamicFilter, params, "<double,Dynamic>", params.MisalignmentThresh);
+	RunScenario(floatFilter, params, "<float,30>", kFloatMisalignmentPassThresh);
+
+	bool rejected = false;
+	try {
+		af::AdaptiveFilter<double> emptyFilter(params.StepSize, params.Regularization, 0);
+		(void)emptyFilter;
+	}
+	catch (const std::invalid_argument &) {
+		rejected = true;
+	}
+	std::printf("%s: Template <double,Dynamic> rejects length 0\n", rejected ? "PASS" : "FAIL");
+
+	rejected = false;
+	try {
+		af::AdaptiveFilter<double, kNumTaps> shortFilter(params.StepSize, params.Regularization,
+		                                                 kNumTaps - 1);
+		(void)shortFilter;
+	}
+	catch (const std::invalid_argument &) {
+		rejected = true;
+	}
+	std::printf("%s: Template <double,30> rejects length 29\n", rejected ? "PASS" : "FAIL");
+}
+/* End of AdaptiveFilterTemplateTestRun() */
+/******************************************************************************/
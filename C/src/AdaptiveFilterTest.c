@@ -5,9 +5,15 @@
  *   1. Creates adaptive filter data struct
  *   2. Creates a fixed test filter
  *   3. Generates a random input signal
- *   4. Runs the adaptive filter to identify the fixed test filter weights
- *   5. Computes misalignment and squared error metrics and prints to stdout
+ *   4. Runs the adaptive filter to identify the fixed test filter weights,
+ *      alongside its single precision and Q15 fixed-point builds and the
+ *      frequency-domain block and partitioned filters on the same signals,
+ *      and a filter bank whose channels see scaled copies of the signals
+ *   5. Computes misalignment and squared error metrics, optionally writing
+ *      them to a file in batches or printing every iteration to stdout
  *   6. Reports pass/fail to stdout according to expected convergence threshold
+ *   7. Checks every SIMD kernel table the host supports against the scalar
+ *      reference kernels
  *
  * Created on: Apr 14, 2014
  * Author: John Bang
@@ -15,83 +21,345 @@
 
 /******************************************************************************/
 /* include block */
+#include "AdaptiveFilterTest.h"
+#include "AdaptiveFilterScenario.h"
+#include "AdaptiveFilterEnsemble.h"
 #include "AdaptiveFilter.h"
+#include "AdaptiveFilterF.h"
+#include "AdaptiveFilterQ15.h"
+#include "AdaptiveFilterFreq.h"
+#include "AdaptiveFilterPart.h"
+#include "AdaptiveFilterBank.h"
+#include "AdaptiveFilterApa.h"
+#include "AdaptiveFilterFtf.h"
+#include "AdaptiveFilterProp.h"
+#include "AfExecutor.h"
+#include "AfStream.h"
+#include "AfMetrics.h"
+#include "AfHistogram.h"
+#include <pthread.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
-
-/** local definitions **/
-static void InitWeights();
-static double Filter(double input);
-static double ComputeMisalignment();
-static void PrintIterationStatus(unsigned int iteration);
-static void PrintPassFailStatus();
+#include <float.h>
+#include <stdint.h>
+#include <string.h>
 
 /* Adaptive Filter parameter/state information ********************************/
 
-/* Primary Test Parameters */
-#define STEPSIZE (0.3) /* step size for adaptive filter */
-#define REGULARIZATION (1.0E-10) /* regularization constant for adaptive filter */
-#define NUM_TAPS (30) /* number of taps in test and adaptive filters */
-#define ITERATIONS (5000) /* number of iterations to run adaptive filter */
-#define MISALIGNMENT_PASS_THRESH (-290.0) /* dB threshold for pass/fail test */
-#define SQUARED_ERROR_PASS_THRESH (-290.0) /* dB threshold for pass/fail test */
-#define DB_EPSILON (1.0E-40) /* allows minimum 10*log10() value of -400dB */
-#define RAND_SEED (824) /* explicit random seed for test repeatability */
-
-/* Test State */
-static double testWeights[NUM_TAPS];
-static double testBuffer[NUM_TAPS];
-static unsigned int testBufferIdx = 0;
-static double squaredErrorDb, misalignmentDb;
-
-/* Adaptive Filter Data */
-static double inBuffer[NUM_TAPS] = { 0 };
-static double weights[NUM_TAPS] = { 0 };
-static AfData Adata = {
-		STEPSIZE,
-        REGULARIZATION,
-		NUM_TAPS,
-		inBuffer,
-        0, /* initial buffer index */
-		weights,
-		0.0 /* initial error */
-};
+/* Primary Test Parameters, the default scenario */
+#define STEPSIZE (AF_SCENARIO_STEPSIZE) /* step size for adaptive filter */
+#define REGULARIZATION (AF_SCENARIO_REGULARIZATION) /* regularization constant for adaptive filter */
+#define NUM_TAPS (AF_SCENARIO_TAPS) /* number of taps in test and adaptive filters */
+#define ITERATIONS (AF_SCENARIO_ITERATIONS) /* number of iterations to run adaptive filter */
+#define MISALIGNMENT_PASS_THRESH (AF_SCENARIO_MISALIGNMENT_THRESH) /* dB threshold for pass/fail test */
+#define SQUARED_ERROR_PASS_THRESH (AF_SCENARIO_SQUARED_ERROR_THRESH) /* dB threshold for pass/fail test */
+#define FLOAT_MISALIGNMENT_PASS_THRESH (-120.0) /* dB, float floor is about -135dB */
+#define FLOAT_SQUARED_ERROR_PASS_THRESH (-120.0) /* dB, float floor is about -135dB */
+#define Q15_SIGNAL_SCALE (0.0625) /* headroom so the desired signal fits Q15 */
+#define Q15_MISALIGNMENT_PASS_THRESH (-70.0) /* dB, Q15 floor is about -80dB */
+#define FREQ_STEPSIZE (0.5) /* step size for the frequency-domain filter */
+#define FREQ_TAPS (32) /* power of two >= NUM_TAPS */
+#define FREQ_MEM_DOUBLES (20 * FREQ_TAPS) /* >= AdaptiveFilterFreqMemSize() */
+#define FREQ_MISALIGNMENT_PASS_THRESH (-290.0) /* dB threshold for pass/fail test */
+#define PART_STEPSIZE (0.5) /* step size for the partitioned filter */
+#define PART_BLOCK_SIZE (8) /* partition size and latency, a power of two */
+#define PART_PARTITIONS (4) /* PART_BLOCK_SIZE * PART_PARTITIONS >= NUM_TAPS */
+#define PART_MEM_DOUBLES (40 * PART_BLOCK_SIZE * PART_PARTITIONS) /* >= AdaptiveFilterPartMemSize() */
+#define PART_MISALIGNMENT_PASS_THRESH (-290.0) /* dB threshold for pass/fail test */
+#define BANK_CHANNELS (11) /* odd, so every SIMD channel tail is exercised */
+#define BANK_MISALIGNMENT_PASS_THRESH (-290.0) /* dB threshold, worst channel */
+#define APA_ORDER (4) /* projection order of the affine projection filter */
+#define APA_MEM_DOUBLES (3 * NUM_TAPS + 4 * APA_ORDER + 2 * APA_ORDER * APA_ORDER)
+#define APA_MISALIGNMENT_PASS_THRESH (-290.0) /* dB threshold for pass/fail test */
+#define FTF_FORGETTING (0.99) /* >= 1 - 1/(2*NUM_TAPS) for stability */
+#define FTF_REGULARIZATION (1.0E-4) /* initial prediction error energy */
+#define FTF_MEM_DOUBLES (6 * NUM_TAPS + 5) /* >= AdaptiveFilterFtfMemSize() */
+#define FTF_MISALIGNMENT_PASS_THRESH (-290.0) /* dB threshold for pass/fail test */
+#define RESCUE_SAMPLE (1000) /* sample whose backward energy is corrupted,
+                              * long after FTF has converged */
+#define RESCUE_ITERATIONS (4000) /* samples run, corrupted one included */
+#define CONVERGENCE_THRESH (AF_SCENARIO_CONVERGENCE_THRESH) /* dB misalignment
+                                     * for the samples-to-threshold comparison */
+#define DB_EPSILON (AF_METRICS_DB_EPSILON) /* allows minimum 10*log10() value of -400dB */
+#define RAND_SEED (AF_SCENARIO_SEED) /* scenario seed, every signal is drawn
+                                      * from its generator for repeatability */
+#define KERNEL_TEST_LENGTH (259) /* longest vector for the kernel check */
+#define KERNEL_TEST_CHANNELS (19) /* most channels for the bank kernel check */
+#define EXEC_THREADS (4) /* executor workers, more than one task each */
+#define EXEC_FILTERS (4) /* filters of different lengths for the executor */
+#define EXEC_MAX_TAPS (64) /* longest executor test filter */
+#define EXEC_CHANNELS (37) /* bank channels, several unaligned tasks */
+#define EXEC_BANK_TAPS (16) /* bank filter length for the executor check */
+#define EXEC_FRAMES (32) /* samples per executor block */
+#define EXEC_BLOCKS (8) /* blocks per executor check */
+#define STREAM_FRAMES (1000) /* frames pushed through the stream check */
+#define STREAM_RING (32) /* ring capacity, small so it wraps often */
+#define ARENA_FILTERS (5) /* filters carved from one arena */
+#define BLOCK_SAMPLES (1000) /* samples split into blocks of 1, 7 and 64 with
+                              * a shorter remainder at the end */
+#define LAYOUT_SAMPLES (10 * NUM_TAPS + 7) /* several delay line wraps,
+                                            * ending mid-buffer */
+#define LAYOUT_TOLERANCE (1.0E-12) /* circular two-slice sums against the
+                                    * mirrored single slice */
+#define NORM_REFRESH (64) /* K, samples between exact running norm refreshes */
+#define NORM_SAMPLES (4000) /* samples run, the first half at NORM_LARGE */
+#define NORM_LARGE (1.0) /* input amplitude before the drop */
+#define NORM_SMALL (1.0E-3) /* input amplitude after the drop */
+#define NORM_TOLERANCE (1.0E-12) /* running against exact norm outputs */
+#define FUSED_SAMPLES (10 * NUM_TAPS + 7) /* several delay line wraps */
+#define FUSED_BLOCK (16) /* AdaptiveFilterRunBlock() size, leaves a remainder */
+#define FUSED_TOLERANCE (1.0E-12) /* single-pass against two-pass sums */
+#define HIST_WIDTH_PASS_THRESH (0.01) /* bucket width over its smallest value */
+#define SPARSE_TAPS (512) /* length of the sparse echo path */
+#define SPARSE_ACTIVE (8) /* nonzero taps in the sparse echo path */
+#define SPARSE_STEPSIZE (0.5) /* step size for the sparse path comparison */
+#define SPARSE_ITERATIONS (6000) /* samples run on the sparse path */
+#define SPARSE_CONVERGENCE_THRESH (-20.0) /* dB misalignment for the sparse
+                                           * samples-to-threshold comparison */
+#define PARTIAL_TAPS (NUM_TAPS / 3) /* taps updated per sample (M) */
+#define PARTIAL_ITERATIONS (12000) /* samples run per partial-update mode */
+#define SM_NOISE (1.0E-3) /* peak of the uniform noise on the desired signal */
+#define SM_ERROR_BOUND (1.5E-3) /* set-membership bound, above the noise peak */
+#define SM_ITERATIONS (10000) /* samples run, the second half counted */
+#define SM_MISALIGNMENT_PASS_THRESH (-60.0) /* dB, noise limits misalignment */
+#define SM_SKIPPED_PASS_THRESH (0.9) /* skipped fraction in steady state */
+#define FROZEN_TAPS (512) /* long enough for FFT convolution to pay off */
+#define FROZEN_SAMPLES (1100) /* per stage: two FFT blocks and a short tail */
+#define FROZEN_TOLERANCE (1.0E-9) /* FFT against dot product output rounding */
+#define FROZEN_FIR_MEM_DOUBLES (5 * 2 * FROZEN_TAPS) /* >= AdaptiveFilterFirMemSize() */
+#define ENSEMBLE_TRIALS (24) /* trials, not a multiple of the thread count */
+#define ENSEMBLE_THREADS (5) /* threads for the run compared to one thread */
+#define ENSEMBLE_ITERATIONS (2000) /* samples per trial, past convergence */
+#define ENSEMBLE_DECIMATION (10) /* samples per curve point */
+
+/* Test State, set up on every AdaptiveFilterTestRun() call */
+typedef struct {
+	/* Single Precision and Fixed-Point Adaptive Filter Data */
+	float BufferF[NUM_TAPS];
+	float WeightsF[NUM_TAPS];
+	int16_t BufferQ15[2 * NUM_TAPS]; /* mirrored delay line */
+	int32_t WeightsQ31[NUM_TAPS];
+
+	/* Frequency-Domain and Partitioned Adaptive Filter Data, set up by
+	 * AdaptiveFilterFreqInit() and AdaptiveFilterPartInit() */
+	double FreqMem[FREQ_MEM_DOUBLES];
+	AfFreqData Freq;
+	int FreqReady;
+	double PartMem[PART_MEM_DOUBLES];
+	AfPartData Part;
+	int PartReady;
+	double LongWeights[FREQ_TAPS + PART_BLOCK_SIZE * PART_PARTITIONS];
+
+	/* Affine Projection and Fast Transversal Filter Data */
+	double ApaMem[APA_MEM_DOUBLES];
+	AfApaData Apa;
+	int ApaReady;
+	double FtfMem[FTF_MEM_DOUBLES];
+	AfFtfData Ftf;
+	int FtfReady;
+
+	/* Filter Bank Data, channel c sees the signals scaled by c + 1 */
+	double BufferBank[2 * NUM_TAPS * BANK_CHANNELS];
+	double WeightsBank[NUM_TAPS * BANK_CHANNELS];
+	double OutputBank[BANK_CHANNELS], ErrorBank[BANK_CHANNELS];
+	double EnergyBank[BANK_CHANNELS], ScaleBank[BANK_CHANNELS];
+
+	/* Results */
+	double SquaredErrorDbF, MisalignmentDbF;
+	double MisalignmentDbQ15, ReferenceMisalignmentDbQ15;
+	double MisalignmentDbFreq, MisalignmentDbPart, MisalignmentDbBank;
+	double MisalignmentDbApa, MisalignmentDbFtf;
+	unsigned int ConvergedApa, ConvergedFtf; /* samples to
+	                                          * CONVERGENCE_THRESH, 0: never */
+} TestState;
+
+/* StreamThread() argument */
+typedef struct {
+	AfStream *pStream;
+	atomic_int Stop; /* ends StreamThread() */
+} StreamThreadArg;
+
+/** local definitions **/
+static double ComputeMisalignmentF(const AfScenario *pScenario, const AfDataF *pData);
+static double ComputeMisalignmentQ15(const double *pReference, const AfDataQ15 *pData);
+static double ComputeMisalignmentBank(const AfScenario *pScenario, const AfBank *pBank);
+static void PrintPassFailStatus(const AfScenario *pScenario, const TestState *pState);
+static void PrintRescueStatus(AfScenario *pScenario);
+static void PrintBlockStatus(AfScenario *pScenario);
+static void PrintLayoutStatus(AfScenario *pScenario);
+static void PrintNormStatus(AfScenario *pScenario);
+static void PrintFusedStatus(AfScenario *pScenario);
+static void PrintKernelStatus(AfScenario *pScenario);
+static void PrintExecutorStatus(AfScenario *pScenario);
+static void PrintStreamStatus(AfScenario *pScenario);
+static void PrintArenaStatus(AfScenario *pScenario);
+static void PrintSparseStatus(AfScenario *pScenario);
+static void PrintPartialStatus(AfScenario *pScenario);
+static void PrintSetMembershipStatus(AfScenario *pScenario);
+static void PrintFrozenStatus(AfScenario *pScenario);
+static void PrintEnsembleStatus();
+static void PrintHistogramStatus();
+static void *StreamThread(void *pArg);
 
 /******************************************************************************
  * AdaptiveFilterTestRun
  *
- * @param[in]     none
+ * @param[in]     pOptions output options, NULL: summary only
  *
  * @returns       none
  *
- * @note          Runs adaptive filter in a system with a fixed test filter
- *  and tracks performance metrics (misalignment and squared error) according
- *  to expectations defined in the parameters listed above.
+ * @note          Runs the default system-identification scenario and,
+ *  on the same signals, every other filter variant, and tracks performance
+ *  metrics (misalignment and squared error) according to expectations
+ *  defined in the parameters listed above. The loop keeps the metrics
+ *  linear; they are converted to dB only for the summary, for verbose
+ *  printing, or a batch at a time in the metrics file.
+ *  All filter state lives in automatic storage set up on every call,
+ *  so repeated runs print the same results.
  *
  * @warning       none
  */
-void AdaptiveFilterTestRun() {
-	double input, desired, output;
-	unsigned int i;
+void AdaptiveFilterTestRun(const AfTestOptions *pOptions) {
+	TestState state = { 0 };
+	AfDataF dataF = {
+		.StepSize = (float)STEPSIZE,
+		.Regularization = (float)REGULARIZATION,
+		.Length = NUM_TAPS,
+		.pBuffer = state.BufferF,
+		.pWeights = state.WeightsF
+	};
+	AfDataQ15 dataQ15 = {
+		.StepSize = AF_Q31(STEPSIZE),
+		.Regularization = 1, /* smallest Q30 regularization, about 1e-9 */
+		.Length = NUM_TAPS,
+		.pBuffer = state.BufferQ15,
+		.pWeights = state.WeightsQ31
+	};
+	AfBank bank = {
+		.StepSize = STEPSIZE,
+		.Regularization = REGULARIZATION,
+		.Length = NUM_TAPS,
+		.Channels = BANK_CHANNELS,
+		.pBuffer = state.BufferBank,
+		.pWeights = state.WeightsBank,
+		.pOutput = state.OutputBank,
+		.pError = state.ErrorBank,
+		.pEnergy = state.EnergyBank,
+		.pScale = state.ScaleBank
+	};
+	double inputBank[BANK_CHANNELS], desiredBank[BANK_CHANNELS];
+	double input, desired, misalignmentApa = 1.0, misalignmentFtf = 1.0;
+	const double convergence = pow(10.0, CONVERGENCE_THRESH / 10);
+	const AfScenarioParams params = {
+		NUM_TAPS, STEPSIZE, REGULARIZATION, ITERATIONS, RAND_SEED,
+		MISALIGNMENT_PASS_THRESH, SQUARED_ERROR_PASS_THRESH, CONVERGENCE_THRESH
+	};
+	AfScenario scenario;
+	unsigned int i, c;
     
-    srand(RAND_SEED); /* set random seed for repeatability */
 
-	InitWeights(); /* initialize fixed test filter */
+	if (AfScenarioInit(&scenario, &params) != 0) { /* creates the fixed test filter */
+		printf("FAIL: cannot create the test scenario\n");
+		return;
+	}
+	state.FreqReady = AdaptiveFilterFreqMemSize(FREQ_TAPS) <= sizeof(state.FreqMem) &&
+	                  AdaptiveFilterFreqInit(&state.Freq, FREQ_STEPSIZE, REGULARIZATION,
+	                                         FREQ_TAPS, state.FreqMem) == 0;
+	state.PartReady = AdaptiveFilterPartMemSize(PART_BLOCK_SIZE, PART_PARTITIONS) <= sizeof(state.PartMem) &&
+	                  AdaptiveFilterPartInit(&state.Part, PART_STEPSIZE, REGULARIZATION,
+	                                         PART_BLOCK_SIZE, PART_PARTITIONS, state.PartMem) == 0;
+	state.ApaReady = AdaptiveFilterApaMemSize(NUM_TAPS, APA_ORDER) <= sizeof(state.ApaMem) &&
+	                 AdaptiveFilterApaInit(&state.Apa, STEPSIZE, REGULARIZATION,
+	                                       NUM_TAPS, APA_ORDER, state.ApaMem) == 0;
+	state.FtfReady = AdaptiveFilterFtfMemSize(NUM_TAPS) <= sizeof(state.FtfMem) &&
+	                 AdaptiveFilterFtfInit(&state.Ftf, FTF_FORGETTING, FTF_REGULARIZATION,
+	                                       NUM_TAPS, state.FtfMem) == 0;
 
+	AfScenarioBegin(&scenario, pOptions); /* opens the metrics file */
 	for ( i = 0; i < ITERATIONS; i++) {
-        /* Generate a random input sample on the interval (-1,1) */
-		input = ( 2 * (double)rand() / (double)RAND_MAX ) - 1;
-		desired = Filter(input); /* run the fixed test filter */
-		output = AdaptiveFilterRun(input, desired, &Adata);
-        
-        /* Compute performance metrics */
-		squaredErrorDb = 10 * log10( DB_EPSILON + (Adata.Error) * (Adata.Error) );
-        misalignmentDb = 10 * log10( DB_EPSILON + ComputeMisalignment() );
+        /* Random input on (-1,1) through the fixed test filter, and NLMS */
+		input = AfScenarioStep(&scenario, &desired);
+		AdaptiveFilterRunF((float)input, (float)desired, &dataF);
+		AdaptiveFilterRunQ15(AF_Q15(input * Q15_SIGNAL_SCALE),
+		                     AF_Q15(desired * Q15_SIGNAL_SCALE), &dataQ15);
+		if (state.FreqReady) {
+			AdaptiveFilterFreqRun(input, desired, &state.Freq);
+		}
+		if (state.PartReady) {
+			AdaptiveFilterPartRun(input, desired, &state.Part);
+		}
+		if (state.ApaReady) {
+			AdaptiveFilterApaRun(input, desired, &state.Apa);
+		}
+		if (state.FtfReady) {
+			AdaptiveFilterFtfRun(input, desired, &state.Ftf);
+		}
+		for ( c = 0; c < BANK_CHANNELS; c++) {
+			inputBank[c] = input * (c + 1);
+			desiredBank[c] = desired * (c + 1);
+		}
+		AdaptiveFilterBankRun(inputBank, desiredBank, &bank);
         
-        PrintIterationStatus(i+1); /* print performance for this iteration */
+        /* Compute performance metrics, linear until they are reported */
+        /* Only the samples to convergence are needed per iteration */
+        if (state.ApaReady && !state.ConvergedApa && DB_EPSILON +
+            AfScenarioMisalignment(&scenario, state.Apa.pWeights, NUM_TAPS) < convergence) {
+            state.ConvergedApa = i + 1;
+        }
+        if (state.FtfReady && !state.ConvergedFtf && DB_EPSILON +
+            AfScenarioMisalignment(&scenario, state.Ftf.pWeights, NUM_TAPS) < convergence) {
+            state.ConvergedFtf = i + 1;
+        }
 	}
-    PrintPassFailStatus(); /* print whether expected performance was acheived */
+    AfScenarioEnd(&scenario); /* writes the last metrics batch */
+    if (scenario.MetricsFailed) {
+        printf("FAIL: cannot write metrics to %s\n", pOptions->pMetricsPath);
+    }
+    if (state.ApaReady) {
+        misalignmentApa = AfScenarioMisalignment(&scenario, state.Apa.pWeights, NUM_TAPS);
+    }
+    if (state.FtfReady) {
+        misalignmentFtf = AfScenarioMisalignment(&scenario, state.Ftf.pWeights, NUM_TAPS);
+    }
+    state.MisalignmentDbApa = 10 * log10( DB_EPSILON + misalignmentApa );
+    state.MisalignmentDbFtf = 10 * log10( DB_EPSILON + misalignmentFtf );
+    state.SquaredErrorDbF = 10 * log10( DB_EPSILON + (dataF.Error) * (dataF.Error) );
+    state.MisalignmentDbF = 10 * log10( DB_EPSILON + ComputeMisalignmentF(&scenario, &dataF) );
+    state.MisalignmentDbQ15 = 10 * log10( DB_EPSILON +
+                                          ComputeMisalignmentQ15(scenario.pTestWeights, &dataQ15) );
+    state.ReferenceMisalignmentDbQ15 = 10 * log10( DB_EPSILON +
+                                                   ComputeMisalignmentQ15(scenario.pData->pWeights, &dataQ15) );
+    state.MisalignmentDbBank = 10 * log10( DB_EPSILON + ComputeMisalignmentBank(&scenario, &bank) );
+    if (state.FreqReady) {
+        AdaptiveFilterFreqWeights(&state.Freq, state.LongWeights);
+        state.MisalignmentDbFreq = 10 * log10( DB_EPSILON +
+                                               AfScenarioMisalignment(&scenario, state.LongWeights, FREQ_TAPS) );
+    }
+    if (state.PartReady) {
+        AdaptiveFilterPartWeights(&state.Part, state.LongWeights);
+        state.MisalignmentDbPart = 10 * log10( DB_EPSILON +
+                                               AfScenarioMisalignment(&scenario, state.LongWeights, state.Part.Length) );
+    }
+
+    PrintPassFailStatus(&scenario, &state); /* print whether expected performance was acheived */
+    PrintKernelStatus(&scenario); /* print whether SIMD kernels match the reference */
+    PrintExecutorStatus(&scenario); /* print whether the executor matches serial runs */
+    PrintStreamStatus(&scenario); /* print whether the streaming driver matches */
+    PrintArenaStatus(&scenario); /* print whether arena-created filters match */
+    PrintSparseStatus(&scenario); /* print whether proportionate NLMS is faster */
+    PrintPartialStatus(&scenario); /* print whether partial updates still converge */
+    PrintSetMembershipStatus(&scenario); /* print whether converged updates are skipped */
+    PrintFrozenStatus(&scenario); /* print whether the frozen fast path matches */
+    PrintRescueStatus(&scenario); /* print whether FTF recovers from divergence */
+    PrintBlockStatus(&scenario); /* print whether block splits match per-sample runs */
+    PrintLayoutStatus(&scenario); /* print whether both delay line layouts agree */
+    PrintNormStatus(&scenario); /* print whether the running norm stays bounded */
+    PrintFusedStatus(&scenario); /* print whether fused filters match unfused */
+    PrintEnsembleStatus(); /* print whether ensemble bands are deterministic */
+    PrintHistogramStatus(); /* print whether histogram buckets bound their values */
+
+    AfScenarioDestroy(&scenario);
 
 }
 /* End of AdaptiveFilterTestRun() */
@@ -100,113 +368,112 @@ void AdaptiveFilterTestRun() {
 /** internal functions **/
 
 /***************************************************************************//**
-* InitWeights
+* ComputeMisalignmentF
 * 
-* @param[in]     none
+* @param[in]     pScenario scenario holding the fixed test filter
+* @param[in]     pData single precision filter
 *
-* @returns       none
+* @returns       filter weight misalignment of the single precision filter
 * 
-* @note          initializes the fixed test filter weights using random numbers
+* @note          Same as AfScenarioMisalignment() for pData
 * 
 * @warning       none
 *******************************************************************************/
-static void InitWeights() {
-	unsigned int i;
-	for ( i = 0; i < NUM_TAPS; i++) {
-        /* initialize using random numbers on the interval (-1,1) */
-		testWeights[i] = ( 2 * (double)rand() / (double)RAND_MAX ) - 1;
-	}
-}
-/* End of InitWeights() */
-/******************************************************************************/
-
-/***************************************************************************//**
-* Filter
-* 
-* @param[in]     input input signal sample
-*
-* @returns       new test filter output
-* 
-* @note          Computes a new output sample using the input and the fixed
-*  test filter
-* 
-* @warning       none
-*******************************************************************************/
-static double Filter(double input) {
-	double output = 0;
-	int i;
-
-    if (testBufferIdx >= NUM_TAPS) {
-        testBufferIdx = 0;
+static double ComputeMisalignmentF(const AfScenario *pScenario, const AfDataF *pData) {
+    const double *testWeights = pScenario->pTestWeights;
+    unsigned int i;
+    double difference;
+    double diffSqrdNorm = 0.0, testSqrdNorm = 0.0;
+    
+    for ( i = 0; i < NUM_TAPS; i++) {
+        difference = testWeights[i] - pData->pWeights[i]; /* weight difference */
+        
+        /* accumulate squared terms */
+        diffSqrdNorm += difference * difference;
+        testSqrdNorm += testWeights[i] * testWeights[i];
     }
-    testBuffer[testBufferIdx++] = input;
     
-	for ( i = NUM_TAPS - 1; i >= 0; i--) {
-        if (testBufferIdx >= NUM_TAPS) {
-            testBufferIdx = 0;
-        }
-		output += testWeights[i] * testBuffer[testBufferIdx++];
-	}
-
-	return output;
+    return ( diffSqrdNorm / testSqrdNorm ); /* return normalized misalignment */
 }
-/* End of Filter() */
+/* End of ComputeMisalignmentF() */
 /******************************************************************************/
 
 /***************************************************************************//**
-* ComputeMisalignment
+* ComputeMisalignmentQ15
 * 
-* @param[in]     none
+* @param[in]     pReference reference weights to compare against
+* @param[in]     pData fixed-point filter
 *
-* @returns       filter weight misalignment
+* @returns       filter weight misalignment of the fixed-point filter
 * 
-* @note          Computes filter weight misalignment between test filter and
-*  the adaptive filter, normalized by the squared L2-norm of the test filter:
-*  (||Wtest - Wadaptive||^2) / (||Wtest||^2)
+* @note          Same as AfScenarioMisalignment() for the Q31 weights of
+*  pData against an arbitrary reference, such as the test filter or the
+*  double precision adaptive filter
 * 
 * @warning       none
 *******************************************************************************/
-static double ComputeMisalignment() {
+static double ComputeMisalignmentQ15(const double *pReference, const AfDataQ15 *pData) {
     unsigned int i;
     double difference;
-    double diffSqrdNorm = 0.0, testSqrdNorm = 0.0;
+    double diffSqrdNorm = 0.0, refSqrdNorm = 0.0;
     
     for ( i = 0; i < NUM_TAPS; i++) {
-        difference = testWeights[i] - Adata.pWeights[i]; /* weight difference */
+        difference = pReference[i] - AF_Q31_TO_DOUBLE(pData->pWeights[i]);
         
         /* accumulate squared terms */
         diffSqrdNorm += difference * difference;
-        testSqrdNorm += testWeights[i] * testWeights[i];
+        refSqrdNorm += pReference[i] * pReference[i];
     }
     
-    return ( diffSqrdNorm / testSqrdNorm ); /* return normalized misalignment */
+    return ( diffSqrdNorm / refSqrdNorm ); /* return normalized misalignment */
 }
-/* End of ComputeMisalignment() */
+/* End of ComputeMisalignmentQ15() */
 /******************************************************************************/
 
 /***************************************************************************//**
-* PrintIterationStatus
+* ComputeMisalignmentBank
 * 
-* @param[in]     iteration current iteration number
+* @param[in]     pScenario scenario holding the fixed test filter
+* @param[in]     pBank filter bank
 *
-* @returns       none
+* @returns       worst filter weight misalignment over the bank's channels
 * 
-* @note          prints performance metrics for this iteration
+* @note          Same as AfScenarioMisalignment() for each channel of pBank,
+*  reading its taps out of the interleaved weights
 * 
 * @warning       none
 *******************************************************************************/
-static void PrintIterationStatus(unsigned int iteration) {
-    printf("Iteration: %d\n", iteration);
-    printf("Misalignment (dB): %f\n",misalignmentDb);
-    printf("Squared error (dB): %f\n",squaredErrorDb);
+static double ComputeMisalignmentBank(const AfScenario *pScenario, const AfBank *pBank) {
+    const double *testWeights = pScenario->pTestWeights;
+    unsigned int i, c;
+    double difference, misalignment, worst = 0.0;
+    double diffSqrdNorm, testSqrdNorm;
+    
+    for ( c = 0; c < BANK_CHANNELS; c++) {
+        diffSqrdNorm = testSqrdNorm = 0.0;
+        for ( i = 0; i < NUM_TAPS; i++) {
+            difference = testWeights[i] - pBank->pWeights[i * BANK_CHANNELS + c];
+            
+            /* accumulate squared terms */
+            diffSqrdNorm += difference * difference;
+            testSqrdNorm += testWeights[i] * testWeights[i];
+        }
+        misalignment = diffSqrdNorm / testSqrdNorm;
+        if (misalignment > worst) {
+            worst = misalignment;
+        }
+    }
+    
+    return worst; /* return worst normalized misalignment */
 }
-/* End of PrintIterationStatus() */
+/* End of ComputeMisalignmentBank() */
 /******************************************************************************/
 
 /***************************************************************************//**
 * PrintPassFailStatus
 * 
-* @param[in]     none
+* @param[in]     pScenario default scenario after AfScenarioEnd()
+* @param[in]     pState results of the other filters on the same signals
 *
 * @returns       none
 * 
@@ -214,19 +481,1283 @@ static void PrintIterationStatus(unsigned int iteration) {
 * 
 * @warning       none
 *******************************************************************************/
-static void PrintPassFailStatus() {
-    if (misalignmentDb > MISALIGNMENT_PASS_THRESH) {
+static void PrintPassFailStatus(const AfScenario *pScenario, const TestState *pState) {
+    const unsigned int convergedNlms = pScenario->Converged;
+
+    if (pScenario->MisalignmentDb > MISALIGNMENT_PASS_THRESH) {
         printf("FAIL: Misalignment !< %.0f\n",MISALIGNMENT_PASS_THRESH);
     }
     else {
         printf("PASS: Misalignment < %.0f\n",MISALIGNMENT_PASS_THRESH);
     }
-    if (squaredErrorDb > SQUARED_ERROR_PASS_THRESH) {
+    if (pScenario->SquaredErrorDb > SQUARED_ERROR_PASS_THRESH) {
         printf("FAIL: Squared Error !< %.0f\n",SQUARED_ERROR_PASS_THRESH);
     }
     else {
         printf("PASS: Squared Error < %.0f\n",SQUARED_ERROR_PASS_THRESH);
     }
+    if (pState->MisalignmentDbF > FLOAT_MISALIGNMENT_PASS_THRESH) {
+        printf("FAIL: Float Misalignment !< %.0f\n",FLOAT_MISALIGNMENT_PASS_THRESH);
+    }
+    else {
+        printf("PASS: Float Misalignment < %.0f\n",FLOAT_MISALIGNMENT_PASS_THRESH);
+    }
+    if (pState->SquaredErrorDbF > FLOAT_SQUARED_ERROR_PASS_THRESH) {
+        printf("FAIL: Float Squared Error !< %.0f\n",FLOAT_SQUARED_ERROR_PASS_THRESH);
+    }
+    else {
+        printf("PASS: Float Squared Error < %.0f\n",FLOAT_SQUARED_ERROR_PASS_THRESH);
+    }
+    printf("Q15 misalignment vs double reference (dB): %f\n",pState->ReferenceMisalignmentDbQ15);
+    if (pState->MisalignmentDbQ15 > Q15_MISALIGNMENT_PASS_THRESH) {
+        printf("FAIL: Q15 Misalignment !< %.0f\n",Q15_MISALIGNMENT_PASS_THRESH);
+    }
+    else {
+        printf("PASS: Q15 Misalignment < %.0f\n",Q15_MISALIGNMENT_PASS_THRESH);
+    }
+    if (pState->MisalignmentDbFreq > FREQ_MISALIGNMENT_PASS_THRESH) {
+        printf("FAIL: Frequency-Domain Misalignment !< %.0f\n",FREQ_MISALIGNMENT_PASS_THRESH);
+    }
+    else {
+        printf("PASS: Frequency-Domain Misalignment < %.0f\n",FREQ_MISALIGNMENT_PASS_THRESH);
+    }
+    if (pState->MisalignmentDbPart > PART_MISALIGNMENT_PASS_THRESH) {
+        printf("FAIL: Partitioned Misalignment !< %.0f\n",PART_MISALIGNMENT_PASS_THRESH);
+    }
+    else {
+        printf("PASS: Partitioned Misalignment < %.0f\n",PART_MISALIGNMENT_PASS_THRESH);
+    }
+    if (pState->MisalignmentDbBank > BANK_MISALIGNMENT_PASS_THRESH) {
+        printf("FAIL: Bank Misalignment !< %.0f\n",BANK_MISALIGNMENT_PASS_THRESH);
+    }
+    else {
+        printf("PASS: Bank Misalignment < %.0f\n",BANK_MISALIGNMENT_PASS_THRESH);
+    }
+    if (pState->MisalignmentDbApa > APA_MISALIGNMENT_PASS_THRESH) {
+        printf("FAIL: APA Misalignment !< %.0f\n",APA_MISALIGNMENT_PASS_THRESH);
+    }
+    else {
+        printf("PASS: APA Misalignment < %.0f\n",APA_MISALIGNMENT_PASS_THRESH);
+    }
+    if (pState->MisalignmentDbFtf > FTF_MISALIGNMENT_PASS_THRESH) {
+        printf("FAIL: FTF Misalignment !< %.0f\n",FTF_MISALIGNMENT_PASS_THRESH);
+    }
+    else {
+        printf("PASS: FTF Misalignment < %.0f\n",FTF_MISALIGNMENT_PASS_THRESH);
+    }
+    printf("Samples to %.0fdB misalignment: NLMS %u, APA %u, FTF %u (FTF rescues %lu)\n",
+           CONVERGENCE_THRESH, convergedNlms, pState->ConvergedApa,
+           pState->ConvergedFtf, pState->Ftf.Rescues);
+    if (!pState->ConvergedFtf || (convergedNlms && pState->ConvergedFtf >= convergedNlms)) {
+        printf("FAIL: FTF converges faster than NLMS\n");
+    }
+    else {
+        printf("PASS: FTF converges faster than NLMS\n");
+    }
 }
 /* End of PrintPassFailStatus() */
-/******************************************************************************/
\ No newline at end of file
+/******************************************************************************/
+
+/***************************************************************************//**
+* PrintRescueStatus
+* 
+* @param[in,out] pScenario scenario holding the fixed test filter, whose
+*  generator supplies the signals
+*
+* @returns       none
+* 
+* @note          identifies the fixed test filter with FTF, flips the sign
+*  of the backward prediction error energy at RESCUE_SAMPLE as runaway
+*  roundoff would, and prints pass/fail on the predictors being restarted
+*  and the misalignment getting back below CONVERGENCE_THRESH
+* 
+* @warning       none
+*******************************************************************************/
+static void PrintRescueStatus(AfScenario *pScenario) {
+    double mem[FTF_MEM_DOUBLES] = { 0 }, history[2 * NUM_TAPS] = { 0 };
+    AfFtfData ftf;
+    unsigned long rescuesBefore = 0;
+    unsigned int historyIdx = 0, i, k;
+    double input, desired, misalignmentDb;
+
+    if (AdaptiveFilterFtfMemSize(NUM_TAPS) > sizeof(mem) ||
+        AdaptiveFilterFtfInit(&ftf, FTF_FORGETTING, FTF_REGULARIZATION, NUM_TAPS, mem) != 0) {
+        printf("FAIL: FTF rescues a diverged recursion and reconverges\n");
+        return;
+    }
+
+    for ( i = 0; i < RESCUE_ITERATIONS; i++) {
+        input = AfScenarioRandom(pScenario);
+        if (i == RESCUE_SAMPLE) {
+            rescuesBefore = ftf.Rescues;
+            ftf.BackwardEnergy = -ftf.BackwardEnergy;
+        }
+        if (historyIdx == 0) {
+            historyIdx = NUM_TAPS;
+        }
+        historyIdx--;
+        history[historyIdx] = history[historyIdx + NUM_TAPS] = input;
+        desired = 0.0;
+        for ( k = 0; k < NUM_TAPS; k++) {
+            desired += pScenario->pTestWeights[k] * history[historyIdx + k];
+        }
+        AdaptiveFilterFtfRun(input, desired, &ftf);
+    }
+    misalignmentDb = 10 * log10( DB_EPSILON + AfScenarioMisalignment(pScenario, ftf.pWeights, NUM_TAPS) );
+
+    printf("FTF rescues after a corrupted backward energy: %lu, misalignment %.1fdB\n",
+           ftf.Rescues - rescuesBefore, misalignmentDb);
+    if (rescuesBefore != 0 || ftf.Rescues == rescuesBefore ||
+        misalignmentDb > CONVERGENCE_THRESH) {
+        printf("FAIL: FTF rescues a diverged recursion and reconverges\n");
+    }
+    else {
+        printf("PASS: FTF rescues a diverged recursion and reconverges\n");
+    }
+}
+/* End of PrintRescueStatus() */
+/******************************************************************************/
+
+/***************************************************************************//**
+* PrintKernelStatus
+* 
+* @param[in,out] pScenario scenario whose generator supplies the signals
+*
+* @returns       none
+* 
+* @note          compares each kernel table the host can run against the
+*  scalar reference on random vectors of every length up to
+*  KERNEL_TEST_LENGTH, and the bank kernels on up to KERNEL_TEST_CHANNELS
+*  channels, and prints pass/fail against AF_KERNEL_TOLERANCE
+* 
+* @warning       none
+*******************************************************************************/
+static void PrintKernelStatus(AfScenario *pScenario) {
+    static const AfIsa isas[] = {
+        AF_ISA_SSE2, AF_ISA_AVX2, AF_ISA_AVX512, AF_ISA_NEON
+    };
+    double a[KERNEL_TEST_LENGTH], b[KERNEL_TEST_LENGTH];
+    double outRef[KERNEL_TEST_LENGTH], outSimd[KERNEL_TEST_LENGTH];
+    float af[KERNEL_TEST_LENGTH], bf[KERNEL_TEST_LENGTH];
+    float outRefF[KERNEL_TEST_LENGTH], outSimdF[KERNEL_TEST_LENGTH];
+    double bankRef[KERNEL_TEST_CHANNELS], bankSimd[KERNEL_TEST_CHANNELS];
+    double bankEnergyRef[KERNEL_TEST_CHANNELS], bankEnergySimd[KERNEL_TEST_CHANNELS];
+    double bankScale[KERNEL_TEST_CHANNELS];
+    double gainRef[KERNEL_TEST_LENGTH], gainSimd[KERNEL_TEST_LENGTH];
+    double normsRef[2], normsSimd[2];
+    float energyRefF, energySimdF;
+    const AfKernels *pRef = AfKernelsGet(AF_ISA_SCALAR);
+    const AfKernels *pSimd;
+    double magnitude, scale = 0.37, dotRef, energyRef, energySimd;
+    unsigned int i, j, c, k, n, pass;
+
+    for ( i = 0; i < KERNEL_TEST_LENGTH; i++) {
+        a[i] = AfScenarioRandom(pScenario);
+        b[i] = AfScenarioRandom(pScenario);
+        af[i] = (float)a[i];
+        bf[i] = (float)b[i];
+    }
+
+    for ( k = 0; k < sizeof(isas) / sizeof(isas[0]); k++) {
+        pSimd = AfKernelsGet(isas[k]);
+        if (!pSimd) {
+            continue; /* not built for or not supported by this host */
+        }
+        pass = 1;
+        for ( n = 0; n <= KERNEL_TEST_LENGTH; n++) {
+            magnitude = 0.0;
+            for ( i = 0; i < n; i++) {
+                magnitude += fabs(a[i] * b[i]);
+                outRef[i] = outSimd[i] = a[i];
+            }
+            if (fabs(pSimd->Dot(a, b, n) - pRef->Dot(a, b, n)) >
+                AF_KERNEL_TOLERANCE(n, magnitude)) {
+                pass = 0;
+            }
+            if (fabs(pSimd->SquaredNorm(a, n) - pRef->SquaredNorm(a, n)) >
+                AF_KERNEL_TOLERANCE(n, pRef->SquaredNorm(a, n))) {
+                pass = 0;
+            }
+            pRef->ScaledAdd(outRef, scale, b, n);
+            pSimd->ScaledAdd(outSimd, scale, b, n);
+            for ( i = 0; i < n; i++) {
+                if (fabs(outSimd[i] - outRef[i]) >
+                    AF_KERNEL_TOLERANCE(1, fabs(a[i]) + fabs(scale * b[i]))) {
+                    pass = 0;
+                }
+            }
+            /* fused sweep: update from b, then filter a with the result */
+            energyRef = energySimd = 0.0;
+            dotRef = pRef->UpdateDot(outRef, a, b, scale, n, &energyRef);
+            if (fabs(pSimd->UpdateDot(outSimd, a, b, scale, n, &energySimd) - dotRef) >
+                AF_KERNEL_TOLERANCE(2 * n + 2, 2 * n) ||
+                fabs(energySimd - energyRef) > AF_KERNEL_TOLERANCE(n, energyRef)) {
+                pass = 0;
+            }
+            /* proportionate gains from weights a and input b, IPNLMS-like
+             * offset and PNLMS-like floor at once, then the update */
+            energyRef = pRef->PropGain(gainRef, a, b, 0.01, scale, 0.25, n);
+            energySimd = pSimd->PropGain(gainSimd, a, b, 0.01, scale, 0.25, n);
+            for ( i = 0; i < n; i++) {
+                if (fabs(gainSimd[i] - gainRef[i]) > AF_KERNEL_TOLERANCE(1, gainRef[i])) {
+                    pass = 0;
+                }
+                outRef[i] = outSimd[i] = a[i];
+            }
+            if (fabs(energySimd - energyRef) > AF_KERNEL_TOLERANCE(n + 1, energyRef)) {
+                pass = 0;
+            }
+            pRef->PropUpdate(outRef, scale, gainRef, b, n, normsRef);
+            pSimd->PropUpdate(outSimd, scale, gainRef, b, n, normsSimd);
+            for ( i = 0; i < n; i++) {
+                if (fabs(outSimd[i] - outRef[i]) >
+                    AF_KERNEL_TOLERANCE(2, fabs(a[i]) + fabs(scale * gainRef[i] * b[i]))) {
+                    pass = 0;
+                }
+            }
+            if (fabs(normsSimd[0] - normsRef[0]) > AF_KERNEL_TOLERANCE(n + 1, normsRef[0]) ||
+                fabs(normsSimd[1] - normsRef[1]) > AF_KERNEL_TOLERANCE(2, normsRef[1])) {
+                pass = 0;
+            }
+
+            /* single precision kernels, same checks with float tolerance */
+            if (fabs(pSimd->DotF(af, bf, n) - pRef->DotF(af, bf, n)) >
+                AF_KERNEL_TOLERANCE_F(n, magnitude)) {
+                pass = 0;
+            }
+            if (fabs(pSimd->SquaredNormF(af, n) - pRef->SquaredNormF(af, n)) >
+                AF_KERNEL_TOLERANCE_F(n, pRef->SquaredNormF(af, n))) {
+                pass = 0;
+            }
+            for ( i = 0; i < n; i++) {
+                outRefF[i] = outSimdF[i] = af[i];
+            }
+            pRef->ScaledAddF(outRefF, (float)scale, bf, n);
+            pSimd->ScaledAddF(outSimdF, (float)scale, bf, n);
+            for ( i = 0; i < n; i++) {
+                if (fabs(outSimdF[i] - outRefF[i]) >
+                    AF_KERNEL_TOLERANCE_F(1, fabs(af[i]) + fabs(scale * bf[i]))) {
+                    pass = 0;
+                }
+            }
+            energyRefF = energySimdF = 0.0f;
+            dotRef = pRef->UpdateDotF(outRefF, af, bf, (float)scale, n, &energyRefF);
+            if (fabs(pSimd->UpdateDotF(outSimdF, af, bf, (float)scale, n, &energySimdF) - dotRef) >
+                AF_KERNEL_TOLERANCE_F(2 * n + 2, 2 * n) ||
+                fabs(energySimdF - energyRefF) > AF_KERNEL_TOLERANCE_F(n, energyRefF)) {
+                pass = 0;
+            }
+        }
+
+        /* bank kernels: a and b as n rows of KERNEL_TEST_CHANNELS
+         * interleaved channels, of which the first c are processed */
+        n = KERNEL_TEST_LENGTH / KERNEL_TEST_CHANNELS;
+        for ( c = 1; c <= KERNEL_TEST_CHANNELS; c++) {
+            pRef->BankDot(a, b, n, c, KERNEL_TEST_CHANNELS, bankRef, bankEnergyRef);
+            pSimd->BankDot(a, b, n, c, KERNEL_TEST_CHANNELS, bankSimd, bankEnergySimd);
+            for ( j = 0; j < c; j++) {
+                magnitude = 0.0;
+                for ( i = 0; i < n; i++) {
+                    magnitude += fabs(a[i * KERNEL_TEST_CHANNELS + j] * b[i * KERNEL_TEST_CHANNELS + j]);
+                }
+                if (fabs(bankSimd[j] - bankRef[j]) > AF_KERNEL_TOLERANCE(n, magnitude) ||
+                    fabs(bankEnergySimd[j] - bankEnergyRef[j]) >
+                    AF_KERNEL_TOLERANCE(n, bankEnergyRef[j])) {
+                    pass = 0;
+                }
+                bankScale[j] = scale * (j + 1);
+            }
+            for ( i = 0; i < n * KERNEL_TEST_CHANNELS; i++) {
+                outRef[i] = outSimd[i] = a[i];
+            }
+            pRef->BankScaledAdd(outRef, bankScale, b, n, c, KERNEL_TEST_CHANNELS);
+            pSimd->BankScaledAdd(outSimd, bankScale, b, n, c, KERNEL_TEST_CHANNELS);
+            for ( i = 0; i < n * KERNEL_TEST_CHANNELS; i++) {
+                j = i % KERNEL_TEST_CHANNELS;
+                if (j >= c ? outSimd[i] != a[i] /* outside the range: untouched */
+                           : fabs(outSimd[i] - outRef[i]) >
+                             AF_KERNEL_TOLERANCE(1, fabs(a[i]) + fabs(bankScale[j] * b[i]))) {
+                    pass = 0;
+                }
+            }
+        }
+        printf("%s: %s kernels within tolerance of scalar\n",
+               pass ? "PASS" : "FAIL", pSimd->Name);
+    }
+}
+/* End of PrintKernelStatus() */
+/******************************************************************************/
+
+/***************************************************************************//**
+* PrintExecutorStatus
+* 
+* @param[in,out] pScenario scenario whose generator supplies the signals
+*
+* @returns       none
+* 
+* @note          runs a set of filters of different lengths and a filter
+*  bank through a multithreaded executor and through the serial calls, and
+*  prints pass/fail on the outputs and weights being bit-identical
+* 
+* @warning       none
+*******************************************************************************/
+static void PrintExecutorStatus(AfScenario *pScenario) {
+    double buffers[2][EXEC_FILTERS][EXEC_MAX_TAPS] = { { { 0 } } };
+    double filterWeights[2][EXEC_FILTERS][EXEC_MAX_TAPS] = { { { 0 } } };
+    double input[EXEC_FILTERS][EXEC_FRAMES], desired[EXEC_FILTERS][EXEC_FRAMES];
+    double output[2][EXEC_FILTERS][EXEC_FRAMES];
+    double bankBuffers[2][2 * EXEC_BANK_TAPS * EXEC_CHANNELS] = { { 0 } };
+    double bankWeights[2][EXEC_BANK_TAPS * EXEC_CHANNELS] = { { 0 } };
+    double bankOutputs[2][EXEC_CHANNELS], bankErrors[2][EXEC_CHANNELS];
+    double bankEnergy[2][EXEC_CHANNELS], bankScale[2][EXEC_CHANNELS];
+    double bankInput[EXEC_FRAMES * EXEC_CHANNELS], bankDesired[EXEC_FRAMES * EXEC_CHANNELS];
+    double bankOutput[2][EXEC_FRAMES * EXEC_CHANNELS];
+#define EXEC_AFDATA(s, k, length) { .StepSize = STEPSIZE, .Regularization = REGULARIZATION, \
+                                    .Length = length, .pBuffer = buffers[s][k], \
+                                    .pWeights = filterWeights[s][k] }
+    AfData filters[2][EXEC_FILTERS] = { /* lengths differ to exercise LPT */
+        { EXEC_AFDATA(0, 0, EXEC_MAX_TAPS), EXEC_AFDATA(0, 1, 8),
+          EXEC_AFDATA(0, 2, NUM_TAPS), EXEC_AFDATA(0, 3, 17) },
+        { EXEC_AFDATA(1, 0, EXEC_MAX_TAPS), EXEC_AFDATA(1, 1, 8),
+          EXEC_AFDATA(1, 2, NUM_TAPS), EXEC_AFDATA(1, 3, 17) }
+    };
+#undef EXEC_AFDATA
+#define EXEC_AFBANK(s) { .StepSize = STEPSIZE, .Regularization = REGULARIZATION, \
+                         .Length = EXEC_BANK_TAPS, .Channels = EXEC_CHANNELS, \
+                         .pBuffer = bankBuffers[s], .pWeights = bankWeights[s], \
+                         .pOutput = bankOutputs[s], .pError = bankErrors[s], \
+                         .pEnergy = bankEnergy[s], .pScale = bankScale[s] }
+    AfBank banks[2] = { EXEC_AFBANK(0), EXEC_AFBANK(1) };
+#undef EXEC_AFBANK
+    AfExecFilter set[EXEC_FILTERS];
+    AfExecutor *pExec = AfExecutorCreate(EXEC_THREADS);
+    unsigned int i, k, b, pass = (pExec != NULL);
+
+    for ( b = 0; pass && b < EXEC_BLOCKS; b++) {
+        for ( k = 0; k < EXEC_FILTERS; k++) {
+            for ( i = 0; i < EXEC_FRAMES; i++) {
+                input[k][i] = AfScenarioRandom(pScenario);
+                desired[k][i] = AfScenarioRandom(pScenario);
+            }
+            set[k].pData = &filters[0][k];
+            set[k].pInput = input[k];
+            set[k].pDesired = desired[k];
+            set[k].pOutput = output[0][k];
+            set[k].pError = NULL;
+            AdaptiveFilterRunBlock(input[k], desired[k], output[1][k], NULL,
+                                   EXEC_FRAMES, &filters[1][k]);
+        }
+        AfExecutorRunFilters(pExec, set, EXEC_FILTERS, EXEC_FRAMES);
+
+        for ( i = 0; i < EXEC_FRAMES * EXEC_CHANNELS; i++) {
+            bankInput[i] = AfScenarioRandom(pScenario);
+            bankDesired[i] = AfScenarioRandom(pScenario);
+        }
+        AfExecutorRunBank(pExec, bankInput, bankDesired, bankOutput[0], NULL,
+                          EXEC_FRAMES, &banks[0]);
+        AdaptiveFilterBankRunBlock(bankInput, bankDesired, bankOutput[1], NULL,
+                                   EXEC_FRAMES, &banks[1]);
+
+        pass = memcmp(output[0], output[1], sizeof(output[0])) == 0 &&
+               memcmp(filterWeights[0], filterWeights[1], sizeof(filterWeights[0])) == 0 &&
+               memcmp(bankOutput[0], bankOutput[1], sizeof(bankOutput[0])) == 0 &&
+               memcmp(bankWeights[0], bankWeights[1], sizeof(bankWeights[0])) == 0 &&
+               banks[0].BufferIdx == banks[1].BufferIdx;
+    }
+    AfExecutorDestroy(pExec);
+
+    printf("%s: Executor matches serial runs\n", pass ? "PASS" : "FAIL");
+}
+/* End of PrintExecutorStatus() */
+/******************************************************************************/
+
+/***************************************************************************//**
+* PrintStreamStatus
+* 
+* @param[in,out] pScenario scenario whose generator supplies the signals
+*
+* @returns       none
+* 
+* @note          feeds frames through an AfStream running on its own thread,
+*  with this thread as both capture and playback side, and prints pass/fail
+*  on the outputs being bit-identical to a direct run with no frames lost,
+*  and on overruns and underruns being counted
+* 
+* @warning       none
+*******************************************************************************/
+static void PrintStreamStatus(AfScenario *pScenario) {
+    double frames[2 * STREAM_FRAMES], results[2 * STREAM_FRAMES];
+    double input[STREAM_FRAMES], desired[STREAM_FRAMES];
+    double outputDirect[STREAM_FRAMES], errorDirect[STREAM_FRAMES];
+    double ringIn[2 * STREAM_RING], ringOut[4 * STREAM_RING];
+    double buffers[2][NUM_TAPS] = { { 0 } }, filterWeights[2][NUM_TAPS] = { { 0 } };
+    AfData filters[2] = {
+        { .StepSize = STEPSIZE, .Regularization = REGULARIZATION, .Length = NUM_TAPS,
+          .pBuffer = buffers[0], .pWeights = filterWeights[0] },
+        { .StepSize = STEPSIZE, .Regularization = REGULARIZATION, .Length = NUM_TAPS,
+          .pBuffer = buffers[1], .pWeights = filterWeights[1] }
+    };
+    AfRing in, out;
+    AfStream stream = { &in, &out, &filters[0], 0 };
+    StreamThreadArg threadArg = { &stream, 0 };
+    pthread_t thread;
+    size_t written = 0, received = 0, space, i;
+    int pass;
+
+    for ( i = 0; i < STREAM_FRAMES; i++) {
+        input[i] = frames[2 * i] = AfScenarioRandom(pScenario);
+        desired[i] = frames[2 * i + 1] = AfScenarioRandom(pScenario);
+    }
+    AdaptiveFilterRunBlock(input, desired, outputDirect, errorDirect, STREAM_FRAMES, &filters[1]);
+
+    AfRingInit(&in, STREAM_RING, 2, ringIn);
+    AfRingInit(&out, 2 * STREAM_RING, 2, ringOut);
+    if (pthread_create(&thread, NULL, StreamThread, &threadArg) != 0) {
+        printf("FAIL: Stream matches direct run\n");
+        return;
+    }
+
+    /* never have more frames in flight than the output ring holds */
+    while (received < STREAM_FRAMES) {
+        space = AfRingSpace(&in);
+        if (space > 2 * STREAM_RING - (written - received)) {
+            space = 2 * STREAM_RING - (written - received);
+        }
+        if (space > STREAM_FRAMES - written) {
+            space = STREAM_FRAMES - written;
+        }
+        written += AfRingWrite(&in, frames + 2 * written, space);
+        received += AfRingRead(&out, results + 2 * received,
+                               AfRingAvailable(&out));
+    }
+    atomic_store(&threadArg.Stop, 1);
+    pthread_join(thread, NULL);
+
+    pass = AfRingOverruns(&in) == 0 && AfRingOverruns(&out) == 0 &&
+           AfRingUnderruns(&in) == 0 && AfRingUnderruns(&out) == 0 &&
+           stream.Frames == STREAM_FRAMES;
+    for ( i = 0; i < STREAM_FRAMES; i++) {
+        if (results[2 * i] != outputDirect[i] || results[2 * i + 1] != errorDirect[i]) {
+            pass = 0;
+        }
+    }
+
+    /* an empty ring comes up short, a full one drops the excess */
+    if (AfStreamProcess(&stream, 5) != 0 || AfRingUnderruns(&in) != 5 ||
+        AfRingWrite(&in, frames, STREAM_RING + 3) != STREAM_RING ||
+        AfRingOverruns(&in) != 3) {
+        pass = 0;
+    }
+
+    printf("%s: Stream matches direct run\n", pass ? "PASS" : "FAIL");
+}
+/* End of PrintStreamStatus() */
+/******************************************************************************/
+
+/***************************************************************************//**
+* StreamThread
+* 
+* @param[in]     pArg pointer to the StreamThreadArg holding the AfStream
+*
+* @returns       NULL
+* 
+* @note          DSP thread for PrintStreamStatus(), runs until its Stop flag
+*  is set
+* 
+* @warning       none
+*******************************************************************************/
+static void *StreamThread(void *pArg) {
+    StreamThreadArg *pThreadArg = (StreamThreadArg *)pArg;
+
+    AfStreamRun(pThreadArg->pStream, &pThreadArg->Stop);
+    return NULL;
+}
+/* End of StreamThread() */
+/******************************************************************************/
+
+/***************************************************************************//**
+* PrintArenaStatus
+* 
+* @param[in,out] pScenario scenario whose generator supplies the signals
+*
+* @returns       none
+* 
+* @note          creates filters in a huge-page arena, checks the alignment
+*  of their buffers, and prints pass/fail on them matching a static filter
+*  bit for bit and on a reset arena handing out the same memory again
+* 
+* @warning       none
+*******************************************************************************/
+static void PrintArenaStatus(AfScenario *pScenario) {
+    static const AfData config = {
+        .StepSize = STEPSIZE,
+        .Regularization = REGULARIZATION,
+        .Length = NUM_TAPS,
+        .Layout = AF_DELAY_MIRRORED
+    };
+    double buffer[2 * NUM_TAPS] = { 0 }, filterWeights[NUM_TAPS] = { 0 };
+    AfData reference = {
+        .StepSize = STEPSIZE, .Regularization = REGULARIZATION, .Length = NUM_TAPS,
+        .pBuffer = buffer, .pWeights = filterWeights, .Layout = AF_DELAY_MIRRORED
+    };
+    double input[EXEC_FRAMES], desired[EXEC_FRAMES];
+    double output[EXEC_FRAMES], outputReference[EXEC_FRAMES];
+    AfArena arena;
+    AfData *pFilters;
+    unsigned int i, k;
+    int pass;
+
+    if (AfArenaInit(&arena, AdaptiveFilterArenaSize(ARENA_FILTERS, &config),
+                    AF_ARENA_HUGE_PAGES) != 0) {
+        printf("FAIL: Arena filters match static filters\n");
+        return;
+    }
+    pFilters = AdaptiveFilterCreateMany(&arena, ARENA_FILTERS, &config);
+    pass = pFilters != NULL;
+
+    for ( i = 0; i < EXEC_FRAMES; i++) {
+        input[i] = AfScenarioRandom(pScenario);
+        desired[i] = AfScenarioRandom(pScenario);
+    }
+    AdaptiveFilterRunBlock(input, desired, outputReference, NULL, EXEC_FRAMES, &reference);
+    for ( k = 0; pass && k < ARENA_FILTERS; k++) {
+        if ((uintptr_t)pFilters[k].pBuffer % AF_ARENA_ALIGN != 0 ||
+            (uintptr_t)pFilters[k].pWeights % AF_ARENA_ALIGN != 0) {
+            pass = 0;
+        }
+        AdaptiveFilterRunBlock(input, desired, output, NULL, EXEC_FRAMES, &pFilters[k]);
+        if (memcmp(output, outputReference, sizeof(output)) != 0 ||
+            memcmp(pFilters[k].pWeights, filterWeights, sizeof(filterWeights)) != 0) {
+            pass = 0;
+        }
+    }
+
+    AfArenaReset(&arena);
+    if (pass && AdaptiveFilterCreateMany(&arena, ARENA_FILTERS, &config) != pFilters) {
+        pass = 0;
+    }
+    AfArenaDestroy(&arena);
+
+    printf("%s: Arena filters match static filters\n", pass ? "PASS" : "FAIL");
+}
+/* End of PrintArenaStatus() */
+/******************************************************************************/
+
+/***************************************************************************//**
+* PrintBlockStatus
+* 
+* @param[in,out] pScenario scenario whose generator supplies the signals
+*
+* @returns       none
+* 
+* @note          runs the same signal through AdaptiveFilterRun() one sample
+*  at a time and through AdaptiveFilterRunBlock() in blocks of 1, 7 and 64
+*  samples and a shorter remainder, and prints pass/fail on the outputs,
+*  errors and weights matching bit for bit
+* 
+* @warning       none
+*******************************************************************************/
+static void PrintBlockStatus(AfScenario *pScenario) {
+    static const unsigned int sizes[] = { 1, 7, 64 };
+    static const AfData config = {
+        .StepSize = STEPSIZE,
+        .Regularization = REGULARIZATION,
+        .Length = NUM_TAPS,
+        .Layout = AF_DELAY_MIRRORED
+    };
+    double input[BLOCK_SAMPLES], desired[BLOCK_SAMPLES];
+    double output[BLOCK_SAMPLES], error[BLOCK_SAMPLES];
+    double outputBlock[BLOCK_SAMPLES], errorBlock[BLOCK_SAMPLES];
+    AfArena arena;
+    AfData *pFilters;
+    unsigned int i, n, size, k = 0;
+    int pass;
+
+    if (AfArenaInit(&arena, AdaptiveFilterArenaSize(2, &config), 0) != 0) {
+        printf("FAIL: Block splits match per-sample runs\n");
+        return;
+    }
+    pFilters = AdaptiveFilterCreateMany(&arena, 2, &config);
+    pass = pFilters != NULL;
+
+    for ( i = 0; pass && i < BLOCK_SAMPLES; i++) {
+        input[i] = AfScenarioRandom(pScenario);
+        desired[i] = AfScenarioRandom(pScenario);
+        output[i] = AdaptiveFilterRun(input[i], desired[i], &pFilters[0]);
+        error[i] = pFilters[0].Error;
+    }
+    for ( n = 0; pass && n < BLOCK_SAMPLES; n += size) {
+        size = sizes[k++ % (sizeof(sizes) / sizeof(sizes[0]))];
+        if (size > BLOCK_SAMPLES - n) {
+            size = BLOCK_SAMPLES - n; /* remainder */
+        }
+        AdaptiveFilterRunBlock(input + n, desired + n, outputBlock + n, errorBlock + n,
+                               size, &pFilters[1]);
+    }
+    if (pass && (memcmp(output, outputBlock, sizeof(output)) != 0 ||
+                 memcmp(error, errorBlock, sizeof(error)) != 0 ||
+                 memcmp(pFilters[0].pWeights, pFilters[1].pWeights,
+                        NUM_TAPS * sizeof(double)) != 0)) {
+        pass = 0;
+    }
+    AfArenaDestroy(&arena);
+
+    printf("%s: Block splits match per-sample runs\n", pass ? "PASS" : "FAIL");
+}
+/* End of PrintBlockStatus() */
+/******************************************************************************/
+
+/***************************************************************************//**
+* PrintLayoutStatus
+* 
+* @param[in,out] pScenario scenario holding the fixed test filter, whose
+*  generator supplies the signals
+*
+* @returns       none
+* 
+* @note          identifies the fixed test filter with an AF_DELAY_MIRRORED
+*  and an AF_DELAY_CIRCULAR filter on the same signal for several delay
+*  line wraps, and prints pass/fail on their outputs and weights agreeing
+*  to LAYOUT_TOLERANCE
+* 
+* @warning       none
+*******************************************************************************/
+static void PrintLayoutStatus(AfScenario *pScenario) {
+    static const AfData mirrored = {
+        .StepSize = STEPSIZE,
+        .Regularization = REGULARIZATION,
+        .Length = NUM_TAPS,
+        .Layout = AF_DELAY_MIRRORED
+    };
+    static const AfData circular = {
+        .StepSize = STEPSIZE,
+        .Regularization = REGULARIZATION,
+        .Length = NUM_TAPS,
+        .Layout = AF_DELAY_CIRCULAR
+    };
+    AfArena arena;
+    AfData *pMirrored, *pCircular;
+    unsigned int i;
+    double input, desired;
+    int pass;
+
+    if (AfArenaInit(&arena, AdaptiveFilterArenaSize(1, &mirrored) +
+                            AdaptiveFilterArenaSize(1, &circular), 0) != 0) {
+        printf("FAIL: Mirrored and circular delay lines agree\n");
+        return;
+    }
+    pMirrored = AdaptiveFilterCreate(&arena, &mirrored);
+    pCircular = AdaptiveFilterCreate(&arena, &circular);
+    pass = pMirrored != NULL && pCircular != NULL;
+
+    for ( i = 0; pass && i < LAYOUT_SAMPLES; i++) {
+        input = AfScenarioNext(pScenario, &desired);
+        if (fabs(AdaptiveFilterRun(input, desired, pMirrored) -
+                 AdaptiveFilterRun(input, desired, pCircular)) > LAYOUT_TOLERANCE) {
+            pass = 0;
+        }
+    }
+    for ( i = 0; pass && i < NUM_TAPS; i++) {
+        if (fabs(pMirrored->pWeights[i] - pCircular->pWeights[i]) > LAYOUT_TOLERANCE) {
+            pass = 0;
+        }
+    }
+    AfArenaDestroy(&arena);
+
+    printf("%s: Mirrored and circular delay lines agree\n", pass ? "PASS" : "FAIL");
+}
+/* End of PrintLayoutStatus() */
+/******************************************************************************/
+
+/***************************************************************************//**
+* PrintNormStatus
+* 
+* @param[in,out] pScenario scenario holding the fixed test filter, whose
+*  generator supplies the signals
+*
+* @returns       none
+* 
+* @note          identifies the fixed test filter with NormRefresh = 0 (exact
+*  norm) and NormRefresh = NORM_REFRESH on an input that drops from
+*  NORM_LARGE to NORM_SMALL amplitude, and prints pass/fail on the running
+*  norm staying within NORM_REFRESH * 2^-52 * max(input^2) of the exact
+*  norm and on the outputs agreeing to NORM_TOLERANCE
+* 
+* @warning       none
+*******************************************************************************/
+static void PrintNormStatus(AfScenario *pScenario) {
+    static const AfData exact = {
+        .StepSize = STEPSIZE,
+        .Regularization = REGULARIZATION,
+        .Length = NUM_TAPS,
+        .Layout = AF_DELAY_MIRRORED
+    };
+    static const AfData running = {
+        .StepSize = STEPSIZE,
+        .Regularization = REGULARIZATION,
+        .Length = NUM_TAPS,
+        .Layout = AF_DELAY_MIRRORED,
+        .NormRefresh = NORM_REFRESH
+    };
+    double history[2 * NUM_TAPS] = { 0 };
+    AfArena arena;
+    AfData *pExact, *pRunning;
+    unsigned int historyIdx = 0, i, k;
+    double input, desired, maxSquared = 0.0, drift, worstDrift = 0.0;
+    long double energy;
+    int pass;
+
+    if (AfArenaInit(&arena, AdaptiveFilterArenaSize(1, &exact) +
+                            AdaptiveFilterArenaSize(1, &running), 0) != 0) {
+        printf("FAIL: Running norm within K*2^-52*max(x^2) and outputs match the exact norm\n");
+        return;
+    }
+    pExact = AdaptiveFilterCreate(&arena, &exact);
+    pRunning = AdaptiveFilterCreate(&arena, &running);
+    pass = pExact != NULL && pRunning != NULL;
+
+    for ( i = 0; pass && i < NORM_SAMPLES; i++) {
+        input = AfScenarioRandom(pScenario) * (i < NORM_SAMPLES / 2 ? NORM_LARGE : NORM_SMALL);
+        if (historyIdx == 0) {
+            historyIdx = NUM_TAPS;
+        }
+        historyIdx--;
+        history[historyIdx] = history[historyIdx + NUM_TAPS] = input;
+        desired = 0.0;
+        energy = 0.0;
+        for ( k = 0; k < NUM_TAPS; k++) {
+            desired += pScenario->pTestWeights[k] * history[historyIdx + k];
+            energy += (long double)history[historyIdx + k] * history[historyIdx + k];
+        }
+        if (input * input > maxSquared) {
+            maxSquared = input * input;
+        }
+
+        if (fabs(AdaptiveFilterRun(input, desired, pExact) -
+                 AdaptiveFilterRun(input, desired, pRunning)) > NORM_TOLERANCE) {
+            pass = 0;
+        }
+        /* extended-precision reference, so the drift is the running norm's */
+        drift = fabs((double)(pRunning->Energy + pRunning->EnergyComp - energy));
+        if (drift > worstDrift) {
+            worstDrift = drift;
+        }
+    }
+    if (worstDrift > NORM_REFRESH * DBL_EPSILON * maxSquared) {
+        pass = 0;
+    }
+    AfArenaDestroy(&arena);
+
+    printf("Running norm, refresh every %u samples: worst drift %.1f * 2^-52 * max(x^2)\n",
+           NORM_REFRESH, worstDrift / (DBL_EPSILON * maxSquared));
+    printf("%s: Running norm within K*2^-52*max(x^2) and outputs match the exact norm\n", pass ? "PASS" : "FAIL");
+}
+/* End of PrintNormStatus() */
+/******************************************************************************/
+
+/***************************************************************************//**
+* PrintFusedStatus
+* 
+* @param[in,out] pScenario scenario holding the fixed test filter, whose
+*  generator supplies the signals
+*
+* @returns       none
+* 
+* @note          runs the same signal through an unfused (Fused = 0) and a
+*  fused (Fused = 1) filter with AF_DELAY_MIRRORED and AF_DELAY_CIRCULAR
+*  delay lines, through AdaptiveFilterRun(), AdaptiveFilterRunErrorIn() and
+*  AdaptiveFilterRunBlock(), and prints pass/fail on the outputs, and the
+*  weights after AdaptiveFilterFlush(), agreeing to FUSED_TOLERANCE
+* 
+* @warning       none
+*******************************************************************************/
+static void PrintFusedStatus(AfScenario *pScenario) {
+    static const AfData configs[2][2] = {
+        {
+            { .StepSize = STEPSIZE, .Regularization = REGULARIZATION,
+              .Length = NUM_TAPS, .Layout = AF_DELAY_MIRRORED },
+            { .StepSize = STEPSIZE, .Regularization = REGULARIZATION,
+              .Length = NUM_TAPS, .Layout = AF_DELAY_MIRRORED, .Fused = 1 }
+        },
+        {
+            { .StepSize = STEPSIZE, .Regularization = REGULARIZATION,
+              .Length = NUM_TAPS, .Layout = AF_DELAY_CIRCULAR },
+            { .StepSize = STEPSIZE, .Regularization = REGULARIZATION,
+              .Length = NUM_TAPS, .Layout = AF_DELAY_CIRCULAR, .Fused = 1 }
+        }
+    };
+    double input[FUSED_SAMPLES], desired[FUSED_SAMPLES];
+    double output[2][FUSED_SAMPLES];
+    AfArena arena;
+    AfData *pFilters[2];
+    unsigned int layout, mode, i, k, size;
+    double error;
+    int pass;
+
+    /* the mirrored filters are the larger pair */
+    if (AfArenaInit(&arena, 2 * AdaptiveFilterArenaSize(1, &configs[0][0]), 0) != 0) {
+        printf("FAIL: Fused filters match unfused filters\n");
+        return;
+    }
+    for ( i = 0; i < FUSED_SAMPLES; i++) {
+        input[i] = AfScenarioNext(pScenario, &desired[i]);
+    }
+
+    pass = 1;
+    for ( layout = 0; pass && layout < 2; layout++) {
+        for ( mode = 0; pass && mode < 3; mode++) {
+            AfArenaReset(&arena);
+            for ( k = 0; k < 2; k++) {
+                pFilters[k] = AdaptiveFilterCreate(&arena, &configs[layout][k]);
+                pass = pass && pFilters[k] != NULL;
+            }
+            if (!pass) {
+                break;
+            }
+
+            for ( k = 0; k < 2; k++) {
+                switch (mode) {
+                case 0:
+                    for ( i = 0; i < FUSED_SAMPLES; i++) {
+                        output[k][i] = AdaptiveFilterRun(input[i], desired[i], pFilters[k]);
+                    }
+                    break;
+                case 1:
+                    /* both filters adapt on the unfused filter's error */
+                    error = 0.0;
+                    for ( i = 0; i < FUSED_SAMPLES; i++) {
+                        output[k][i] = AdaptiveFilterRunErrorIn(input[i], error, pFilters[k]);
+                        error = desired[i] - output[0][i];
+                    }
+                    break;
+                default:
+                    for ( i = 0; i < FUSED_SAMPLES; i += size) {
+                        size = FUSED_SAMPLES - i < FUSED_BLOCK ? FUSED_SAMPLES - i : FUSED_BLOCK;
+                        AdaptiveFilterRunBlock(input + i, desired + i, output[k] + i, NULL,
+                                               size, pFilters[k]);
+                    }
+                    break;
+                }
+                AdaptiveFilterFlush(pFilters[k]);
+            }
+
+            for ( i = 0; i < FUSED_SAMPLES; i++) {
+                if (fabs(output[0][i] - output[1][i]) > FUSED_TOLERANCE) {
+                    pass = 0;
+                }
+            }
+            for ( i = 0; i < NUM_TAPS; i++) {
+                if (fabs(pFilters[0]->pWeights[i] - pFilters[1]->pWeights[i]) > FUSED_TOLERANCE) {
+                    pass = 0;
+                }
+            }
+        }
+    }
+    AfArenaDestroy(&arena);
+
+    printf("%s: Fused filters match unfused filters\n", pass ? "PASS" : "FAIL");
+}
+/* End of PrintFusedStatus() */
+/******************************************************************************/
+
+/***************************************************************************//**
+* PrintSparseStatus
+* 
+* @param[in,out] pScenario scenario whose generator supplies the signals
+*
+* @returns       none
+* 
+* @note          identifies a long echo path with only SPARSE_ACTIVE nonzero
+*  taps with NLMS, PNLMS and IPNLMS on the same signals, prints the samples
+*  each takes to reach SPARSE_CONVERGENCE_THRESH misalignment, and prints
+*  pass/fail on both proportionate filters getting there first
+* 
+* @warning       none
+*******************************************************************************/
+static void PrintSparseStatus(AfScenario *pScenario) {
+    double path[SPARSE_TAPS] = { 0 }, history[2 * SPARSE_TAPS] = { 0 };
+    double buffer[2 * SPARSE_TAPS] = { 0 }, filterWeights[SPARSE_TAPS] = { 0 };
+    double pnlmsMem[4 * SPARSE_TAPS] = { 0 }, ipnlmsMem[4 * SPARSE_TAPS] = { 0 };
+    AfData nlms = {
+        .StepSize = SPARSE_STEPSIZE, .Regularization = REGULARIZATION, .Length = SPARSE_TAPS,
+        .pBuffer = buffer, .pWeights = filterWeights, .Layout = AF_DELAY_MIRRORED
+    };
+    AfPropData pnlms, ipnlms;
+    const double *pWeights[3];
+    unsigned int converged[3] = { 0 };
+    unsigned int historyIdx = 0, i, j, k;
+    double input, desired, pathEnergy = 0.0, error, misalignment;
+
+    if (AdaptiveFilterPropMemSize(SPARSE_TAPS) > sizeof(pnlmsMem) ||
+        AdaptiveFilterPropInit(&pnlms, AF_PROP_PNLMS, SPARSE_STEPSIZE, REGULARIZATION,
+                               SPARSE_TAPS, pnlmsMem) != 0 ||
+        AdaptiveFilterPropInit(&ipnlms, AF_PROP_IPNLMS, SPARSE_STEPSIZE, REGULARIZATION,
+                               SPARSE_TAPS, ipnlmsMem) != 0) {
+        printf("FAIL: Proportionate NLMS converges faster on a sparse path\n");
+        return;
+    }
+    pWeights[0] = nlms.pWeights;
+    pWeights[1] = pnlms.pWeights;
+    pWeights[2] = ipnlms.pWeights;
+
+    for ( k = 0; k < SPARSE_ACTIVE; k++) {
+        path[(unsigned int)((AfScenarioRandom(pScenario) + 1) / 2 * SPARSE_TAPS)] = AfScenarioRandom(pScenario);
+    }
+    for ( i = 0; i < SPARSE_TAPS; i++) {
+        pathEnergy += path[i] * path[i];
+    }
+
+    for ( i = 0; i < SPARSE_ITERATIONS; i++) {
+        input = AfScenarioRandom(pScenario);
+        if (historyIdx == 0) {
+            historyIdx = SPARSE_TAPS;
+        }
+        historyIdx--;
+        history[historyIdx] = history[historyIdx + SPARSE_TAPS] = input;
+        desired = 0.0;
+        for ( k = 0; k < SPARSE_TAPS; k++) {
+            desired += path[k] * history[historyIdx + k];
+        }
+        AdaptiveFilterRun(input, desired, &nlms);
+        AdaptiveFilterPropRun(input, desired, &pnlms);
+        AdaptiveFilterPropRun(input, desired, &ipnlms);
+
+        for ( k = 0; k < 3; k++) {
+            if (converged[k]) {
+                continue;
+            }
+            misalignment = 0.0;
+            for ( j = 0; j < SPARSE_TAPS; j++) {
+                error = path[j] - pWeights[k][j];
+                misalignment += error * error;
+            }
+            if (10 * log10( DB_EPSILON + misalignment / pathEnergy ) < SPARSE_CONVERGENCE_THRESH) {
+                converged[k] = i + 1;
+            }
+        }
+    }
+
+    printf("Samples to %.0fdB misalignment on a %u-tap sparse path: NLMS %u, PNLMS %u, IPNLMS %u\n",
+           SPARSE_CONVERGENCE_THRESH, SPARSE_TAPS, converged[0], converged[1], converged[2]);
+    if (!converged[1] || !converged[2] ||
+        (converged[0] && (converged[1] >= converged[0] || converged[2] >= converged[0]))) {
+        printf("FAIL: Proportionate NLMS converges faster on a sparse path\n");
+    }
+    else {
+        printf("PASS: Proportionate NLMS converges faster on a sparse path\n");
+    }
+}
+/* End of PrintSparseStatus() */
+/******************************************************************************/
+
+/***************************************************************************//**
+* PrintPartialStatus
+* 
+* @param[in,out] pScenario scenario holding the fixed test filter, whose
+*  generator supplies the signals
+*
+* @returns       none
+* 
+* @note          identifies the fixed test filter with M-max, sequential and
+*  stochastic partial updates of PARTIAL_TAPS taps (halved for a stretch to
+*  exercise a change of M), prints the samples each takes to reach
+*  CONVERGENCE_THRESH misalignment, and prints pass/fail on all of them
+*  getting there and on the M-max heaps holding the largest inputs after
+*  every sample
+* 
+* @warning       none
+*******************************************************************************/
+static void PrintPartialStatus(AfScenario *pScenario) {
+    static const AfPartialUpdate modes[3] = {
+        AF_PARTIAL_MMAX, AF_PARTIAL_SEQUENTIAL, AF_PARTIAL_STOCHASTIC
+    };
+    double history[NUM_TAPS], buffer[NUM_TAPS], filterWeights[NUM_TAPS];
+    unsigned int rank[2 * NUM_TAPS] = { 0 };
+    unsigned int converged[3] = { 0 };
+    unsigned int i, k, m;
+    double input, desired, smallestTop, largestRest;
+    int pass = 1;
+
+    for ( m = 0; m < 3; m++) {
+        /* circular delay line so blocks straddling the wrap are covered */
+        AfData filter = {
+            .StepSize = STEPSIZE, .Regularization = REGULARIZATION, .Length = NUM_TAPS,
+            .pBuffer = buffer, .pWeights = filterWeights, .Layout = AF_DELAY_CIRCULAR,
+            .Partial = modes[m], .UpdateTaps = PARTIAL_TAPS, .pRank = rank
+        };
+        memset(history, 0, sizeof(history));
+        memset(buffer, 0, sizeof(buffer));
+        memset(filterWeights, 0, sizeof(filterWeights));
+
+        for ( i = 0; i < PARTIAL_ITERATIONS; i++) {
+            input = AfScenarioRandom(pScenario);
+            memmove(history + 1, history, (NUM_TAPS - 1) * sizeof(double));
+            history[0] = input;
+            desired = 0.0;
+            for ( k = 0; k < NUM_TAPS; k++) {
+                desired += pScenario->pTestWeights[k] * history[k];
+            }
+            filter.UpdateTaps = (i >= PARTIAL_ITERATIONS / 2 && i < 3 * PARTIAL_ITERATIONS / 4)
+                                ? PARTIAL_TAPS / 2 : PARTIAL_TAPS;
+            AdaptiveFilterRun(input, desired, &filter);
+
+            if (modes[m] == AF_PARTIAL_MMAX) {
+                smallestTop = INFINITY;
+                largestRest = 0.0;
+                for ( k = 0; k < NUM_TAPS; k++) {
+                    if (k < filter.RankTop) {
+                        smallestTop = fmin(smallestTop, fabs(buffer[rank[k]]));
+                    }
+                    else {
+                        largestRest = fmax(largestRest, fabs(buffer[rank[k]]));
+                    }
+                }
+                if (filter.RankTop != filter.UpdateTaps || smallestTop < largestRest) {
+                    pass = 0;
+                }
+            }
+            if (!converged[m] && 10 * log10( DB_EPSILON +
+                AfScenarioMisalignment(pScenario, filterWeights, NUM_TAPS) ) < CONVERGENCE_THRESH) {
+                converged[m] = i + 1;
+            }
+        }
+        if (!converged[m]) {
+            pass = 0;
+        }
+    }
+
+    printf("Samples to %.0fdB misalignment updating %u of %u taps: M-max %u, sequential %u, stochastic %u\n",
+           CONVERGENCE_THRESH, PARTIAL_TAPS, NUM_TAPS, converged[0], converged[1], converged[2]);
+    printf("%s: Partial-update filters converge\n", pass ? "PASS" : "FAIL");
+}
+/* End of PrintPartialStatus() */
+/******************************************************************************/
+
+/***************************************************************************//**
+* PrintSetMembershipStatus
+* 
+* @param[in,out] pScenario scenario holding the fixed test filter, whose
+*  generator supplies the signals
+*
+* @returns       none
+* 
+* @note          identifies the fixed test filter from a desired signal with
+*  bounded noise using set-membership NLMS, prints the fraction of updates
+*  skipped over the second half of the run and the final misalignment, and
+*  prints pass/fail on both against their thresholds
+* 
+* @warning       none
+*******************************************************************************/
+static void PrintSetMembershipStatus(AfScenario *pScenario) {
+    double history[NUM_TAPS] = { 0 }, buffer[2 * NUM_TAPS] = { 0 };
+    double filterWeights[NUM_TAPS] = { 0 };
+    AfData filter = {
+        .StepSize = STEPSIZE, .Regularization = REGULARIZATION, .Length = NUM_TAPS,
+        .pBuffer = buffer, .pWeights = filterWeights, .Layout = AF_DELAY_MIRRORED,
+        .ErrorBound = SM_ERROR_BOUND
+    };
+    unsigned int i, k;
+    double input, desired, skipped, misalignment;
+
+    for ( i = 0; i < SM_ITERATIONS; i++) {
+        input = AfScenarioRandom(pScenario);
+        memmove(history + 1, history, (NUM_TAPS - 1) * sizeof(double));
+        history[0] = input;
+        desired = SM_NOISE * AfScenarioRandom(pScenario);
+        for ( k = 0; k < NUM_TAPS; k++) {
+            desired += pScenario->pTestWeights[k] * history[k];
+        }
+        if (i == SM_ITERATIONS / 2) {
+            filter.Adaptations = filter.Skipped = 0; /* count steady state only */
+        }
+        AdaptiveFilterRun(input, desired, &filter);
+    }
+    skipped = AdaptiveFilterSkippedFraction(&filter);
+    misalignment = 10 * log10( DB_EPSILON + AfScenarioMisalignment(pScenario, filterWeights, NUM_TAPS) );
+
+    printf("Set-membership NLMS: %.1f%% of updates skipped in steady state, misalignment %.1fdB\n",
+           100.0 * skipped, misalignment);
+    if (skipped < SM_SKIPPED_PASS_THRESH || misalignment > SM_MISALIGNMENT_PASS_THRESH) {
+        printf("FAIL: Set-membership NLMS skips > %.0f%% with misalignment < %.0f\n",
+               100.0 * SM_SKIPPED_PASS_THRESH, SM_MISALIGNMENT_PASS_THRESH);
+    }
+    else {
+        printf("PASS: Set-membership NLMS skips > %.0f%% with misalignment < %.0f\n",
+               100.0 * SM_SKIPPED_PASS_THRESH, SM_MISALIGNMENT_PASS_THRESH);
+    }
+}
+/* End of PrintSetMembershipStatus() */
+/******************************************************************************/
+
+/***************************************************************************//**
+* PrintFrozenStatus
+* 
+* @param[in,out] pScenario scenario whose generator supplies the signals
+*
+* @returns       none
+* 
+* @note          adapts two identical long filters, freezes them for a stage
+*  run one through AdaptiveFilterFir() (FFT blocks and a time-domain tail)
+*  and the other through the Frozen flag, then adapts both again, and
+*  prints pass/fail on the frozen outputs agreeing, the FFT path having
+*  run, and the weights after thawing being bit-identical
+* 
+* @warning       none
+*******************************************************************************/
+static void PrintFrozenStatus(AfScenario *pScenario) {
+    double buffers[2][2 * FROZEN_TAPS] = { { 0 } }, filterWeights[2][FROZEN_TAPS] = { { 0 } };
+    double input[FROZEN_SAMPLES], desired[FROZEN_SAMPLES];
+    double output[2][FROZEN_SAMPLES];
+    double firMem[FROZEN_FIR_MEM_DOUBLES] = { 0 };
+    AfData filters[2] = {
+        { .StepSize = STEPSIZE, .Regularization = REGULARIZATION, .Length = FROZEN_TAPS,
+          .pBuffer = buffers[0], .pWeights = filterWeights[0], .Layout = AF_DELAY_MIRRORED },
+        { .StepSize = STEPSIZE, .Regularization = REGULARIZATION, .Length = FROZEN_TAPS,
+          .pBuffer = buffers[1], .pWeights = filterWeights[1], .Layout = AF_DELAY_MIRRORED }
+    };
+    AfFir fir;
+    unsigned int i, k, stage;
+    int pass;
+
+    pass = AdaptiveFilterFirMemSize(FROZEN_TAPS) <= sizeof(firMem) &&
+           AdaptiveFilterFirInit(&fir, &filters[0], firMem) == 0;
+
+    for ( stage = 0; pass && stage < 3; stage++) {
+        for ( i = 0; i < FROZEN_SAMPLES; i++) {
+            input[i] = AfScenarioRandom(pScenario);
+            desired[i] = AfScenarioRandom(pScenario);
+        }
+        if (stage == 1) {
+            /* frozen: block FIR against the per-sample frozen path */
+            AdaptiveFilterFir(input, output[0], FROZEN_SAMPLES, &fir);
+            filters[1].Frozen = 1;
+            AdaptiveFilterRunBlock(input, desired, output[1], NULL, FROZEN_SAMPLES, &filters[1]);
+            filters[1].Frozen = 0;
+            for ( i = 0; i < FROZEN_SAMPLES; i++) {
+                if (fabs(output[0][i] - output[1][i]) > FROZEN_TOLERANCE) {
+                    pass = 0;
+                }
+            }
+            continue;
+        }
+        for ( k = 0; k < 2; k++) {
+            AdaptiveFilterRunBlock(input, desired, output[k], NULL, FROZEN_SAMPLES, &filters[k]);
+        }
+    }
+
+    if (!pass || fir.FftBlocks == 0 ||
+        memcmp(filterWeights[0], filterWeights[1], sizeof(filterWeights[0])) != 0 ||
+        memcmp(buffers[0], buffers[1], sizeof(buffers[0])) != 0) {
+        pass = 0;
+    }
+    printf("%s: Frozen FIR matches the frozen filter and adaptation resumes\n",
+           pass ? "PASS" : "FAIL");
+}
+/* End of PrintFrozenStatus() */
+/******************************************************************************/
+
+/***************************************************************************//**
+* PrintEnsembleStatus
+* 
+* @param[in]     none
+*
+* @returns       none
+* 
+* @note          runs an ensemble of ENSEMBLE_TRIALS default scenarios on one
+*  thread and on ENSEMBLE_THREADS threads, prints the final mean
+*  misalignment, and prints pass/fail on the bands and per-trial results
+*  being bit-identical and every trial converging
+* 
+* @warning       none
+*******************************************************************************/
+static void PrintEnsembleStatus() {
+    AfScenarioParams params;
+    AfEnsemble ensemble[2];
+    int ready, pass;
+
+    AfScenarioDefaults(&params);
+    params.Iterations = ENSEMBLE_ITERATIONS;
+    ready = AfEnsembleInit(&ensemble[0], &params, ENSEMBLE_TRIALS, ENSEMBLE_DECIMATION) == 0;
+    ready = AfEnsembleInit(&ensemble[1], &params, ENSEMBLE_TRIALS, ENSEMBLE_DECIMATION) == 0 && ready;
+    if (!ready) {
+        printf("FAIL: Ensemble curves do not depend on the thread count\n");
+        AfEnsembleDestroy(&ensemble[0]);
+        AfEnsembleDestroy(&ensemble[1]);
+        return;
+    }
+    AfEnsembleRun(&ensemble[0], 1);
+    AfEnsembleRun(&ensemble[1], ENSEMBLE_THREADS);
+
+    pass = !ensemble[0].Failed && !ensemble[1].Failed &&
+           ensemble[0].Converged == ENSEMBLE_TRIALS &&
+           memcmp(ensemble[0].pBands, ensemble[1].pBands,
+                  sizeof(double) * ensemble[0].Points * AF_ENSEMBLE_COLUMNS) == 0 &&
+           memcmp(ensemble[0].pResults, ensemble[1].pResults,
+                  sizeof(double) * AF_ENSEMBLE_RESULTS * ENSEMBLE_TRIALS) == 0;
+    printf("Ensemble of %u trials: mean misalignment %.1fdB after %u samples, %u converged\n",
+           ENSEMBLE_TRIALS,
+           ensemble[0].pBands[(ensemble[0].Points - 1) * AF_ENSEMBLE_COLUMNS + AF_ENSEMBLE_STATS],
+           ENSEMBLE_ITERATIONS, ensemble[0].Converged);
+    printf("%s: Ensemble curves do not depend on the thread count\n", pass ? "PASS" : "FAIL");
+
+    AfEnsembleDestroy(&ensemble[0]);
+    AfEnsembleDestroy(&ensemble[1]);
+}
+/* End of PrintEnsembleStatus() */
+/******************************************************************************/
+
+/***************************************************************************//**
+* PrintHistogramStatus
+* 
+* @param[in]     none
+*
+* @returns       none
+* 
+* @note          places values at the edges of the linear range, of an
+*  octave and of the overflow bucket, and prints pass/fail on each bucket's
+*  largest value bounding the value from above, on the buckets below the
+*  overflow being under HIST_WIDTH_PASS_THRESH wide, and on percentile 100
+*  being the exact maximum
+* 
+* @warning       none
+*******************************************************************************/
+static void PrintHistogramStatus() {
+    static const uint64_t values[] = {
+        (1ull << 8) - 1, 1ull << 8, (1ull << 9) - 1,
+        (1ull << AF_HIST_MAX_BITS) - 1, 1ull << AF_HIST_MAX_BITS
+    };
+    AfHistogram histogram;
+    uint64_t lower, upper;
+    unsigned int bucket, k;
+    int pass = 1;
+
+    AfHistogramInit(&histogram);
+    for ( k = 0; k < sizeof(values) / sizeof(values[0]); k++) {
+        bucket = AfHistogramBucketIndex(values[k]);
+        upper = AfHistogramBucketValue(bucket);
+        if (upper < values[k]) {
+            pass = 0;
+        }
+        if (values[k] >> AF_HIST_MAX_BITS) {
+            if (bucket != AF_HIST_BUCKETS - 1) {
+                pass = 0; /* only the overflow bucket may be unbounded */
+            }
+        }
+        else {
+            lower = (bucket == 0) ? 0 : AfHistogramBucketValue(bucket - 1) + 1;
+            if (lower > values[k] ||
+                (double)(upper - lower + 1) >= HIST_WIDTH_PASS_THRESH * (double)lower) {
+                pass = 0;
+            }
+        }
+        AfHistogramRecord(&histogram, values[k]);
+    }
+    if (AfHistogramPercentile(&histogram, 100.0) != histogram.Max) {
+        pass = 0;
+    }
+
+    printf("%s: Histogram buckets bound their values to < 1%% and p100 is the maximum\n",
+           pass ? "PASS" : "FAIL");
+}
+/* End of PrintHistogramStatus() */
+/******************************************************************************/
@@ -8,6 +8,27 @@
 #ifndef ADAPTIVEFILTERTEST_H_
 #define ADAPTIVEFILTERTEST_H_
 
-void AdaptiveFilterTestRun();
+#include "AfMetrics.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Output options for AdaptiveFilterTestRun(); all zero prints only the
+ * pass/fail summary.
+ */
+typedef struct {
+    int Verbose; /* print every iteration's metrics to stdout */
+    const char *pMetricsPath; /* NLMS learning curve file, NULL: none */
+    unsigned int Decimation; /* write every Nth iteration, 0 or 1: all */
+    AfMetricsFormat Format; /* AF_METRICS_CSV or AF_METRICS_BINARY */
+} AfTestOptions;
+
+void AdaptiveFilterTestRun(const AfTestOptions *pOptions);
+void AdaptiveFilterTemplateTestRun(void);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif /* ADAPTIVEFILTERTEST_H_ */
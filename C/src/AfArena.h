@@ -0,0 +1,37 @@
+/*
+ * @file AfArena.h
+ *
+ * Header file for AfArena.c, a bump allocator over one 64-byte-aligned block
+ * (optionally backed by huge pages) for carving filter state up front.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+#ifndef AFARENA_H_
+#define AFARENA_H_
+
+#include <stddef.h>
+
+#define AF_ARENA_ALIGN (64) /* alignment of every allocation: a cache line
+                             * and an AVX-512 register */
+#define AF_ARENA_HUGE_PAGES (1u) /* AfArenaInit() flag: back with huge pages */
+#define AF_ARENA_HUGE_PAGE_SIZE (2u * 1024 * 1024) /* size huge-page arenas
+                                                    * are rounded up to */
+
+/* Contains arena state. Allocations are never freed one by one: reset the
+ * arena to reuse it, or destroy it to return the memory.
+ */
+typedef struct {
+	unsigned char *pBase; /* start of the block, AF_ARENA_ALIGN aligned */
+	size_t Size; /* usable bytes */
+	size_t Used; /* bytes handed out, a multiple of AF_ARENA_ALIGN */
+	int Mapped; /* nonzero: pBase came from mmap() rather than malloc */
+	int HugePages; /* nonzero: huge pages were granted (or advised) */
+} AfArena;
+
+int AfArenaInit(AfArena *pArena, size_t bytes, unsigned int flags);
+void *AfArenaAlloc(AfArena *pArena, size_t bytes);
+void AfArenaReset(AfArena *pArena);
+void AfArenaDestroy(AfArena *pArena);
+
+#endif /* AFARENA_H_ */
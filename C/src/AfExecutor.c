@@ -0,0 +1,673 @@
+/*
+ * @file AfExecutor.c
+ *
+ * Persistent work-stealing thread pool for running many adaptive filters a
+ * block at a time. Each run call is one block with a barrier at the end:
+ *
+ *   1. The work is cut into tasks of about AF_EXEC_TASK_BYTES of filter
+ *      state, so a task's weights and delay lines stay in one core's cache
+ *      for the whole block: groups of whole AfData filters, or ranges of
+ *      AF_EXEC_BANK_ALIGN-aligned channels of an AfBank.
+ *   2. Tasks are sorted by cost (taps times samples) and dealt longest
+ *      first to the least loaded worker (LPT scheduling), so filters with
+ *      very different lengths start out balanced.
+ *   3. Every worker, the calling thread included, drains its own deque from
+ *      the expensive end and then steals from the cheap end of the others,
+ *      which evens out whatever imbalance the estimate missed.
+ *
+ * A deque is a fixed array of task indices plus one atomic word packing its
+ * head and tail, so owner pops and thief steals are each a single
+ * compare-and-swap. Tasks never spawn tasks, so a worker that finds every
+ * deque empty is done with the block.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+/******************************************************************************/
+/* include block */
+#include "AfExecutor.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/******************************************************************************/
+/** local definitions **/
+#define NO_TASK (0xFFFFFFFFu)
+#define BANK_TASKS_PER_THREAD (4) /* bank split at least this fine for balance */
+
+typedef enum {
+	JOB_FILTERS = 0,
+	JOB_BANK
+} JobKind;
+
+/* A unit of scheduled work: filters pOrder[First..First+Count) or bank
+ * channels [First, First+Count) */
+typedef struct {
+	unsigned int First;
+	unsigned int Count;
+	unsigned long Cost;
+} Task;
+
+/* Per-worker task deque */
+typedef struct {
+	_Atomic uint64_t Range; /* pSlots[head..tail), head in the low word */
+	unsigned int *pSlots; /* task indices, most expensive first */
+	unsigned int Length; /* tasks dealt to this worker */
+	unsigned long Load; /* cost dealt to this worker */
+	char Pad[64]; /* keeps neighbouring Range words on separate cache lines */
+} Deque;
+
+/* Arguments of a worker thread */
+typedef struct {
+	AfExecutor *pExec;
+	unsigned int Id;
+} Worker;
+
+struct AfExecutor {
+	unsigned int Threads; /* workers, including the calling thread */
+	pthread_t *pThreads; /* Threads - 1 pool threads */
+	Worker *pWorkers;
+	Deque *pDeques; /* one per worker */
+	pthread_mutex_t Lock;
+	pthread_cond_t Start; /* signalled when a block is published */
+	pthread_cond_t Done; /* signalled when the last pool thread finishes */
+	unsigned long Generation; /* block counter, guarded by Lock */
+	unsigned int Busy; /* pool threads still running the block */
+	int Stop; /* set by AfExecutorDestroy() */
+
+	/* current block, written before it is published */
+	JobKind Kind;
+	Task *pTasks;
+	unsigned int TaskCount, TaskCapacity;
+	unsigned int *pOrder; /* filters sorted by descending length */
+	unsigned int *pSlots; /* Threads * TaskCapacity deque storage */
+	unsigned int OrderCapacity;
+	AfExecFilter *pFilters;
+	AfBank *pBank;
+	const double *pInput, *pDesired;
+	double *pOutput, *pError;
+	size_t N;
+};
+
+static void *WorkerMain(void *pArg);
+static void RunBlock(AfExecutor *pExec);
+static void DrainTasks(AfExecutor *pExec, unsigned int self);
+static unsigned int PopTask(Deque *pDeque);
+static unsigned int StealTask(Deque *pDeque);
+static void RunTask(AfExecutor *pExec, const Task *pTask);
+static int ReserveTasks(AfExecutor *pExec, unsigned int tasks);
+static void DealTasks(AfExecutor *pExec);
+static int CompareTaskCost(const void *pA, const void *pB);
+
+/******************************************************************************
+ * AfExecutorCreate
+ *
+ * @param[in]     threads number of workers including the calling thread,
+ *  0 for one per online CPU
+ *
+ * @returns       new executor, or NULL if resources could not be allocated
+ *
+ * @note          Starts threads - 1 pool threads, which sleep between
+ *  blocks.
+ *
+ * @warning       none
+ */
+AfExecutor *AfExecutorCreate(unsigned int threads) {
+	AfExecutor *pExec;
+	long cpus;
+	unsigned int i;
+
+	if (threads == 0) {
+		cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = (cpus > 0) ? (unsigned int)cpus : 1;
+	}
+
+	pExec = (AfExecutor *)calloc(1, sizeof(AfExecutor));
+	if (!pExec) {
+		return NULL;
+	}
+	pExec->Threads = threads;
+	pExec->pThreads = (pthread_t *)calloc(threads, sizeof(pthread_t));
+	pExec->pWorkers = (Worker *)calloc(threads, sizeof(Worker));
+	pExec->pDeques = (Deque *)calloc(threads, sizeof(Deque));
+	if (!pExec->pThreads || !pExec->pWorkers || !pExec->pDeques) {
+		free(pExec->pThreads);
+		free(pExec->pWorkers);
+		free(pExec->pDeques);
+		free(pExec);
+		return NULL;
+	}
+	pthread_mutex_init(&pExec->Lock, NULL);
+	pthread_cond_init(&pExec->Start, NULL);
+	pthread_cond_init(&pExec->Done, NULL);
+
+	for ( i = 0; i < threads; i++ ) {
+		atomic_init(&pExec->pDeques[i].Range, 0);
+		pExec->pWorkers[i].pExec = pExec;
+		pExec->pWorkers[i].Id = i;
+	}
+	for ( i = 1; i < threads; i++ ) {
+		if (pthread_create(&pExec->pThreads[i], NULL, WorkerMain, &pExec->pWorkers[i]) != 0) {
+			pExec->Threads = i; /* run with the threads that did start */
+			break;
+		}
+	}
+
+	return pExec;
+}
+/* End of AfExecutorCreate() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfExecutorDestroy
+ *
+ * @param[in]     pExec executor to destroy (may be NULL)
+ *
+ * @returns       none
+ *
+ * @note          Stops and joins the pool threads and frees the executor.
+ *
+ * @warning       must not be called while a run call is in progress
+ */
+void AfExecutorDestroy(AfExecutor *pExec) {
+	unsigned int i;
+
+	if (!pExec) {
+		return;
+	}
+
+	pthread_mutex_lock(&pExec->Lock);
+	pExec->Stop = 1;
+	pthread_cond_broadcast(&pExec->Start);
+	pthread_mutex_unlock(&pExec->Lock);
+	for ( i = 1; i < pExec->Threads; i++ ) {
+		pthread_join(pExec->pThreads[i], NULL);
+	}
+
+	pthread_cond_destroy(&pExec->Done);
+	pthread_cond_destroy(&pExec->Start);
+	pthread_mutex_destroy(&pExec->Lock);
+	free(pExec->pTasks);
+	free(pExec->pOrder);
+	free(pExec->pSlots);
+	free(pExec->pDeques);
+	free(pExec->pWorkers);
+	free(pExec->pThreads);
+	free(pExec);
+}
+/* End of AfExecutorDestroy() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfExecutorThreads
+ *
+ * @param[in]     pExec executor
+ *
+ * @returns       number of workers, including the calling thread
+ *
+ * @note          none
+ *
+ * @warning       none
+ */
+unsigned int AfExecutorThreads(const AfExecutor *pExec) {
+	return pExec->Threads;
+}
+/* End of AfExecutorThreads() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfExecutorRunFilters
+ *
+ * @param[in,out] pExec    executor
+ * @param[in,out] pFilters count filters, each with its own block of signals
+ * @param[in]     count    number of filters
+ * @param[in]     n        number of samples in every filter's block
+ *
+ * @returns       none
+ *
+ * @note          Runs AdaptiveFilterRunBlock() on every filter across the
+ *  pool and returns when all have finished. Results are identical to
+ *  calling it for each filter in turn.
+ *
+ * @warning       the filters must be distinct and their signal blocks must
+ *  not overlap one another's outputs
+ */
+void AfExecutorRunFilters(AfExecutor *pExec, AfExecFilter *pFilters,
+                          unsigned int count, size_t n) {
+	Task *pTasks;
+	size_t bytes, groupBytes;
+	unsigned int i, tasks;
+
+	if (count == 0 || !ReserveTasks(pExec, count)) {
+		for ( i = 0; i < count; i++ ) {
+			AdaptiveFilterRunBlock(pFilters[i].pInput, pFilters[i].pDesired,
+			                       pFilters[i].pOutput, pFilters[i].pError, n,
+			                       pFilters[i].pData);
+		}
+		return;
+	}
+	pTasks = pExec->pTasks;
+
+	/* longest filters first */
+	for ( i = 0; i < count; i++ ) {
+		pTasks[i].First = i;
+		pTasks[i].Count = 1;
+		pTasks[i].Cost = pFilters[i].pData->Length;
+	}
+	qsort(pTasks, count, sizeof(Task), CompareTaskCost);
+	for ( i = 0; i < count; i++ ) {
+		pExec->pOrder[i] = pTasks[i].First;
+	}
+
+	/* group neighbours of similar length into cache-sized tasks; weights
+	 * plus a mirrored delay line are 3 * Length doubles */
+	tasks = 0;
+	groupBytes = 0;
+	for ( i = 0; i < count; i++ ) {
+		bytes = 3 * (size_t)pFilters[pExec->pOrder[i]].pData->Length * sizeof(double);
+		if (tasks > 0 && groupBytes + bytes <= AF_EXEC_TASK_BYTES) {
+			pTasks[tasks - 1].Count++;
+			pTasks[tasks - 1].Cost += pFilters[pExec->pOrder[i]].pData->Length;
+			groupBytes += bytes;
+		}
+		else {
+			pTasks[tasks].First = i;
+			pTasks[tasks].Count = 1;
+			pTasks[tasks].Cost = pFilters[pExec->pOrder[i]].pData->Length;
+			groupBytes = bytes;
+			tasks++;
+		}
+	}
+	qsort(pTasks, tasks, sizeof(Task), CompareTaskCost);
+
+	pExec->Kind = JOB_FILTERS;
+	pExec->TaskCount = tasks;
+	pExec->pFilters = pFilters;
+	pExec->N = n;
+	RunBlock(pExec);
+}
+/* End of AfExecutorRunFilters() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfExecutorRunBank
+ *
+ * @param[in,out] pExec   executor
+ * @param[in]     input   n frames of Channels interleaved input samples
+ * @param[in]     desired n frames of Channels interleaved desired samples
+ * @param[out]    output  n frames of outputs, same layout (may be NULL)
+ * @param[out]    error   n frames of errors, same layout (may be NULL)
+ * @param[in]     n       number of frames
+ * @param[in,out] pBank   filter bank
+ *
+ * @returns       none
+ *
+ * @note          Parallel AdaptiveFilterBankRunBlock(): the channels are
+ *  split into AF_EXEC_BANK_ALIGN-aligned ranges run with
+ *  AdaptiveFilterBankRunChannels(), then the delay line is advanced once.
+ *  Results are identical to the serial call.
+ *
+ * @warning       input and desired must not alias output or error
+ */
+void AfExecutorRunBank(AfExecutor *pExec, const double *input,
+                       const double *desired, double *output, double *error,
+                       size_t n, AfBank *pBank) {
+	const unsigned int channels = pBank->Channels;
+	size_t rowBytes = 3 * (size_t)pBank->Length * sizeof(double);
+	unsigned int span, fine, tasks, i;
+
+	if (!pBank->pKernels) {
+		pBank->pKernels = AfKernelsGet(AF_ISA_AUTO); /* before the ranges share it */
+	}
+
+	/* channels per task: fit the cache budget, but cut finely enough to
+	 * balance, in whole cache lines of each row */
+	span = (unsigned int)(AF_EXEC_TASK_BYTES / (rowBytes ? rowBytes : 1));
+	fine = (channels + BANK_TASKS_PER_THREAD * pExec->Threads - 1) /
+	       (BANK_TASKS_PER_THREAD * pExec->Threads);
+	if (fine < span) {
+		span = fine;
+	}
+	span = (span + AF_EXEC_BANK_ALIGN - 1) / AF_EXEC_BANK_ALIGN * AF_EXEC_BANK_ALIGN;
+	if (span == 0) {
+		span = AF_EXEC_BANK_ALIGN;
+	}
+	tasks = (channels + span - 1) / span;
+
+	if (tasks == 0 || !ReserveTasks(pExec, tasks)) {
+		AdaptiveFilterBankRunBlock(input, desired, output, error, n, pBank);
+		return;
+	}
+	for ( i = 0; i < tasks; i++ ) {
+		pExec->pTasks[i].First = i * span;
+		pExec->pTasks[i].Count = (channels - i * span < span) ? channels - i * span : span;
+		pExec->pTasks[i].Cost = (unsigned long)pExec->pTasks[i].Count * pBank->Length;
+	}
+	qsort(pExec->pTasks, tasks, sizeof(Task), CompareTaskCost);
+
+	pExec->Kind = JOB_BANK;
+	pExec->TaskCount = tasks;
+	pExec->pBank = pBank;
+	pExec->pInput = input;
+	pExec->pDesired = desired;
+	pExec->pOutput = output;
+	pExec->pError = error;
+	pExec->N = n;
+	RunBlock(pExec);
+
+	AdaptiveFilterBankAdvance(n, pBank);
+}
+/* End of AfExecutorRunBank() */
+/******************************************************************************/
+
+/** internal functions **/
+
+/***************************************************************************//**
+* WorkerMain
+*
+* @param[in]     pArg pointer to the thread's Worker
+*
+* @returns       NULL
+*
+* @note          Pool thread loop: sleep until a block is published, drain
+*  tasks, report completion.
+*
+* @warning       none
+*******************************************************************************/
+static void *WorkerMain(void *pArg) {
+	const Worker *pWorker = (const Worker *)pArg;
+	AfExecutor *pExec = pWorker->pExec;
+	unsigned long seen = 0;
+
+	for (;;) {
+		pthread_mutex_lock(&pExec->Lock);
+		while (!pExec->Stop && pExec->Generation == seen) {
+			pthread_cond_wait(&pExec->Start, &pExec->Lock);
+		}
+		if (pExec->Stop) {
+			pthread_mutex_unlock(&pExec->Lock);
+			return NULL;
+		}
+		seen = pExec->Generation;
+		pthread_mutex_unlock(&pExec->Lock);
+
+		DrainTasks(pExec, pWorker->Id);
+
+		pthread_mutex_lock(&pExec->Lock);
+		if (--pExec->Busy == 0) {
+			pthread_cond_signal(&pExec->Done);
+		}
+		pthread_mutex_unlock(&pExec->Lock);
+	}
+}
+/* End of WorkerMain()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* RunBlock
+*
+* @param[in,out] pExec executor with the current block's tasks set up
+*
+* @returns       none
+*
+* @note          Deals the tasks, wakes the pool, works as worker 0 and
+*  waits for the pool at the barrier.
+*
+* @warning       none
+*******************************************************************************/
+static void RunBlock(AfExecutor *pExec) {
+	DealTasks(pExec);
+
+	if (pExec->Threads > 1) {
+		pthread_mutex_lock(&pExec->Lock);
+		pExec->Busy = pExec->Threads - 1;
+		pExec->Generation++;
+		pthread_cond_broadcast(&pExec->Start);
+		pthread_mutex_unlock(&pExec->Lock);
+	}
+
+	DrainTasks(pExec, 0);
+
+	if (pExec->Threads > 1) {
+		pthread_mutex_lock(&pExec->Lock);
+		while (pExec->Busy > 0) {
+			pthread_cond_wait(&pExec->Done, &pExec->Lock);
+		}
+		pthread_mutex_unlock(&pExec->Lock);
+	}
+}
+/* End of RunBlock()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* DrainTasks
+*
+* @param[in,out] pExec executor
+* @param[in]     self  index of the calling worker
+*
+* @returns       none
+*
+* @note          Runs the worker's own tasks, then steals from the other
+*  workers in turn until a full pass finds nothing.
+*
+* @warning       none
+*******************************************************************************/
+static void DrainTasks(AfExecutor *pExec, unsigned int self) {
+	const unsigned int threads = pExec->Threads;
+	unsigned int task, victim, k;
+
+	while ((task = PopTask(&pExec->pDeques[self])) != NO_TASK) {
+		RunTask(pExec, &pExec->pTasks[task]);
+	}
+
+	for ( k = 1; k < threads; k++ ) {
+		victim = (self + k) % threads;
+		while ((task = StealTask(&pExec->pDeques[victim])) != NO_TASK) {
+			RunTask(pExec, &pExec->pTasks[task]);
+			k = 0; /* something was left: rescan every deque after this one */
+		}
+	}
+}
+/* End of DrainTasks()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* PopTask
+*
+* @param[in,out] pDeque the calling worker's deque
+*
+* @returns       index of the most expensive remaining task, or NO_TASK
+*
+* @note          Takes from the head with one compare-and-swap.
+*
+* @warning       none
+*******************************************************************************/
+static unsigned int PopTask(Deque *pDeque) {
+	uint64_t range = atomic_load(&pDeque->Range);
+	uint32_t head, tail;
+
+	do {
+		head = (uint32_t)range;
+		tail = (uint32_t)(range >> 32);
+		if (head >= tail) {
+			return NO_TASK;
+		}
+	} while (!atomic_compare_exchange_weak(&pDeque->Range, &range,
+	                                       ((uint64_t)tail << 32) | (head + 1)));
+
+	return pDeque->pSlots[head];
+}
+/* End of PopTask()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* StealTask
+*
+* @param[in,out] pDeque another worker's deque
+*
+* @returns       index of the cheapest remaining task, or NO_TASK
+*
+* @note          Takes from the tail with one compare-and-swap, so thieves
+*  pick up the small tasks and leave the large ones to the owner.
+*
+* @warning       none
+*******************************************************************************/
+static unsigned int StealTask(Deque *pDeque) {
+	uint64_t range = atomic_load(&pDeque->Range);
+	uint32_t head, tail;
+
+	do {
+		head = (uint32_t)range;
+		tail = (uint32_t)(range >> 32);
+		if (head >= tail) {
+			return NO_TASK;
+		}
+	} while (!atomic_compare_exchange_weak(&pDeque->Range, &range,
+	                                       ((uint64_t)(tail - 1) << 32) | head));
+
+	return pDeque->pSlots[tail - 1];
+}
+/* End of StealTask()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* RunTask
+*
+* @param[in,out] pExec executor
+* @param[in]     pTask task to run
+*
+* @returns       none
+*
+* @note          none
+*
+* @warning       none
+*******************************************************************************/
+static void RunTask(AfExecutor *pExec, const Task *pTask) {
+	const AfExecFilter *pFilter;
+	unsigned int i;
+
+	if (pExec->Kind == JOB_BANK) {
+		AdaptiveFilterBankRunChannels(pExec->pInput, pExec->pDesired, pExec->pOutput,
+		                              pExec->pError, pExec->N, pTask->First,
+		                              pTask->Count, pExec->pBank);
+		return;
+	}
+
+	for ( i = pTask->First; i < pTask->First + pTask->Count; i++ ) {
+		pFilter = &pExec->pFilters[pExec->pOrder[i]];
+		AdaptiveFilterRunBlock(pFilter->pInput, pFilter->pDesired, pFilter->pOutput,
+		                       pFilter->pError, pExec->N, pFilter->pData);
+	}
+}
+/* End of RunTask()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* ReserveTasks
+*
+* @param[in,out] pExec executor
+* @param[in]     tasks number of tasks (and filters) the block needs
+*
+* @returns       1 on success, 0 if memory could not be allocated
+*
+* @note          Grows the task, order and deque arrays; they are kept
+*  between blocks so steady-state runs do not allocate.
+*
+* @warning       none
+*******************************************************************************/
+static int ReserveTasks(AfExecutor *pExec, unsigned int tasks) {
+	Task *pTasks;
+	unsigned int *pOrder, *pSlots;
+
+	if (tasks <= pExec->TaskCapacity) {
+		return 1;
+	}
+
+	pTasks = (Task *)malloc(tasks * sizeof(Task));
+	pOrder = (unsigned int *)malloc(tasks * sizeof(unsigned int));
+	pSlots = (unsigned int *)malloc((size_t)tasks * pExec->Threads * sizeof(unsigned int));
+	if (!pTasks || !pOrder || !pSlots) {
+		free(pTasks);
+		free(pOrder);
+		free(pSlots);
+		return 0;
+	}
+
+	free(pExec->pTasks);
+	free(pExec->pOrder);
+	free(pExec->pSlots);
+	pExec->pTasks = pTasks;
+	pExec->pOrder = pOrder;
+	pExec->pSlots = pSlots;
+	pExec->TaskCapacity = tasks;
+
+	return 1;
+}
+/* End of ReserveTasks()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* DealTasks
+*
+* @param[in,out] pExec executor with pTasks sorted by descending cost
+*
+* @returns       none
+*
+* @note          LPT scheduling: each task in turn goes to the worker with
+*  the least cost so far, so every deque is also in descending cost order.
+*
+* @warning       none
+*******************************************************************************/
+static void DealTasks(AfExecutor *pExec) {
+	const unsigned int threads = pExec->Threads;
+	Deque *pDeque;
+	unsigned int i, w, best;
+
+	for ( w = 0; w < threads; w++ ) {
+		pExec->pDeques[w].pSlots = pExec->pSlots + (size_t)w * pExec->TaskCapacity;
+		pExec->pDeques[w].Length = 0;
+		pExec->pDeques[w].Load = 0;
+	}
+
+	for ( i = 0; i < pExec->TaskCount; i++ ) {
+		for ( w = 1, best = 0; w < threads; w++ ) {
+			if (pExec->pDeques[w].Load < pExec->pDeques[best].Load) {
+				best = w;
+			}
+		}
+		pDeque = &pExec->pDeques[best];
+		pDeque->pSlots[pDeque->Length++] = i;
+		pDeque->Load += pExec->pTasks[i].Cost;
+	}
+
+	for ( w = 0; w < threads; w++ ) {
+		atomic_store(&pExec->pDeques[w].Range, (uint64_t)pExec->pDeques[w].Length << 32);
+	}
+}
+/* End of DealTasks()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* CompareTaskCost
+*
+* @param[in]     pA pointer to a Task
+* @param[in]     pB pointer to a Task
+*
+* @returns       qsort() ordering for descending cost, ties by First
+*
+* @note          none
+*
+* @warning       none
+*******************************************************************************/
+static int CompareTaskCost(const void *pA, const void *pB) {
+	const Task *pTaskA = (const Task *)pA, *pTaskB = (const Task *)pB;
+
+	if (pTaskA->Cost != pTaskB->Cost) {
+		return (pTaskA->Cost < pTaskB->Cost) ? 1 : -1;
+	}
+	return (pTaskA->First > pTaskB->First) - (pTaskA->First < pTaskB->First);
+}
+/* End of CompareTaskCost()*/
+/******************************************************************************/
@@ -0,0 +1,44 @@
+/*
+ * @file AfExecutor.h
+ *
+ * Header file for AfExecutor.c, a persistent work-stealing thread pool that
+ * runs many adaptive filters, or the channels of a filter bank, a block at a
+ * time across cores.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+#ifndef AFEXECUTOR_H_
+#define AFEXECUTOR_H_
+
+#include <stddef.h>
+#include "AdaptiveFilter.h"
+#include "AdaptiveFilterBank.h"
+
+#define AF_EXEC_TASK_BYTES (128 * 1024) /* filter state per task, about half
+                                         * a typical per-core L2 cache */
+#define AF_EXEC_BANK_ALIGN (8) /* bank tasks start on a 64-byte boundary of
+                                * each row of doubles */
+
+/* One filter of a set run by AfExecutorRunFilters(), with its block of
+ * signals; the fields match the arguments of AdaptiveFilterRunBlock() */
+typedef struct {
+	AfData *pData; /* filter parameter/state struct */
+	const double *pInput; /* n input signal samples */
+	const double *pDesired; /* n desired signal samples */
+	double *pOutput; /* n outputs (may be NULL) */
+	double *pError; /* n errors (may be NULL) */
+} AfExecFilter;
+
+typedef struct AfExecutor AfExecutor;
+
+AfExecutor *AfExecutorCreate(unsigned int threads);
+void AfExecutorDestroy(AfExecutor *pExec);
+unsigned int AfExecutorThreads(const AfExecutor *pExec);
+void AfExecutorRunFilters(AfExecutor *pExec, AfExecFilter *pFilters,
+                          unsigned int count, size_t n);
+void AfExecutorRunBank(AfExecutor *pExec, const double *input,
+                       const double *desired, double *output, double *error,
+                       size_t n, AfBank *pBank);
+
+#endif /* AFEXECUTOR_H_ */
@@ -0,0 +1,255 @@
+/*
+ * @file AfFft.c
+ *
+ * Self-contained real FFT for power-of-two sizes. A real transform of
+ * length Size is computed as a complex transform of length Size/2 on the
+ * even/odd sample pairs, followed by a split step that separates the two
+ * interleaved half-length spectra. The complex transform is an iterative
+ * radix-2 decimation-in-time FFT working in place.
+ *
+ * Tables are computed once by AfFftInit() in caller-provided memory; the
+ * transforms themselves do not allocate.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+/******************************************************************************/
+/* include block */
+#include "AfFft.h"
+#include <math.h>
+
+/******************************************************************************/
+/** local definitions **/
+#define AF_PI (3.14159265358979323846)
+
+static void ComplexFft(const AfFft *pFft, double *pData);
+
+/******************************************************************************
+ * AfFftMemSize
+ *
+ * @param[in]     size real transform length
+ *
+ * @returns       number of bytes AfFftInit() needs for the tables
+ *
+ * @note          none
+ *
+ * @warning       none
+ */
+size_t AfFftMemSize(unsigned int size) {
+	return (size / 2) * 2 * sizeof(double) + (size / 2) * sizeof(unsigned int);
+}
+/* End of AfFftMemSize() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfFftInit
+ *
+ * @param[out]    pFft  pointer to FFT struct to initialize
+ * @param[in]     size  real transform length, a power of two >= 4
+ * @param[in]     pMem  AfFftMemSize(size) bytes, aligned for double
+ *
+ * @returns       0 on success, -1 if size is not a power of two >= 4
+ *
+ * @note          Computes the twiddle and bit reversal tables.
+ *
+ * @warning       pMem must stay valid for as long as pFft is used
+ */
+int AfFftInit(AfFft *pFft, unsigned int size, void *pMem) {
+	unsigned int half = size / 2, bits = 0, i, j, r;
+
+	if (size < 4 || (size & (size - 1)) != 0) {
+		return -1;
+	}
+	while ((1u << bits) < half) {
+		bits++;
+	}
+
+	pFft->Size = size;
+	pFft->pTwiddle = (double *)pMem;
+	pFft->pBitReverse = (unsigned int *)(pFft->pTwiddle + 2 * half);
+
+	for ( i = 0; i < half; i++ ) {
+		pFft->pTwiddle[2 * i] = cos(2.0 * AF_PI * i / size);
+		pFft->pTwiddle[2 * i + 1] = -sin(2.0 * AF_PI * i / size);
+
+		for ( j = 0, r = 0; j < bits; j++ ) {
+			r |= ((i >> j) & 1u) << (bits - 1 - j);
+		}
+		pFft->pBitReverse[i] = r;
+	}
+
+	return 0;
+}
+/* End of AfFftInit() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfFftForward
+ *
+ * @param[in]     pFft  pointer to initialized FFT struct
+ * @param[in]     pIn   Size real samples
+ * @param[out]    pOut  Size/2 + 1 complex bins (Size + 2 doubles)
+ *
+ * @returns       none
+ *
+ * @note          Unnormalized forward transform,
+ *  X[k] = sum x[n] exp(-2*pi*i*k*n/Size). pIn may equal pOut.
+ *
+ * @warning       none
+ */
+void AfFftForward(const AfFft *pFft, const double *pIn, double *pOut) {
+	const unsigned int half = pFft->Size / 2;
+	const double *pTw = pFft->pTwiddle;
+	double er, ei, or_, oi, tr, ti, zr, zi, cr, ci;
+	unsigned int i, k;
+
+	/* the input viewed as half complex samples x[2n] + i*x[2n+1] */
+	if (pOut != pIn) {
+		for ( i = 0; i < pFft->Size; i++ ) {
+			pOut[i] = pIn[i];
+		}
+	}
+	ComplexFft(pFft, pOut);
+
+	/* split: E[k] = (Z[k] + conj(Z[half-k])) / 2,
+	 *        O[k] = (Z[k] - conj(Z[half-k])) / 2i,  X[k] = E[k] + W^k O[k] */
+	zr = pOut[0];
+	zi = pOut[1];
+	pOut[0] = zr + zi;
+	pOut[1] = 0.0;
+	pOut[2 * half] = zr - zi;
+	pOut[2 * half + 1] = 0.0;
+
+	for ( k = 1; k <= half / 2; k++ ) {
+		zr = pOut[2 * k];
+		zi = pOut[2 * k + 1];
+		cr = pOut[2 * (half - k)];
+		ci = -pOut[2 * (half - k) + 1];
+
+		er = 0.5 * (zr + cr);
+		ei = 0.5 * (zi + ci);
+		or_ = 0.5 * (zi - ci);
+		oi = -0.5 * (zr - cr);
+
+		/* X[k] = E + W^k O */
+		tr = pTw[2 * k] * or_ - pTw[2 * k + 1] * oi;
+		ti = pTw[2 * k] * oi + pTw[2 * k + 1] * or_;
+		pOut[2 * k] = er + tr;
+		pOut[2 * k + 1] = ei + ti;
+
+		/* X[half-k] = conj(E - W^k O) */
+		pOut[2 * (half - k)] = er - tr;
+		pOut[2 * (half - k) + 1] = -(ei - ti);
+	}
+}
+/* End of AfFftForward() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfFftInverse
+ *
+ * @param[in]     pFft  pointer to initialized FFT struct
+ * @param[in]     pIn   Size/2 + 1 complex bins (Size + 2 doubles)
+ * @param[out]    pOut  Size real samples
+ *
+ * @returns       none
+ *
+ * @note          Inverse of AfFftForward() including the 1/Size scaling.
+ *  The imaginary parts of the DC and Nyquist bins are ignored.
+ *
+ * @warning       pIn must not alias pOut
+ */
+void AfFftInverse(const AfFft *pFft, const double *pIn, double *pOut) {
+	const unsigned int half = pFft->Size / 2;
+	const double *pTw = pFft->pTwiddle;
+	const double scale = 1.0 / half;
+	double er, ei, dr, di, or_, oi, xr, xi, cr, ci;
+	unsigned int i, k;
+
+	/* rebuild Z[k] = E[k] + i*O[k] with E = (X[k] + conj(X[half-k])) / 2
+	 * and O = (X[k] - conj(X[half-k])) / (2 W^k); conjugated so the forward
+	 * complex transform computes the inverse */
+	for ( k = 0; k < half; k++ ) {
+		xr = pIn[2 * k];
+		xi = (k == 0) ? 0.0 : pIn[2 * k + 1];
+		cr = pIn[2 * (half - k)];
+		ci = (k == 0) ? 0.0 : -pIn[2 * (half - k) + 1];
+
+		er = 0.5 * (xr + cr);
+		ei = 0.5 * (xi + ci);
+		dr = 0.5 * (xr - cr);
+		di = 0.5 * (xi - ci);
+
+		/* divide by W^k: multiply by its conjugate */
+		or_ = dr * pTw[2 * k] + di * pTw[2 * k + 1];
+		oi = di * pTw[2 * k] - dr * pTw[2 * k + 1];
+
+		pOut[2 * k] = er - oi;
+		pOut[2 * k + 1] = -(ei + or_);
+	}
+
+	ComplexFft(pFft, pOut);
+
+	for ( i = 0; i < half; i++ ) {
+		pOut[2 * i] *= scale;
+		pOut[2 * i + 1] *= -scale;
+	}
+}
+/* End of AfFftInverse() */
+/******************************************************************************/
+
+/** internal functions **/
+
+/***************************************************************************//**
+* ComplexFft
+*
+* @param[in]     pFft  pointer to initialized FFT struct
+* @param[in,out] pData Size/2 interleaved complex samples, transformed in place
+*
+* @returns       none
+*
+* @note          Iterative radix-2 decimation-in-time FFT of length Size/2.
+*  The twiddles of the half-length transform are every other entry of the
+*  real transform's table.
+*
+* @warning       none
+*******************************************************************************/
+static void ComplexFft(const AfFft *pFft, double *pData) {
+	const unsigned int n = pFft->Size / 2;
+	const double *pTw = pFft->pTwiddle;
+	double tr, ti, wr, wi, t;
+	unsigned int i, j, span, start, stride;
+
+	for ( i = 0; i < n; i++ ) {
+		j = pFft->pBitReverse[i];
+		if (j > i) {
+			t = pData[2 * i];
+			pData[2 * i] = pData[2 * j];
+			pData[2 * j] = t;
+			t = pData[2 * i + 1];
+			pData[2 * i + 1] = pData[2 * j + 1];
+			pData[2 * j + 1] = t;
+		}
+	}
+
+	for ( span = 1, stride = n; span < n; span *= 2 ) {
+		/* twiddle step for butterflies of length 2*span is n/span entries
+		 * of the half-length table, i.e. 2*n/span of this table */
+		stride /= 2;
+		for ( start = 0; start < n; start += 2 * span ) {
+			for ( j = 0; j < span; j++ ) {
+				wr = pTw[4 * j * stride];
+				wi = pTw[4 * j * stride + 1];
+				i = start + j;
+				tr = wr * pData[2 * (i + span)] - wi * pData[2 * (i + span) + 1];
+				ti = wr * pData[2 * (i + span) + 1] + wi * pData[2 * (i + span)];
+				pData[2 * (i + span)] = pData[2 * i] - tr;
+				pData[2 * (i + span) + 1] = pData[2 * i + 1] - ti;
+				pData[2 * i] += tr;
+				pData[2 * i + 1] += ti;
+			}
+		}
+	}
+}
+/* End of ComplexFft()*/
+/******************************************************************************/
@@ -0,0 +1,31 @@
+/*
+ * @file AfFft.h
+ *
+ * Header file for AfFft.c, a self-contained radix-2 real FFT used by the
+ * frequency-domain adaptive filters.
+ *
+ * Spectra of a real signal of length Size are stored as the Size/2 + 1
+ * non-negative frequency bins, real and imaginary parts interleaved, i.e.
+ * Size + 2 doubles.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+#ifndef AFFFT_H_
+#define AFFFT_H_
+
+#include <stddef.h>
+
+/* Contains real FFT size and tables */
+typedef struct {
+	unsigned int Size; /* real transform length, a power of two >= 4 */
+	double *pTwiddle; /* Size/2 complex twiddles exp(-2*pi*i*k/Size) */
+	unsigned int *pBitReverse; /* Size/2 bit-reversed indices */
+} AfFft;
+
+size_t AfFftMemSize(unsigned int size);
+int AfFftInit(AfFft *pFft, unsigned int size, void *pMem);
+void AfFftForward(const AfFft *pFft, const double *pIn, double *pOut);
+void AfFftInverse(const AfFft *pFft, const double *pIn, double *pOut);
+
+#endif /* AFFFT_H_ */
@@ -0,0 +1,173 @@
+/*
+ * @file AfHistogram.c
+ *
+ * Log-linear histogram in the style of HdrHistogram. With S =
+ * AF_HIST_SUB_BITS, values below 2^S get a bucket each. Every octave
+ * [2^k, 2^(k+1)) above that is split into 2^(S-1) equal buckets, so a
+ * bucket is at most 2^-(S-1) of its value wide, up to 2^AF_HIST_MAX_BITS - 1.
+ * Larger values go to one overflow bucket. Percentiles are reported
+ * as the largest value of the bucket they fall in, capped at the exact
+ * maximum, so they never understate a latency.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+/******************************************************************************/
+/* include block */
+#include "AfHistogram.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define SUB_COUNT (1u << AF_HIST_SUB_BITS) /* linear buckets */
+#define HALF_COUNT (1u << (AF_HIST_SUB_BITS - 1)) /* buckets per octave above */
+#define OVERFLOW_BUCKET (AF_HIST_BUCKETS - 1) /* values from 2^AF_HIST_MAX_BITS */
+
+/******************************************************************************
+ * AfHistogramInit
+ *
+ * @param[out]    pHist histogram to clear
+ *
+ * @returns       none
+ *
+ * @note          none
+ *
+ * @warning       none
+ */
+void AfHistogramInit(AfHistogram *pHist) {
+	unsigned int i;
+
+	for ( i = 0; i < AF_HIST_BUCKETS; i++ ) {
+		pHist->Counts[i] = 0;
+	}
+	pHist->Count = 0;
+	pHist->Min = UINT64_MAX;
+	pHist->Max = 0;
+	pHist->Sum = 0.0;
+}
+/* End of AfHistogramInit() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfHistogramRecord
+ *
+ * @param[in,out] pHist histogram
+ * @param[in]     value value to count
+ *
+ * @returns       none
+ *
+ * @note          O(AF_HIST_MAX_BITS) at worst, no allocation.
+ *
+ * @warning       none
+ */
+void AfHistogramRecord(AfHistogram *pHist, uint64_t value) {
+	pHist->Counts[AfHistogramBucketIndex(value)]++;
+	pHist->Count++;
+	pHist->Sum += (double)value;
+	if (value < pHist->Min) {
+		pHist->Min = value;
+	}
+	if (value > pHist->Max) {
+		pHist->Max = value;
+	}
+}
+/* End of AfHistogramRecord() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfHistogramPercentile
+ *
+ * @param[in]     pHist      histogram
+ * @param[in]     percentile 0 to 100
+ *
+ * @returns       smallest bucket value that at least percentile percent of
+ *  the values do not exceed (nearest rank), 0 if the histogram is empty
+ *
+ * @note          The result is the bucket's largest value, capped at Max,
+ *  so 100 returns Max exactly.
+ *
+ * @warning       none
+ */
+uint64_t AfHistogramPercentile(const AfHistogram *pHist, double percentile) {
+	uint64_t rank, seen = 0, value;
+	unsigned int i;
+
+	if (pHist->Count == 0) {
+		return 0;
+	}
+	rank = (uint64_t)(percentile / 100.0 * (double)pHist->Count + 0.999999);
+	if (rank < 1) {
+		rank = 1;
+	}
+
+	for ( i = 0; i < AF_HIST_BUCKETS; i++ ) {
+		seen += pHist->Counts[i];
+		if (seen >= rank) {
+			break;
+		}
+	}
+	value = (i < AF_HIST_BUCKETS) ? AfHistogramBucketValue(i) : pHist->Max;
+
+	return (value < pHist->Max) ? value : pHist->Max;
+}
+/* End of AfHistogramPercentile() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfHistogramBucketIndex
+ *
+ * @param[in]     value value to place
+ *
+ * @returns       index of the bucket counting value
+ *
+ * @note          Above the linear range the shift keeps the top S bits of
+ *  the value, whose leading one makes the mantissa 2^(S-1) to 2^S - 1.
+ *
+ * @warning       none
+ */
+unsigned int AfHistogramBucketIndex(uint64_t value) {
+	unsigned int shift = 0;
+
+	if (value < SUB_COUNT) {
+		return (unsigned int)value;
+	}
+	if (value >> AF_HIST_MAX_BITS) {
+		return OVERFLOW_BUCKET;
+	}
+	while ((value >> shift) >= SUB_COUNT) {
+		shift++;
+	}
+
+	return SUB_COUNT + (shift - 1) * HALF_COUNT + (unsigned int)((value >> shift) - HALF_COUNT);
+}
+/* End of AfHistogramBucketIndex() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfHistogramBucketValue
+ *
+ * @param[in]     bucket bucket index below AF_HIST_BUCKETS
+ *
+ * @returns       largest value counted in the bucket, UINT64_MAX for the
+ *  overflow bucket
+ *
+ * @note          For writing out the distribution bucket by bucket.
+ *
+ * @warning       none
+ */
+uint64_t AfHistogramBucketValue(unsigned int bucket) {
+	unsigned int shift;
+	uint64_t mantissa;
+
+	if (bucket < SUB_COUNT) {
+		return bucket;
+	}
+	if (bucket >= OVERFLOW_BUCKET) {
+		return UINT64_MAX;
+	}
+	shift = (bucket - SUB_COUNT) / HALF_COUNT + 1;
+	mantissa = (bucket - SUB_COUNT) % HALF_COUNT + HALF_COUNT;
+
+	return ((mantissa + 1) << shift) - 1;
+}
+/* End of AfHistogramBucketValue() */
+/******************************************************************************/
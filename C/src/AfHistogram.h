@@ -0,0 +1,40 @@
+/*
+ * @file AfHistogram.h
+ *
+ * Header file for AfHistogram.c, a fixed-size log-linear (HDR-style)
+ * histogram of non-negative integer values such as call latencies in
+ * nanoseconds, with percentile queries.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+#ifndef AFHISTOGRAM_H_
+#define AFHISTOGRAM_H_
+
+#include <stdint.h>
+
+#define AF_HIST_SUB_BITS (8) /* values below 2^8 are exact, larger ones fall
+                              * in buckets under 1% wide */
+#define AF_HIST_MAX_BITS (40) /* values from 2^40 (ns: about 18 minutes) on
+                               * share the last, overflow bucket */
+#define AF_HIST_BUCKETS ((1u << AF_HIST_SUB_BITS) + \
+                         (AF_HIST_MAX_BITS - AF_HIST_SUB_BITS) * (1u << (AF_HIST_SUB_BITS - 1)) + 1)
+
+/* Contains histogram counts and exact summary values. Recording never
+ * allocates, so it may run next to a real-time loop.
+ */
+typedef struct {
+	uint64_t Counts[AF_HIST_BUCKETS]; /* values per bucket */
+	uint64_t Count; /* values recorded */
+	uint64_t Min; /* smallest value recorded, exact */
+	uint64_t Max; /* largest value recorded, exact */
+	double Sum; /* sum of the values, for the mean */
+} AfHistogram;
+
+void AfHistogramInit(AfHistogram *pHist);
+void AfHistogramRecord(AfHistogram *pHist, uint64_t value);
+uint64_t AfHistogramPercentile(const AfHistogram *pHist, double percentile);
+unsigned int AfHistogramBucketIndex(uint64_t value);
+uint64_t AfHistogramBucketValue(unsigned int bucket);
+
+#endif /* AFHISTOGRAM_H_ */
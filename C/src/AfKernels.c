@@ -0,0 +1,1252 @@
+/*
+ * @file AfKernels.c
+ *
+ * Scalar reference kernels, the baseline SIMD kernels of each architecture
+ * (SSE2 on x86-64, NEON on AArch64) and runtime selection of the kernel
+ * table. The AVX2 and AVX-512 tables live in their own files so that only
+ * they are compiled with those instruction sets enabled.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+/******************************************************************************/
+/* include block */
+#include "AfKernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define AF_HAVE_SSE2
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define AF_HAVE_NEON
+#endif
+
+/******************************************************************************/
+/** local definitions **/
+static double ScalarDot(const double *pA, const double *pB, unsigned int length);
+static void ScalarScaledAdd(double *pOut, double scale, const double *pIn, unsigned int length);
+static double ScalarSquaredNorm(const double *pIn, unsigned int length);
+static double ScalarUpdateDot(double *pW, const double *pNew, const double *pOld, double scale,
+                              unsigned int length, double *pEnergy);
+static float ScalarDotF(const float *pA, const float *pB, unsigned int length);
+static void ScalarScaledAddF(float *pOut, float scale, const float *pIn, unsigned int length);
+static float ScalarSquaredNormF(const float *pIn, unsigned int length);
+static float ScalarUpdateDotF(float *pW, const float *pNew, const float *pOld, float scale,
+                              unsigned int length, float *pEnergy);
+static void ScalarBankDot(const double *pW, const double *pX, unsigned int length,
+                          unsigned int channels, unsigned int stride,
+                          double *pOut, double *pEnergy);
+static void ScalarBankScaledAdd(double *pW, const double *pScale, const double *pX,
+                                unsigned int length, unsigned int channels,
+                                unsigned int stride);
+static double ScalarPropGain(double *pGain, const double *pW, const double *pX, double offset,
+                           double scale, double floor, unsigned int length);
+static void ScalarPropUpdate(double *pW, double step, const double *pGain, const double *pX,
+                           unsigned int length, double *pNorms);
+static const AfKernels *BestKernels(void);
+
+static const AfKernels KernelsScalar = {
+	AF_ISA_SCALAR, "scalar", ScalarDot, ScalarScaledAdd, ScalarSquaredNorm, ScalarUpdateDot,
+	ScalarDotF, ScalarScaledAddF, ScalarSquaredNormF, ScalarUpdateDotF,
+	ScalarBankDot, ScalarBankScaledAdd, ScalarPropGain, ScalarPropUpdate
+};
+
+#ifdef AF_HAVE_SSE2
+static double Sse2Dot(const double *pA, const double *pB, unsigned int length);
+static void Sse2ScaledAdd(double *pOut, double scale, const double *pIn, unsigned int length);
+static double Sse2SquaredNorm(const double *pIn, unsigned int length);
+static double Sse2UpdateDot(double *pW, const double *pNew, const double *pOld, double scale,
+                            unsigned int length, double *pEnergy);
+
+static float Sse2DotF(const float *pA, const float *pB, unsigned int length);
+static void Sse2ScaledAddF(float *pOut, float scale, const float *pIn, unsigned int length);
+static float Sse2SquaredNormF(const float *pIn, unsigned int length);
+static float Sse2UpdateDotF(float *pW, const float *pNew, const float *pOld, float scale,
+                            unsigned int length, float *pEnergy);
+static float Sse2HorizontalSumF(__m128 x);
+static void Sse2BankDot(const double *pW, const double *pX, unsigned int length,
+                        unsigned int channels, unsigned int stride,
+                        double *pOut, double *pEnergy);
+static void Sse2BankScaledAdd(double *pW, const double *pScale, const double *pX,
+                              unsigned int length, unsigned int channels,
+                              unsigned int stride);
+static double Sse2PropGain(double *pGain, const double *pW, const double *pX, double offset,
+                         double scale, double floor, unsigned int length);
+static void Sse2PropUpdate(double *pW, double step, const double *pGain, const double *pX,
+                         unsigned int length, double *pNorms);
+
+static const AfKernels KernelsSse2 = {
+	AF_ISA_SSE2, "sse2", Sse2Dot, Sse2ScaledAdd, Sse2SquaredNorm, Sse2UpdateDot,
+	Sse2DotF, Sse2ScaledAddF, Sse2SquaredNormF, Sse2UpdateDotF,
+	Sse2BankDot, Sse2BankScaledAdd, Sse2PropGain, Sse2PropUpdate
+};
+#endif
+
+#ifdef AF_HAVE_NEON
+static double NeonDot(const double *pA, const double *pB, unsigned int length);
+static void NeonScaledAdd(double *pOut, double scale, const double *pIn, unsigned int length);
+static double NeonSquaredNorm(const double *pIn, unsigned int length);
+static double NeonUpdateDot(double *pW, const double *pNew, const double *pOld, double scale,
+                            unsigned int length, double *pEnergy);
+
+static float NeonDotF(const float *pA, const float *pB, unsigned int length);
+static void NeonScaledAddF(float *pOut, float scale, const float *pIn, unsigned int length);
+static float NeonSquaredNormF(const float *pIn, unsigned int length);
+static float NeonUpdateDotF(float *pW, const float *pNew, const float *pOld, float scale,
+                            unsigned int length, float *pEnergy);
+static void NeonBankDot(const double *pW, const double *pX, unsigned int length,
+                        unsigned int channels, unsigned int stride,
+                        double *pOut, double *pEnergy);
+static void NeonBankScaledAdd(double *pW, const double *pScale, const double *pX,
+                              unsigned int length, unsigned int channels,
+                              unsigned int stride);
+static double NeonPropGain(double *pGain, const double *pW, const double *pX, double offset,
+                         double scale, double floor, unsigned int length);
+static void NeonPropUpdate(double *pW, double step, const double *pGain, const double *pX,
+                         unsigned int length, double *pNorms);
+
+static const AfKernels KernelsNeon = {
+	AF_ISA_NEON, "neon", NeonDot, NeonScaledAdd, NeonSquaredNorm, NeonUpdateDot,
+	NeonDotF, NeonScaledAddF, NeonSquaredNormF, NeonUpdateDotF,
+	NeonBankDot, NeonBankScaledAdd, NeonPropGain, NeonPropUpdate
+};
+#endif
+
+/******************************************************************************
+ * AfKernelsGet
+ *
+ * @param[in]     isa  requested instruction set, or AF_ISA_AUTO
+ *
+ * @returns       kernel table for isa, or NULL if this build or host cannot
+ *  run it
+ *
+ * @note          AF_ISA_AUTO picks the widest table the host supports
+ *  (AVX-512, then AVX2/FMA, then SSE2 or NEON, then scalar). Detection uses
+ *  CPUID through the compiler's cpu builtins and is safe to call from any
+ *  thread; the tables are constant.
+ *
+ * @warning       none
+ */
+const AfKernels *AfKernelsGet(AfIsa isa) {
+	switch (isa) {
+	case AF_ISA_AUTO:
+		return BestKernels();
+	case AF_ISA_SCALAR:
+		return &KernelsScalar;
+#ifdef AF_HAVE_SSE2
+	case AF_ISA_SSE2:
+		return &KernelsSse2;
+#endif
+#ifdef AF_HAVE_NEON
+	case AF_ISA_NEON:
+		return &KernelsNeon;
+#endif
+#if defined(AF_HAVE_AVX2) && (defined(__GNUC__) || defined(__clang__))
+	case AF_ISA_AVX2:
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+			return &AfKernelsAvx2;
+		}
+		return NULL;
+#endif
+#if defined(AF_HAVE_AVX512) && (defined(__GNUC__) || defined(__clang__))
+	case AF_ISA_AVX512:
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f")) {
+			return &AfKernelsAvx512;
+		}
+		return NULL;
+#endif
+	default:
+		return NULL;
+	}
+}
+/* End of AfKernelsGet() */
+/******************************************************************************/
+
+/** internal functions **/
+
+/***************************************************************************//**
+* BestKernels
+*
+* @param[in]     none
+*
+* @returns       widest kernel table supported by the host
+*
+* @note          Falls back one instruction set at a time down to scalar.
+*
+* @warning       none
+*******************************************************************************/
+static const AfKernels *BestKernels(void) {
+	static const AfIsa preference[] = {
+		AF_ISA_AVX512, AF_ISA_AVX2, AF_ISA_SSE2, AF_ISA_NEON
+	};
+	const AfKernels *pKernels;
+	unsigned int i;
+
+	for ( i = 0; i < sizeof(preference) / sizeof(preference[0]); i++ ) {
+		pKernels = AfKernelsGet(preference[i]);
+		if (pKernels) {
+			return pKernels;
+		}
+	}
+
+	return &KernelsScalar;
+}
+/* End of BestKernels()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* ScalarDot
+*
+* @param[in]     pA pointer to the first vector
+* @param[in]     pB pointer to the second vector
+* @param[in]     length length of the vectors
+*
+* @returns       inner product of the two vectors
+*
+* @note          Reference implementation, accumulated in index order.
+*
+* @warning       none
+*******************************************************************************/
+static double ScalarDot(const double *pA, const double *pB, unsigned int length) {
+	double output = 0;
+	unsigned int i;
+
+	for ( i = 0; i < length; i++ ) {
+		output += pA[i] * pB[i]; /* accumulate products */
+	}
+
+	return output;
+}
+/* End of ScalarDot()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* ScalarScaledAdd
+*
+* @param[in,out] pOut pointer to the vector being updated
+* @param[in]     scale scale factor applied to pIn
+* @param[in]     pIn pointer to the vector being added
+* @param[in]     length length of the vectors
+*
+* @returns       none
+*
+* @note          Reference implementation of pOut += scale * pIn.
+*
+* @warning       none
+*******************************************************************************/
+static void ScalarScaledAdd(double *pOut, double scale, const double *pIn, unsigned int length) {
+	unsigned int i;
+
+	for ( i = 0; i < length; i++ ) {
+		pOut[i] += scale * pIn[i];
+	}
+}
+/* End of ScalarScaledAdd()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* ScalarSquaredNorm
+*
+* @param[in]     pIn pointer to a buffer of input samples
+* @param[in]     length length of the buffer
+*
+* @returns       squared L2-norm of the input buffer
+*
+* @note          Reference implementation: the sum of every element squared.
+*
+* @warning       none
+*******************************************************************************/
+static double ScalarSquaredNorm(const double *pIn, unsigned int length) {
+	double output = 0;
+	unsigned int i;
+
+	for ( i = 0; i < length; i++ ) {
+		output += pIn[i] * pIn[i]; /* accumulate squared elements */
+	}
+
+	return output;
+}
+/* End of ScalarSquaredNorm()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* ScalarUpdateDot
+*
+* @param[in,out] pW pointer to the weights being updated
+* @param[in]     pNew pointer to the vector the updated weights multiply
+* @param[in]     pOld pointer to the vector the update is scaled from
+* @param[in]     scale scale factor applied to pOld
+* @param[in]     length length of the vectors
+* @param[in,out] pEnergy accumulates the squared norm of pNew
+*
+* @returns       inner product of the updated weights and pNew
+*
+* @note          Reference implementation of the fused filter-and-adapt
+*  sweep: each weight is updated and then used while still in a register.
+*
+* @warning       none
+*******************************************************************************/
+static double ScalarUpdateDot(double *pW, const double *pNew, const double *pOld, double scale,
+                              unsigned int length, double *pEnergy) {
+	double output = 0, energy = 0;
+	unsigned int i;
+
+	for ( i = 0; i < length; i++ ) {
+		pW[i] += scale * pOld[i];
+		output += pW[i] * pNew[i];
+		energy += pNew[i] * pNew[i];
+	}
+	*pEnergy += energy;
+
+	return output;
+}
+/* End of ScalarUpdateDot()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* ScalarDotF
+*
+* @note          Single precision ScalarDot.
+*******************************************************************************/
+static float ScalarDotF(const float *pA, const float *pB, unsigned int length) {
+	float output = 0;
+	unsigned int i;
+
+	for ( i = 0; i < length; i++ ) {
+		output += pA[i] * pB[i];
+	}
+
+	return output;
+}
+/* End of ScalarDotF()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* ScalarScaledAddF
+*
+* @note          Single precision ScalarScaledAdd.
+*******************************************************************************/
+static void ScalarScaledAddF(float *pOut, float scale, const float *pIn, unsigned int length) {
+	unsigned int i;
+
+	for ( i = 0; i < length; i++ ) {
+		pOut[i] += scale * pIn[i];
+	}
+}
+/* End of ScalarScaledAddF()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* ScalarSquaredNormF
+*
+* @note          Single precision ScalarSquaredNorm.
+*******************************************************************************/
+static float ScalarSquaredNormF(const float *pIn, unsigned int length) {
+	float output = 0;
+	unsigned int i;
+
+	for ( i = 0; i < length; i++ ) {
+		output += pIn[i] * pIn[i];
+	}
+
+	return output;
+}
+/* End of ScalarSquaredNormF()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* ScalarUpdateDotF
+*
+* @note          Single precision ScalarUpdateDot.
+*******************************************************************************/
+static float ScalarUpdateDotF(float *pW, const float *pNew, const float *pOld, float scale,
+                              unsigned int length, float *pEnergy) {
+	float output = 0, energy = 0;
+	unsigned int i;
+
+	for ( i = 0; i < length; i++ ) {
+		pW[i] += scale * pOld[i];
+		output += pW[i] * pNew[i];
+		energy += pNew[i] * pNew[i];
+	}
+	*pEnergy += energy;
+
+	return output;
+}
+/* End of ScalarUpdateDotF()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* ScalarBankDot
+*
+* @param[in]     pW pointer to the tap-major weights of all channels
+* @param[in]     pX pointer to the tap-major inputs of all channels
+* @param[in]     length number of taps per channel
+* @param[in]     channels number of channels
+* @param[in]     stride distance between consecutive taps, >= channels
+* @param[out]    pOut per-channel inner products
+* @param[out]    pEnergy per-channel squared norms of pX
+*
+* @returns       none
+*
+* @note          Reference implementation; each channel is accumulated in
+*  tap order, a row of channels at a time.
+*
+* @warning       none
+*******************************************************************************/
+static void ScalarBankDot(const double *pW, const double *pX, unsigned int length,
+                          unsigned int channels, unsigned int stride,
+                          double *pOut, double *pEnergy) {
+	unsigned int i, c;
+
+	for ( c = 0; c < channels; c++ ) {
+		pOut[c] = 0.0;
+		pEnergy[c] = 0.0;
+	}
+	for ( i = 0; i < length; i++, pW += stride, pX += stride ) {
+		for ( c = 0; c < channels; c++ ) {
+			pOut[c] += pW[c] * pX[c];
+			pEnergy[c] += pX[c] * pX[c];
+		}
+	}
+}
+/* End of ScalarBankDot()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* ScalarBankScaledAdd
+*
+* @param[in,out] pW pointer to the tap-major weights of all channels
+* @param[in]     pScale per-channel scale factors
+* @param[in]     pX pointer to the tap-major inputs of all channels
+* @param[in]     length number of taps per channel
+* @param[in]     channels number of channels
+* @param[in]     stride distance between consecutive taps, >= channels
+*
+* @returns       none
+*
+* @note          Reference implementation of w += scale[c] * x per channel.
+*
+* @warning       none
+*******************************************************************************/
+static void ScalarBankScaledAdd(double *pW, const double *pScale, const double *pX,
+                                unsigned int length, unsigned int channels,
+                                unsigned int stride) {
+	unsigned int i, c;
+
+	for ( i = 0; i < length; i++, pW += stride, pX += stride ) {
+		for ( c = 0; c < channels; c++ ) {
+			pW[c] += pScale[c] * pX[c];
+		}
+	}
+}
+/* End of ScalarBankScaledAdd()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* ScalarPropGain
+*
+* @param[out]    pGain pointer to the per-tap gains
+* @param[in]     pW pointer to the weights the gains are proportional to
+* @param[in]     pX pointer to the input vector
+* @param[in]     offset gain given to every tap
+* @param[in]     scale gain per unit of weight magnitude
+* @param[in]     floor smallest weight magnitude used
+* @param[in]     length length of the vectors
+*
+* @returns       gain-weighted input energy, sum of pGain[i]*pX[i]^2
+*
+* @note          Reference implementation of the proportionate gains
+*  offset + scale * max(|w|, floor), which covers both PNLMS (offset 0)
+*  and IPNLMS (floor 0).
+*
+* @warning       none
+*******************************************************************************/
+static double ScalarPropGain(double *pGain, const double *pW, const double *pX, double offset,
+                             double scale, double floor, unsigned int length) {
+	double energy = 0, magnitude;
+	unsigned int i;
+
+	for ( i = 0; i < length; i++ ) {
+		magnitude = (pW[i] < 0) ? -pW[i] : pW[i];
+		if (magnitude < floor) {
+			magnitude = floor;
+		}
+		pGain[i] = offset + scale * magnitude;
+		energy += pGain[i] * pX[i] * pX[i];
+	}
+
+	return energy;
+}
+/* End of ScalarPropGain()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* ScalarPropUpdate
+*
+* @param[in,out] pW pointer to the weights being updated
+* @param[in]     step step applied to every tap before its gain
+* @param[in]     pGain pointer to the per-tap gains
+* @param[in]     pX pointer to the input vector
+* @param[in]     length length of the vectors
+* @param[out]    pNorms L1 norm and largest magnitude of the updated weights
+*
+* @returns       none
+*
+* @note          Reference implementation of pW += step * pGain * pX; the
+*  norms feed the next sample's gains, so they cost no extra pass.
+*
+* @warning       none
+*******************************************************************************/
+static void ScalarPropUpdate(double *pW, double step, const double *pGain, const double *pX,
+                             unsigned int length, double *pNorms) {
+	double sum = 0, peak = 0, magnitude;
+	unsigned int i;
+
+	for ( i = 0; i < length; i++ ) {
+		pW[i] += step * pGain[i] * pX[i];
+		magnitude = (pW[i] < 0) ? -pW[i] : pW[i];
+		sum += magnitude;
+		if (magnitude > peak) {
+			peak = magnitude;
+		}
+	}
+	pNorms[0] = sum;
+	pNorms[1] = peak;
+}
+/* End of ScalarPropUpdate()*/
+/******************************************************************************/
+
+#ifdef AF_HAVE_SSE2
+/***************************************************************************//**
+* Sse2Dot
+*
+* @note          SSE2 version of ScalarDot with two 2-lane partial sums.
+*******************************************************************************/
+static double Sse2Dot(const double *pA, const double *pB, unsigned int length) {
+	__m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+	double output;
+	unsigned int i = 0;
+
+	for ( ; i + 4 <= length; i += 4 ) {
+		acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(pA + i), _mm_loadu_pd(pB + i)));
+		acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(pA + i + 2), _mm_loadu_pd(pB + i + 2)));
+	}
+	acc0 = _mm_add_pd(acc0, acc1);
+	acc0 = _mm_add_pd(acc0, _mm_unpackhi_pd(acc0, acc0));
+	output = _mm_cvtsd_f64(acc0);
+
+	for ( ; i < length; i++ ) {
+		output += pA[i] * pB[i];
+	}
+
+	return output;
+}
+/* End of Sse2Dot()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Sse2ScaledAdd
+*
+* @note          SSE2 version of ScalarScaledAdd.
+*******************************************************************************/
+static void Sse2ScaledAdd(double *pOut, double scale, const double *pIn, unsigned int length) {
+	const __m128d s = _mm_set1_pd(scale);
+	unsigned int i = 0;
+
+	for ( ; i + 2 <= length; i += 2 ) {
+		_mm_storeu_pd(pOut + i, _mm_add_pd(_mm_loadu_pd(pOut + i), _mm_mul_pd(s, _mm_loadu_pd(pIn + i))));
+	}
+	for ( ; i < length; i++ ) {
+		pOut[i] += scale * pIn[i];
+	}
+}
+/* End of Sse2ScaledAdd()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Sse2SquaredNorm
+*
+* @note          SSE2 version of ScalarSquaredNorm.
+*******************************************************************************/
+static double Sse2SquaredNorm(const double *pIn, unsigned int length) {
+	__m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd(), x0, x1;
+	double output;
+	unsigned int i = 0;
+
+	for ( ; i + 4 <= length; i += 4 ) {
+		x0 = _mm_loadu_pd(pIn + i);
+		x1 = _mm_loadu_pd(pIn + i + 2);
+		acc0 = _mm_add_pd(acc0, _mm_mul_pd(x0, x0));
+		acc1 = _mm_add_pd(acc1, _mm_mul_pd(x1, x1));
+	}
+	acc0 = _mm_add_pd(acc0, acc1);
+	acc0 = _mm_add_pd(acc0, _mm_unpackhi_pd(acc0, acc0));
+	output = _mm_cvtsd_f64(acc0);
+
+	for ( ; i < length; i++ ) {
+		output += pIn[i] * pIn[i];
+	}
+
+	return output;
+}
+/* End of Sse2SquaredNorm()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Sse2UpdateDot
+*
+* @note          SSE2 version of ScalarUpdateDot.
+*******************************************************************************/
+static double Sse2UpdateDot(double *pW, const double *pNew, const double *pOld, double scale,
+                            unsigned int length, double *pEnergy) {
+	const __m128d s = _mm_set1_pd(scale);
+	__m128d acc = _mm_setzero_pd(), eacc = _mm_setzero_pd(), w, x;
+	double output, energy;
+	unsigned int i = 0;
+
+	for ( ; i + 2 <= length; i += 2 ) {
+		w = _mm_add_pd(_mm_loadu_pd(pW + i), _mm_mul_pd(s, _mm_loadu_pd(pOld + i)));
+		_mm_storeu_pd(pW + i, w);
+		x = _mm_loadu_pd(pNew + i);
+		acc = _mm_add_pd(acc, _mm_mul_pd(w, x));
+		eacc = _mm_add_pd(eacc, _mm_mul_pd(x, x));
+	}
+	output = _mm_cvtsd_f64(_mm_add_sd(acc, _mm_unpackhi_pd(acc, acc)));
+	energy = _mm_cvtsd_f64(_mm_add_sd(eacc, _mm_unpackhi_pd(eacc, eacc)));
+
+	for ( ; i < length; i++ ) {
+		pW[i] += scale * pOld[i];
+		output += pW[i] * pNew[i];
+		energy += pNew[i] * pNew[i];
+	}
+	*pEnergy += energy;
+
+	return output;
+}
+/* End of Sse2UpdateDot()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Sse2DotF
+*
+* @note          Single precision Sse2Dot, two 4-lane partial sums.
+*******************************************************************************/
+static float Sse2DotF(const float *pA, const float *pB, unsigned int length) {
+	__m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+	float output;
+	unsigned int i = 0;
+
+	for ( ; i + 8 <= length; i += 8 ) {
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(pA + i), _mm_loadu_ps(pB + i)));
+		acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(pA + i + 4), _mm_loadu_ps(pB + i + 4)));
+	}
+	output = Sse2HorizontalSumF(_mm_add_ps(acc0, acc1));
+
+	for ( ; i < length; i++ ) {
+		output += pA[i] * pB[i];
+	}
+
+	return output;
+}
+/* End of Sse2DotF()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Sse2ScaledAddF
+*
+* @note          Single precision Sse2ScaledAdd.
+*******************************************************************************/
+static void Sse2ScaledAddF(float *pOut, float scale, const float *pIn, unsigned int length) {
+	const __m128 s = _mm_set1_ps(scale);
+	unsigned int i = 0;
+
+	for ( ; i + 4 <= length; i += 4 ) {
+		_mm_storeu_ps(pOut + i, _mm_add_ps(_mm_loadu_ps(pOut + i), _mm_mul_ps(s, _mm_loadu_ps(pIn + i))));
+	}
+	for ( ; i < length; i++ ) {
+		pOut[i] += scale * pIn[i];
+	}
+}
+/* End of Sse2ScaledAddF()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Sse2SquaredNormF
+*
+* @note          Single precision Sse2SquaredNorm.
+*******************************************************************************/
+static float Sse2SquaredNormF(const float *pIn, unsigned int length) {
+	__m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps(), x0, x1;
+	float output;
+	unsigned int i = 0;
+
+	for ( ; i + 8 <= length; i += 8 ) {
+		x0 = _mm_loadu_ps(pIn + i);
+		x1 = _mm_loadu_ps(pIn + i + 4);
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(x0, x0));
+		acc1 = _mm_add_ps(acc1, _mm_mul_ps(x1, x1));
+	}
+	output = Sse2HorizontalSumF(_mm_add_ps(acc0, acc1));
+
+	for ( ; i < length; i++ ) {
+		output += pIn[i] * pIn[i];
+	}
+
+	return output;
+}
+/* End of Sse2SquaredNormF()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Sse2UpdateDotF
+*
+* @note          Single precision Sse2UpdateDot.
+*******************************************************************************/
+static float Sse2UpdateDotF(float *pW, const float *pNew, const float *pOld, float scale,
+                            unsigned int length, float *pEnergy) {
+	const __m128 s = _mm_set1_ps(scale);
+	__m128 acc = _mm_setzero_ps(), eacc = _mm_setzero_ps(), w, x;
+	float output, energy;
+	unsigned int i = 0;
+
+	for ( ; i + 4 <= length; i += 4 ) {
+		w = _mm_add_ps(_mm_loadu_ps(pW + i), _mm_mul_ps(s, _mm_loadu_ps(pOld + i)));
+		_mm_storeu_ps(pW + i, w);
+		x = _mm_loadu_ps(pNew + i);
+		acc = _mm_add_ps(acc, _mm_mul_ps(w, x));
+		eacc = _mm_add_ps(eacc, _mm_mul_ps(x, x));
+	}
+	output = Sse2HorizontalSumF(acc);
+	energy = Sse2HorizontalSumF(eacc);
+
+	for ( ; i < length; i++ ) {
+		pW[i] += scale * pOld[i];
+		output += pW[i] * pNew[i];
+		energy += pNew[i] * pNew[i];
+	}
+	*pEnergy += energy;
+
+	return output;
+}
+/* End of Sse2UpdateDotF()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Sse2HorizontalSumF
+*
+* @note          Adds the four lanes of x.
+*******************************************************************************/
+static float Sse2HorizontalSumF(__m128 x) {
+	x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+	x = _mm_add_ss(x, _mm_shuffle_ps(x, x, 1));
+
+	return _mm_cvtss_f32(x);
+}
+/* End of Sse2HorizontalSumF()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Sse2BankDot
+*
+* @note          SSE2 version of ScalarBankDot: four channels per pass with
+*  their sums held in registers across all taps, then pairs, then one.
+*******************************************************************************/
+static void Sse2BankDot(const double *pW, const double *pX, unsigned int length,
+                        unsigned int channels, unsigned int stride,
+                        double *pOut, double *pEnergy) {
+	__m128d acc0, acc1, eacc0, eacc1, x0, x1;
+	double acc, eacc;
+	size_t off;
+	unsigned int i, c = 0;
+
+	for ( ; c + 4 <= channels; c += 4 ) {
+		acc0 = acc1 = eacc0 = eacc1 = _mm_setzero_pd();
+		for ( i = 0, off = c; i < length; i++, off += stride ) {
+			x0 = _mm_loadu_pd(pX + off);
+			x1 = _mm_loadu_pd(pX + off + 2);
+			acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(pW + off), x0));
+			acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(pW + off + 2), x1));
+			eacc0 = _mm_add_pd(eacc0, _mm_mul_pd(x0, x0));
+			eacc1 = _mm_add_pd(eacc1, _mm_mul_pd(x1, x1));
+		}
+		_mm_storeu_pd(pOut + c, acc0);
+		_mm_storeu_pd(pOut + c + 2, acc1);
+		_mm_storeu_pd(pEnergy + c, eacc0);
+		_mm_storeu_pd(pEnergy + c + 2, eacc1);
+	}
+	for ( ; c + 2 <= channels; c += 2 ) {
+		acc0 = eacc0 = _mm_setzero_pd();
+		for ( i = 0, off = c; i < length; i++, off += stride ) {
+			x0 = _mm_loadu_pd(pX + off);
+			acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(pW + off), x0));
+			eacc0 = _mm_add_pd(eacc0, _mm_mul_pd(x0, x0));
+		}
+		_mm_storeu_pd(pOut + c, acc0);
+		_mm_storeu_pd(pEnergy + c, eacc0);
+	}
+	for ( ; c < channels; c++ ) {
+		acc = eacc = 0.0;
+		for ( i = 0, off = c; i < length; i++, off += stride ) {
+			acc += pW[off] * pX[off];
+			eacc += pX[off] * pX[off];
+		}
+		pOut[c] = acc;
+		pEnergy[c] = eacc;
+	}
+}
+/* End of Sse2BankDot()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Sse2BankScaledAdd
+*
+* @note          SSE2 version of ScalarBankScaledAdd, a row of channels at a
+*  time.
+*******************************************************************************/
+static void Sse2BankScaledAdd(double *pW, const double *pScale, const double *pX,
+                              unsigned int length, unsigned int channels,
+                              unsigned int stride) {
+	unsigned int i, c;
+
+	for ( i = 0; i < length; i++, pW += stride, pX += stride ) {
+		for ( c = 0; c + 2 <= channels; c += 2 ) {
+			_mm_storeu_pd(pW + c, _mm_add_pd(_mm_loadu_pd(pW + c),
+			              _mm_mul_pd(_mm_loadu_pd(pScale + c), _mm_loadu_pd(pX + c))));
+		}
+		for ( ; c < channels; c++ ) {
+			pW[c] += pScale[c] * pX[c];
+		}
+	}
+}
+/* End of Sse2BankScaledAdd()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Sse2PropGain
+*
+* @note          SSE2 version of ScalarPropGain.
+*******************************************************************************/
+static double Sse2PropGain(double *pGain, const double *pW, const double *pX, double offset,
+                           double scale, double floor, unsigned int length) {
+	const __m128d sign = _mm_set1_pd(-0.0), o = _mm_set1_pd(offset);
+	const __m128d s = _mm_set1_pd(scale), f = _mm_set1_pd(floor);
+	__m128d acc = _mm_setzero_pd(), g, x;
+	double energy, magnitude;
+	unsigned int i = 0;
+
+	for ( ; i + 2 <= length; i += 2 ) {
+		g = _mm_add_pd(o, _mm_mul_pd(s, _mm_max_pd(_mm_andnot_pd(sign, _mm_loadu_pd(pW + i)), f)));
+		_mm_storeu_pd(pGain + i, g);
+		x = _mm_loadu_pd(pX + i);
+		acc = _mm_add_pd(acc, _mm_mul_pd(_mm_mul_pd(g, x), x));
+	}
+	energy = _mm_cvtsd_f64(_mm_add_sd(acc, _mm_unpackhi_pd(acc, acc)));
+
+	for ( ; i < length; i++ ) {
+		magnitude = (pW[i] < 0) ? -pW[i] : pW[i];
+		if (magnitude < floor) {
+			magnitude = floor;
+		}
+		pGain[i] = offset + scale * magnitude;
+		energy += pGain[i] * pX[i] * pX[i];
+	}
+
+	return energy;
+}
+/* End of Sse2PropGain()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Sse2PropUpdate
+*
+* @note          SSE2 version of ScalarPropUpdate.
+*******************************************************************************/
+static void Sse2PropUpdate(double *pW, double step, const double *pGain, const double *pX,
+                           unsigned int length, double *pNorms) {
+	const __m128d sign = _mm_set1_pd(-0.0), s = _mm_set1_pd(step);
+	__m128d sum = _mm_setzero_pd(), peak = _mm_setzero_pd(), w;
+	double magnitude;
+	unsigned int i = 0;
+
+	for ( ; i + 2 <= length; i += 2 ) {
+		w = _mm_add_pd(_mm_loadu_pd(pW + i),
+		               _mm_mul_pd(_mm_mul_pd(s, _mm_loadu_pd(pGain + i)), _mm_loadu_pd(pX + i)));
+		_mm_storeu_pd(pW + i, w);
+		w = _mm_andnot_pd(sign, w);
+		sum = _mm_add_pd(sum, w);
+		peak = _mm_max_pd(peak, w);
+	}
+	pNorms[0] = _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+	pNorms[1] = _mm_cvtsd_f64(_mm_max_sd(peak, _mm_unpackhi_pd(peak, peak)));
+
+	for ( ; i < length; i++ ) {
+		pW[i] += step * pGain[i] * pX[i];
+		magnitude = (pW[i] < 0) ? -pW[i] : pW[i];
+		pNorms[0] += magnitude;
+		if (magnitude > pNorms[1]) {
+			pNorms[1] = magnitude;
+		}
+	}
+}
+/* End of Sse2PropUpdate()*/
+/******************************************************************************/
+#endif /* AF_HAVE_SSE2 */
+
+#ifdef AF_HAVE_NEON
+/***************************************************************************//**
+* NeonDot
+*
+* @note          NEON version of ScalarDot with two 2-lane partial sums.
+*******************************************************************************/
+static double NeonDot(const double *pA, const double *pB, unsigned int length) {
+	float64x2_t acc0 = vdupq_n_f64(0.0), acc1 = vdupq_n_f64(0.0);
+	double output;
+	unsigned int i = 0;
+
+	for ( ; i + 4 <= length; i += 4 ) {
+		acc0 = vfmaq_f64(acc0, vld1q_f64(pA + i), vld1q_f64(pB + i));
+		acc1 = vfmaq_f64(acc1, vld1q_f64(pA + i + 2), vld1q_f64(pB + i + 2));
+	}
+	output = vaddvq_f64(vaddq_f64(acc0, acc1));
+
+	for ( ; i < length; i++ ) {
+		output += pA[i] * pB[i];
+	}
+
+	return output;
+}
+/* End of NeonDot()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* NeonScaledAdd
+*
+* @note          NEON version of ScalarScaledAdd.
+*******************************************************************************/
+static void NeonScaledAdd(double *pOut, double scale, const double *pIn, unsigned int length) {
+	const float64x2_t s = vdupq_n_f64(scale);
+	unsigned int i = 0;
+
+	for ( ; i + 2 <= length; i += 2 ) {
+		vst1q_f64(pOut + i, vfmaq_f64(vld1q_f64(pOut + i), s, vld1q_f64(pIn + i)));
+	}
+	for ( ; i < length; i++ ) {
+		pOut[i] += scale * pIn[i];
+	}
+}
+/* End of NeonScaledAdd()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* NeonSquaredNorm
+*
+* @note          NEON version of ScalarSquaredNorm.
+*******************************************************************************/
+static double NeonSquaredNorm(const double *pIn, unsigned int length) {
+	float64x2_t acc0 = vdupq_n_f64(0.0), acc1 = vdupq_n_f64(0.0), x0, x1;
+	double output;
+	unsigned int i = 0;
+
+	for ( ; i + 4 <= length; i += 4 ) {
+		x0 = vld1q_f64(pIn + i);
+		x1 = vld1q_f64(pIn + i + 2);
+		acc0 = vfmaq_f64(acc0, x0, x0);
+		acc1 = vfmaq_f64(acc1, x1, x1);
+	}
+	output = vaddvq_f64(vaddq_f64(acc0, acc1));
+
+	for ( ; i < length; i++ ) {
+		output += pIn[i] * pIn[i];
+	}
+
+	return output;
+}
+/* End of NeonSquaredNorm()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* NeonUpdateDot
+*
+* @note          NEON version of ScalarUpdateDot.
+*******************************************************************************/
+static double NeonUpdateDot(double *pW, const double *pNew, const double *pOld, double scale,
+                            unsigned int length, double *pEnergy) {
+	const float64x2_t s = vdupq_n_f64(scale);
+	float64x2_t acc = vdupq_n_f64(0.0), eacc = vdupq_n_f64(0.0), w, x;
+	double output, energy;
+	unsigned int i = 0;
+
+	for ( ; i + 2 <= length; i += 2 ) {
+		w = vfmaq_f64(vld1q_f64(pW + i), s, vld1q_f64(pOld + i));
+		vst1q_f64(pW + i, w);
+		x = vld1q_f64(pNew + i);
+		acc = vfmaq_f64(acc, w, x);
+		eacc = vfmaq_f64(eacc, x, x);
+	}
+	output = vaddvq_f64(acc);
+	energy = vaddvq_f64(eacc);
+
+	for ( ; i < length; i++ ) {
+		pW[i] += scale * pOld[i];
+		output += pW[i] * pNew[i];
+		energy += pNew[i] * pNew[i];
+	}
+	*pEnergy += energy;
+
+	return output;
+}
+/* End of NeonUpdateDot()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* NeonDotF
+*
+* @note          Single precision NeonDot, two 4-lane partial sums.
+*******************************************************************************/
+static float NeonDotF(const float *pA, const float *pB, unsigned int length) {
+	float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = vdupq_n_f32(0.0f);
+	float output;
+	unsigned int i = 0;
+
+	for ( ; i + 8 <= length; i += 8 ) {
+		acc0 = vfmaq_f32(acc0, vld1q_f32(pA + i), vld1q_f32(pB + i));
+		acc1 = vfmaq_f32(acc1, vld1q_f32(pA + i + 4), vld1q_f32(pB + i + 4));
+	}
+	output = vaddvq_f32(vaddq_f32(acc0, acc1));
+
+	for ( ; i < length; i++ ) {
+		output += pA[i] * pB[i];
+	}
+
+	return output;
+}
+/* End of NeonDotF()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* NeonScaledAddF
+*
+* @note          Single precision NeonScaledAdd.
+*******************************************************************************/
+static void NeonScaledAddF(float *pOut, float scale, const float *pIn, unsigned int length) {
+	const float32x4_t s = vdupq_n_f32(scale);
+	unsigned int i = 0;
+
+	for ( ; i + 4 <= length; i += 4 ) {
+		vst1q_f32(pOut + i, vfmaq_f32(vld1q_f32(pOut + i), s, vld1q_f32(pIn + i)));
+	}
+	for ( ; i < length; i++ ) {
+		pOut[i] += scale * pIn[i];
+	}
+}
+/* End of NeonScaledAddF()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* NeonSquaredNormF
+*
+* @note          Single precision NeonSquaredNorm.
+*******************************************************************************/
+static float NeonSquaredNormF(const float *pIn, unsigned int length) {
+	float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = vdupq_n_f32(0.0f), x0, x1;
+	float output;
+	unsigned int i = 0;
+
+	for ( ; i + 8 <= length; i += 8 ) {
+		x0 = vld1q_f32(pIn + i);
+		x1 = vld1q_f32(pIn + i + 4);
+		acc0 = vfmaq_f32(acc0, x0, x0);
+		acc1 = vfmaq_f32(acc1, x1, x1);
+	}
+	output = vaddvq_f32(vaddq_f32(acc0, acc1));
+
+	for ( ; i < length; i++ ) {
+		output += pIn[i] * pIn[i];
+	}
+
+	return output;
+}
+/* End of NeonSquaredNormF()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* NeonUpdateDotF
+*
+* @note          Single precision NeonUpdateDot.
+*******************************************************************************/
+static float NeonUpdateDotF(float *pW, const float *pNew, const float *pOld, float scale,
+                            unsigned int length, float *pEnergy) {
+	const float32x4_t s = vdupq_n_f32(scale);
+	float32x4_t acc = vdupq_n_f32(0.0f), eacc = vdupq_n_f32(0.0f), w, x;
+	float output, energy;
+	unsigned int i = 0;
+
+	for ( ; i + 4 <= length; i += 4 ) {
+		w = vfmaq_f32(vld1q_f32(pW + i), s, vld1q_f32(pOld + i));
+		vst1q_f32(pW + i, w);
+		x = vld1q_f32(pNew + i);
+		acc = vfmaq_f32(acc, w, x);
+		eacc = vfmaq_f32(eacc, x, x);
+	}
+	output = vaddvq_f32(acc);
+	energy = vaddvq_f32(eacc);
+
+	for ( ; i < length; i++ ) {
+		pW[i] += scale * pOld[i];
+		output += pW[i] * pNew[i];
+		energy += pNew[i] * pNew[i];
+	}
+	*pEnergy += energy;
+
+	return output;
+}
+/* End of NeonUpdateDotF()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* NeonBankDot
+*
+* @note          NEON version of ScalarBankDot: four channels per pass with
+*  their sums held in registers across all taps, then pairs, then one.
+*******************************************************************************/
+static void NeonBankDot(const double *pW, const double *pX, unsigned int length,
+                        unsigned int channels, unsigned int stride,
+                        double *pOut, double *pEnergy) {
+	float64x2_t acc0, acc1, eacc0, eacc1, x0, x1;
+	double acc, eacc;
+	size_t off;
+	unsigned int i, c = 0;
+
+	for ( ; c + 4 <= channels; c += 4 ) {
+		acc0 = acc1 = eacc0 = eacc1 = vdupq_n_f64(0.0);
+		for ( i = 0, off = c; i < length; i++, off += stride ) {
+			x0 = vld1q_f64(pX + off);
+			x1 = vld1q_f64(pX + off + 2);
+			acc0 = vfmaq_f64(acc0, vld1q_f64(pW + off), x0);
+			acc1 = vfmaq_f64(acc1, vld1q_f64(pW + off + 2), x1);
+			eacc0 = vfmaq_f64(eacc0, x0, x0);
+			eacc1 = vfmaq_f64(eacc1, x1, x1);
+		}
+		vst1q_f64(pOut + c, acc0);
+		vst1q_f64(pOut + c + 2, acc1);
+		vst1q_f64(pEnergy + c, eacc0);
+		vst1q_f64(pEnergy + c + 2, eacc1);
+	}
+	for ( ; c + 2 <= channels; c += 2 ) {
+		acc0 = eacc0 = vdupq_n_f64(0.0);
+		for ( i = 0, off = c; i < length; i++, off += stride ) {
+			x0 = vld1q_f64(pX + off);
+			acc0 = vfmaq_f64(acc0, vld1q_f64(pW + off), x0);
+			eacc0 = vfmaq_f64(eacc0, x0, x0);
+		}
+		vst1q_f64(pOut + c, acc0);
+		vst1q_f64(pEnergy + c, eacc0);
+	}
+	for ( ; c < channels; c++ ) {
+		acc = eacc = 0.0;
+		for ( i = 0, off = c; i < length; i++, off += stride ) {
+			acc += pW[off] * pX[off];
+			eacc += pX[off] * pX[off];
+		}
+		pOut[c] = acc;
+		pEnergy[c] = eacc;
+	}
+}
+/* End of NeonBankDot()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* NeonBankScaledAdd
+*
+* @note          NEON version of ScalarBankScaledAdd, a row of channels at a
+*  time.
+*******************************************************************************/
+static void NeonBankScaledAdd(double *pW, const double *pScale, const double *pX,
+                              unsigned int length, unsigned int channels,
+                              unsigned int stride) {
+	unsigned int i, c;
+
+	for ( i = 0; i < length; i++, pW += stride, pX += stride ) {
+		for ( c = 0; c + 2 <= channels; c += 2 ) {
+			vst1q_f64(pW + c, vfmaq_f64(vld1q_f64(pW + c), vld1q_f64(pScale + c), vld1q_f64(pX + c)));
+		}
+		for ( ; c < channels; c++ ) {
+			pW[c] += pScale[c] * pX[c];
+		}
+	}
+}
+/* End of NeonBankScaledAdd()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* NeonPropGain
+*
+* @note          NEON version of ScalarPropGain.
+*******************************************************************************/
+static double NeonPropGain(double *pGain, const double *pW, const double *pX, double offset,
+                           double scale, double floor, unsigned int length) {
+	const float64x2_t o = vdupq_n_f64(offset), s = vdupq_n_f64(scale), f = vdupq_n_f64(floor);
+	float64x2_t acc = vdupq_n_f64(0.0), g, x;
+	double energy, magnitude;
+	unsigned int i = 0;
+
+	for ( ; i + 2 <= length; i += 2 ) {
+		g = vfmaq_f64(o, s, vmaxq_f64(vabsq_f64(vld1q_f64(pW + i)), f));
+		vst1q_f64(pGain + i, g);
+		x = vld1q_f64(pX + i);
+		acc = vfmaq_f64(acc, vmulq_f64(g, x), x);
+	}
+	energy = vaddvq_f64(acc);
+
+	for ( ; i < length; i++ ) {
+		magnitude = (pW[i] < 0) ? -pW[i] : pW[i];
+		if (magnitude < floor) {
+			magnitude = floor;
+		}
+		pGain[i] = offset + scale * magnitude;
+		energy += pGain[i] * pX[i] * pX[i];
+	}
+
+	return energy;
+}
+/* End of NeonPropGain()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* NeonPropUpdate
+*
+* @note          NEON version of ScalarPropUpdate.
+*******************************************************************************/
+static void NeonPropUpdate(double *pW, double step, const double *pGain, const double *pX,
+                           unsigned int length, double *pNorms) {
+	float64x2_t sum = vdupq_n_f64(0.0), peak = vdupq_n_f64(0.0), w;
+	double magnitude;
+	unsigned int i = 0;
+
+	for ( ; i + 2 <= length; i += 2 ) {
+		w = vfmaq_f64(vld1q_f64(pW + i), vmulq_n_f64(vld1q_f64(pGain + i), step), vld1q_f64(pX + i));
+		vst1q_f64(pW + i, w);
+		w = vabsq_f64(w);
+		sum = vaddq_f64(sum, w);
+		peak = vmaxq_f64(peak, w);
+	}
+	pNorms[0] = vaddvq_f64(sum);
+	pNorms[1] = vmaxvq_f64(peak);
+
+	for ( ; i < length; i++ ) {
+		pW[i] += step * pGain[i] * pX[i];
+		magnitude = (pW[i] < 0) ? -pW[i] : pW[i];
+		pNorms[0] += magnitude;
+		if (magnitude > pNorms[1]) {
+			pNorms[1] = magnitude;
+		}
+	}
+}
+/* End of NeonPropUpdate()*/
+/******************************************************************************/
+#endif /* AF_HAVE_NEON */
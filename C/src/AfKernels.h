@@ -0,0 +1,87 @@
+/*
+ * @file AfKernels.h
+ *
+ * Vector kernels used by the adaptive filter inner loops, with one table of
+ * implementations per instruction set and runtime selection of the best
+ * table the host CPU supports.
+ *
+ * Tolerance: the SIMD kernels keep several partial sums and use fused
+ * multiply-add where available, so they round differently from the scalar
+ * reference. For vectors of length n the results satisfy
+ *   Dot, SquaredNorm: |simd - scalar| <= n * DBL_EPSILON * sum(|a[i]*b[i]|)
+ *   ScaledAdd:        |simd - scalar| <= DBL_EPSILON * (|out[i]| + |scale*in[i]|)
+ *   UpdateDot:        ScaledAdd bound on the weights, Dot bound on the result
+ *   BankDot, BankScaledAdd: the Dot and ScaledAdd bounds for each channel
+ *   PropGain:   ScaledAdd bound on each gain, Dot bound on the energy
+ *   PropUpdate: twice the ScaledAdd bound on the weights (the step is
+ *               applied to gain * x in a different order), Dot bound on
+ *               the norms
+ * which AF_KERNEL_TOLERANCE() expresses for a given length and magnitude.
+ * The single precision kernels obey the same bounds with FLT_EPSILON
+ * (AF_KERNEL_TOLERANCE_F()).
+ *
+ * Created on: Oct 16, 2026
+ */
+
+#ifndef AFKERNELS_H_
+#define AFKERNELS_H_
+
+#include <float.h>
+
+/* instruction sets with a kernel table */
+typedef enum {
+	AF_ISA_AUTO = 0, /* best supported by the host, chosen at runtime */
+	AF_ISA_SCALAR, /* portable C reference */
+	AF_ISA_SSE2,
+	AF_ISA_AVX2, /* AVX2 + FMA */
+	AF_ISA_AVX512, /* AVX-512F */
+	AF_ISA_NEON
+} AfIsa;
+
+/* table of kernel implementations for one instruction set */
+typedef struct AfKernels {
+	AfIsa Isa; /* instruction set of this table */
+	const char *Name; /* printable name of the instruction set */
+	double (*Dot)(const double *pA, const double *pB, unsigned int length); /* sum of pA[i]*pB[i] */
+	void (*ScaledAdd)(double *pOut, double scale, const double *pIn, unsigned int length); /* pOut += scale*pIn */
+	double (*SquaredNorm)(const double *pIn, unsigned int length); /* sum of pIn[i]^2 */
+	double (*UpdateDot)(double *pW, const double *pNew, const double *pOld, double scale,
+	                    unsigned int length, double *pEnergy); /* pW += scale*pOld, then sum of
+	                                                            * pW[i]*pNew[i]; adds pNew[i]^2 to *pEnergy */
+	/* single precision counterparts, same semantics */
+	float (*DotF)(const float *pA, const float *pB, unsigned int length);
+	void (*ScaledAddF)(float *pOut, float scale, const float *pIn, unsigned int length);
+	float (*SquaredNormF)(const float *pIn, unsigned int length);
+	float (*UpdateDotF)(float *pW, const float *pNew, const float *pOld, float scale,
+	                    unsigned int length, float *pEnergy);
+	/* filter bank kernels over tap-major arrays, element [i*stride + c] is
+	 * tap i of channel c (stride >= channels); the SIMD lanes run across
+	 * channels */
+	void (*BankDot)(const double *pW, const double *pX, unsigned int length,
+	                unsigned int channels, unsigned int stride,
+	                double *pOut, double *pEnergy); /* per channel c: pOut[c] = sum of
+	                                                 * w*x, pEnergy[c] = sum of x^2 */
+	void (*BankScaledAdd)(double *pW, const double *pScale, const double *pX,
+	                      unsigned int length, unsigned int channels,
+	                      unsigned int stride); /* w += pScale[c]*x */
+	/* proportionate update kernels (per-tap step gains) */
+	double (*PropGain)(double *pGain, const double *pW, const double *pX, double offset,
+	                   double scale, double floor, unsigned int length); /* pGain = offset +
+	                                                                      * scale*max(|pW|,floor),
+	                                                                      * returns sum of pGain*pX^2 */
+	void (*PropUpdate)(double *pW, double step, const double *pGain, const double *pX,
+	                   unsigned int length, double *pNorms); /* pW += step*pGain*pX, then
+	                                                          * pNorms = {sum |pW|, max |pW|} */
+} AfKernels;
+
+/* error bound between any kernel table and the scalar reference */
+#define AF_KERNEL_TOLERANCE(length, magnitude) ((length) * DBL_EPSILON * (magnitude))
+#define AF_KERNEL_TOLERANCE_F(length, magnitude) ((length) * FLT_EPSILON * (magnitude))
+
+const AfKernels *AfKernelsGet(AfIsa isa);
+
+/* per-ISA tables, built only when the compiler can target them */
+extern const AfKernels AfKernelsAvx2;
+extern const AfKernels AfKernelsAvx512;
+
+#endif /* AFKERNELS_H_ */
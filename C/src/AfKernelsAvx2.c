@@ -0,0 +1,479 @@
+/*
+ * @file AfKernelsAvx2.c
+ *
+ * AVX2/FMA kernel table. This file is compiled with -mavx2 -mfma and is only
+ * entered after AfKernelsGet() has confirmed host support.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+/******************************************************************************/
+/* include block */
+#include "AfKernels.h"
+#include <immintrin.h>
+
+/******************************************************************************/
+/** local definitions **/
+static double Avx2Dot(const double *pA, const double *pB, unsigned int length);
+static void Avx2ScaledAdd(double *pOut, double scale, const double *pIn, unsigned int length);
+static double Avx2SquaredNorm(const double *pIn, unsigned int length);
+static double Avx2UpdateDot(double *pW, const double *pNew, const double *pOld, double scale,
+                            unsigned int length, double *pEnergy);
+static float Avx2DotF(const float *pA, const float *pB, unsigned int length);
+static void Avx2ScaledAddF(float *pOut, float scale, const float *pIn, unsigned int length);
+static float Avx2SquaredNormF(const float *pIn, unsigned int length);
+static float Avx2UpdateDotF(float *pW, const float *pNew, const float *pOld, float scale,
+                            unsigned int length, float *pEnergy);
+static void Avx2BankDot(const double *pW, const double *pX, unsigned int length,
+                        unsigned int channels, unsigned int stride,
+                        double *pOut, double *pEnergy);
+static void Avx2BankScaledAdd(double *pW, const double *pScale, const double *pX,
+                              unsigned int length, unsigned int channels,
+                              unsigned int stride);
+static double Avx2PropGain(double *pGain, const double *pW, const double *pX, double offset,
+                           double scale, double floor, unsigned int length);
+static void Avx2PropUpdate(double *pW, double step, const double *pGain, const double *pX,
+                           unsigned int length, double *pNorms);
+static double HorizontalSum(__m256d x);
+static float HorizontalSumF(__m256 x);
+
+const AfKernels AfKernelsAvx2 = {
+	AF_ISA_AVX2, "avx2", Avx2Dot, Avx2ScaledAdd, Avx2SquaredNorm, Avx2UpdateDot,
+	Avx2DotF, Avx2ScaledAddF, Avx2SquaredNormF, Avx2UpdateDotF,
+	Avx2BankDot, Avx2BankScaledAdd, Avx2PropGain, Avx2PropUpdate
+};
+
+/** internal functions **/
+
+/***************************************************************************//**
+* Avx2Dot
+*
+* @note          Four 4-lane FMA partial sums hide the FMA latency.
+*******************************************************************************/
+static double Avx2Dot(const double *pA, const double *pB, unsigned int length) {
+	__m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+	__m256d acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+	double output;
+	unsigned int i = 0;
+
+	for ( ; i + 16 <= length; i += 16 ) {
+		acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(pA + i), _mm256_loadu_pd(pB + i), acc0);
+		acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(pA + i + 4), _mm256_loadu_pd(pB + i + 4), acc1);
+		acc2 = _mm256_fmadd_pd(_mm256_loadu_pd(pA + i + 8), _mm256_loadu_pd(pB + i + 8), acc2);
+		acc3 = _mm256_fmadd_pd(_mm256_loadu_pd(pA + i + 12), _mm256_loadu_pd(pB + i + 12), acc3);
+	}
+	for ( ; i + 4 <= length; i += 4 ) {
+		acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(pA + i), _mm256_loadu_pd(pB + i), acc0);
+	}
+	output = HorizontalSum(_mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+
+	for ( ; i < length; i++ ) {
+		output += pA[i] * pB[i];
+	}
+
+	return output;
+}
+/* End of Avx2Dot()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Avx2ScaledAdd
+*
+* @note          pOut += scale * pIn, one FMA per four elements.
+*******************************************************************************/
+static void Avx2ScaledAdd(double *pOut, double scale, const double *pIn, unsigned int length) {
+	const __m256d s = _mm256_set1_pd(scale);
+	unsigned int i = 0;
+
+	for ( ; i + 8 <= length; i += 8 ) {
+		_mm256_storeu_pd(pOut + i, _mm256_fmadd_pd(s, _mm256_loadu_pd(pIn + i), _mm256_loadu_pd(pOut + i)));
+		_mm256_storeu_pd(pOut + i + 4, _mm256_fmadd_pd(s, _mm256_loadu_pd(pIn + i + 4), _mm256_loadu_pd(pOut + i + 4)));
+	}
+	for ( ; i < length; i++ ) {
+		pOut[i] += scale * pIn[i];
+	}
+}
+/* End of Avx2ScaledAdd()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Avx2SquaredNorm
+*
+* @note          Squared-norm counterpart of Avx2Dot.
+*******************************************************************************/
+static double Avx2SquaredNorm(const double *pIn, unsigned int length) {
+	__m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+	__m256d acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+	__m256d x0, x1, x2, x3;
+	double output;
+	unsigned int i = 0;
+
+	for ( ; i + 16 <= length; i += 16 ) {
+		x0 = _mm256_loadu_pd(pIn + i);
+		x1 = _mm256_loadu_pd(pIn + i + 4);
+		x2 = _mm256_loadu_pd(pIn + i + 8);
+		x3 = _mm256_loadu_pd(pIn + i + 12);
+		acc0 = _mm256_fmadd_pd(x0, x0, acc0);
+		acc1 = _mm256_fmadd_pd(x1, x1, acc1);
+		acc2 = _mm256_fmadd_pd(x2, x2, acc2);
+		acc3 = _mm256_fmadd_pd(x3, x3, acc3);
+	}
+	for ( ; i + 4 <= length; i += 4 ) {
+		x0 = _mm256_loadu_pd(pIn + i);
+		acc0 = _mm256_fmadd_pd(x0, x0, acc0);
+	}
+	output = HorizontalSum(_mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+
+	for ( ; i < length; i++ ) {
+		output += pIn[i] * pIn[i];
+	}
+
+	return output;
+}
+/* End of Avx2SquaredNorm()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Avx2UpdateDot
+*
+* @note          Fused update and dot product, eight weights per iteration.
+*******************************************************************************/
+static double Avx2UpdateDot(double *pW, const double *pNew, const double *pOld, double scale,
+                            unsigned int length, double *pEnergy) {
+	const __m256d s = _mm256_set1_pd(scale);
+	__m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+	__m256d eacc0 = _mm256_setzero_pd(), eacc1 = _mm256_setzero_pd();
+	__m256d w0, w1, x0, x1;
+	double output, energy;
+	unsigned int i = 0;
+
+	for ( ; i + 8 <= length; i += 8 ) {
+		w0 = _mm256_fmadd_pd(s, _mm256_loadu_pd(pOld + i), _mm256_loadu_pd(pW + i));
+		w1 = _mm256_fmadd_pd(s, _mm256_loadu_pd(pOld + i + 4), _mm256_loadu_pd(pW + i + 4));
+		_mm256_storeu_pd(pW + i, w0);
+		_mm256_storeu_pd(pW + i + 4, w1);
+		x0 = _mm256_loadu_pd(pNew + i);
+		x1 = _mm256_loadu_pd(pNew + i + 4);
+		acc0 = _mm256_fmadd_pd(w0, x0, acc0);
+		acc1 = _mm256_fmadd_pd(w1, x1, acc1);
+		eacc0 = _mm256_fmadd_pd(x0, x0, eacc0);
+		eacc1 = _mm256_fmadd_pd(x1, x1, eacc1);
+	}
+	output = HorizontalSum(_mm256_add_pd(acc0, acc1));
+	energy = HorizontalSum(_mm256_add_pd(eacc0, eacc1));
+
+	for ( ; i < length; i++ ) {
+		pW[i] += scale * pOld[i];
+		output += pW[i] * pNew[i];
+		energy += pNew[i] * pNew[i];
+	}
+	*pEnergy += energy;
+
+	return output;
+}
+/* End of Avx2UpdateDot()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* HorizontalSum
+*
+* @note          Adds the four lanes of x.
+*******************************************************************************/
+static double HorizontalSum(__m256d x) {
+	__m128d sum = _mm_add_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+
+	sum = _mm_add_sd(sum, _mm_unpackhi_pd(sum, sum));
+
+	return _mm_cvtsd_f64(sum);
+}
+/* End of HorizontalSum()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Avx2DotF
+*
+* @note          Single precision Avx2Dot, four 8-lane partial sums.
+*******************************************************************************/
+static float Avx2DotF(const float *pA, const float *pB, unsigned int length) {
+	__m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+	__m256 acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+	float output;
+	unsigned int i = 0;
+
+	for ( ; i + 32 <= length; i += 32 ) {
+		acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(pA + i), _mm256_loadu_ps(pB + i), acc0);
+		acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(pA + i + 8), _mm256_loadu_ps(pB + i + 8), acc1);
+		acc2 = _mm256_fmadd_ps(_mm256_loadu_ps(pA + i + 16), _mm256_loadu_ps(pB + i + 16), acc2);
+		acc3 = _mm256_fmadd_ps(_mm256_loadu_ps(pA + i + 24), _mm256_loadu_ps(pB + i + 24), acc3);
+	}
+	for ( ; i + 8 <= length; i += 8 ) {
+		acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(pA + i), _mm256_loadu_ps(pB + i), acc0);
+	}
+	output = HorizontalSumF(_mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3)));
+
+	for ( ; i < length; i++ ) {
+		output += pA[i] * pB[i];
+	}
+
+	return output;
+}
+/* End of Avx2DotF()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Avx2ScaledAddF
+*
+* @note          Single precision Avx2ScaledAdd.
+*******************************************************************************/
+static void Avx2ScaledAddF(float *pOut, float scale, const float *pIn, unsigned int length) {
+	const __m256 s = _mm256_set1_ps(scale);
+	unsigned int i = 0;
+
+	for ( ; i + 16 <= length; i += 16 ) {
+		_mm256_storeu_ps(pOut + i, _mm256_fmadd_ps(s, _mm256_loadu_ps(pIn + i), _mm256_loadu_ps(pOut + i)));
+		_mm256_storeu_ps(pOut + i + 8, _mm256_fmadd_ps(s, _mm256_loadu_ps(pIn + i + 8), _mm256_loadu_ps(pOut + i + 8)));
+	}
+	for ( ; i < length; i++ ) {
+		pOut[i] += scale * pIn[i];
+	}
+}
+/* End of Avx2ScaledAddF()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Avx2SquaredNormF
+*
+* @note          Single precision Avx2SquaredNorm.
+*******************************************************************************/
+static float Avx2SquaredNormF(const float *pIn, unsigned int length) {
+	__m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+	__m256 x0, x1;
+	float output;
+	unsigned int i = 0;
+
+	for ( ; i + 16 <= length; i += 16 ) {
+		x0 = _mm256_loadu_ps(pIn + i);
+		x1 = _mm256_loadu_ps(pIn + i + 8);
+		acc0 = _mm256_fmadd_ps(x0, x0, acc0);
+		acc1 = _mm256_fmadd_ps(x1, x1, acc1);
+	}
+	output = HorizontalSumF(_mm256_add_ps(acc0, acc1));
+
+	for ( ; i < length; i++ ) {
+		output += pIn[i] * pIn[i];
+	}
+
+	return output;
+}
+/* End of Avx2SquaredNormF()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Avx2UpdateDotF
+*
+* @note          Single precision Avx2UpdateDot, sixteen weights per iteration.
+*******************************************************************************/
+static float Avx2UpdateDotF(float *pW, const float *pNew, const float *pOld, float scale,
+                            unsigned int length, float *pEnergy) {
+	const __m256 s = _mm256_set1_ps(scale);
+	__m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+	__m256 eacc0 = _mm256_setzero_ps(), eacc1 = _mm256_setzero_ps();
+	__m256 w0, w1, x0, x1;
+	float output, energy;
+	unsigned int i = 0;
+
+	for ( ; i + 16 <= length; i += 16 ) {
+		w0 = _mm256_fmadd_ps(s, _mm256_loadu_ps(pOld + i), _mm256_loadu_ps(pW + i));
+		w1 = _mm256_fmadd_ps(s, _mm256_loadu_ps(pOld + i + 8), _mm256_loadu_ps(pW + i + 8));
+		_mm256_storeu_ps(pW + i, w0);
+		_mm256_storeu_ps(pW + i + 8, w1);
+		x0 = _mm256_loadu_ps(pNew + i);
+		x1 = _mm256_loadu_ps(pNew + i + 8);
+		acc0 = _mm256_fmadd_ps(w0, x0, acc0);
+		acc1 = _mm256_fmadd_ps(w1, x1, acc1);
+		eacc0 = _mm256_fmadd_ps(x0, x0, eacc0);
+		eacc1 = _mm256_fmadd_ps(x1, x1, eacc1);
+	}
+	output = HorizontalSumF(_mm256_add_ps(acc0, acc1));
+	energy = HorizontalSumF(_mm256_add_ps(eacc0, eacc1));
+
+	for ( ; i < length; i++ ) {
+		pW[i] += scale * pOld[i];
+		output += pW[i] * pNew[i];
+		energy += pNew[i] * pNew[i];
+	}
+	*pEnergy += energy;
+
+	return output;
+}
+/* End of Avx2UpdateDotF()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Avx2BankDot
+*
+* @note          Eight channels (one cache line) per pass with their sums
+*  held in registers across all taps, then four, then one at a time.
+*******************************************************************************/
+static void Avx2BankDot(const double *pW, const double *pX, unsigned int length,
+                        unsigned int channels, unsigned int stride,
+                        double *pOut, double *pEnergy) {
+	__m256d acc0, acc1, eacc0, eacc1, x0, x1;
+	double acc, eacc;
+	size_t off;
+	unsigned int i, c = 0;
+
+	for ( ; c + 8 <= channels; c += 8 ) {
+		acc0 = acc1 = eacc0 = eacc1 = _mm256_setzero_pd();
+		for ( i = 0, off = c; i < length; i++, off += stride ) {
+			x0 = _mm256_loadu_pd(pX + off);
+			x1 = _mm256_loadu_pd(pX + off + 4);
+			acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(pW + off), x0, acc0);
+			acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(pW + off + 4), x1, acc1);
+			eacc0 = _mm256_fmadd_pd(x0, x0, eacc0);
+			eacc1 = _mm256_fmadd_pd(x1, x1, eacc1);
+		}
+		_mm256_storeu_pd(pOut + c, acc0);
+		_mm256_storeu_pd(pOut + c + 4, acc1);
+		_mm256_storeu_pd(pEnergy + c, eacc0);
+		_mm256_storeu_pd(pEnergy + c + 4, eacc1);
+	}
+	for ( ; c + 4 <= channels; c += 4 ) {
+		acc0 = eacc0 = _mm256_setzero_pd();
+		for ( i = 0, off = c; i < length; i++, off += stride ) {
+			x0 = _mm256_loadu_pd(pX + off);
+			acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(pW + off), x0, acc0);
+			eacc0 = _mm256_fmadd_pd(x0, x0, eacc0);
+		}
+		_mm256_storeu_pd(pOut + c, acc0);
+		_mm256_storeu_pd(pEnergy + c, eacc0);
+	}
+	for ( ; c < channels; c++ ) {
+		acc = eacc = 0.0;
+		for ( i = 0, off = c; i < length; i++, off += stride ) {
+			acc += pW[off] * pX[off];
+			eacc += pX[off] * pX[off];
+		}
+		pOut[c] = acc;
+		pEnergy[c] = eacc;
+	}
+}
+/* End of Avx2BankDot()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Avx2BankScaledAdd
+*
+* @note          w += scale[c] * x a row of channels at a time, one FMA per
+*  four channels.
+*******************************************************************************/
+static void Avx2BankScaledAdd(double *pW, const double *pScale, const double *pX,
+                              unsigned int length, unsigned int channels,
+                              unsigned int stride) {
+	unsigned int i, c;
+
+	for ( i = 0; i < length; i++, pW += stride, pX += stride ) {
+		for ( c = 0; c + 4 <= channels; c += 4 ) {
+			_mm256_storeu_pd(pW + c, _mm256_fmadd_pd(_mm256_loadu_pd(pScale + c),
+			                 _mm256_loadu_pd(pX + c), _mm256_loadu_pd(pW + c)));
+		}
+		for ( ; c < channels; c++ ) {
+			pW[c] += pScale[c] * pX[c];
+		}
+	}
+}
+/* End of Avx2BankScaledAdd()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Avx2PropGain
+*
+* @note          Gains with one FMA per four taps, two energy partial sums.
+*******************************************************************************/
+static double Avx2PropGain(double *pGain, const double *pW, const double *pX, double offset,
+                           double scale, double floor, unsigned int length) {
+	const __m256d sign = _mm256_set1_pd(-0.0), o = _mm256_set1_pd(offset);
+	const __m256d s = _mm256_set1_pd(scale), f = _mm256_set1_pd(floor);
+	__m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd(), g0, g1, x0, x1;
+	double energy, magnitude;
+	unsigned int i = 0;
+
+	for ( ; i + 8 <= length; i += 8 ) {
+		g0 = _mm256_fmadd_pd(s, _mm256_max_pd(_mm256_andnot_pd(sign, _mm256_loadu_pd(pW + i)), f), o);
+		g1 = _mm256_fmadd_pd(s, _mm256_max_pd(_mm256_andnot_pd(sign, _mm256_loadu_pd(pW + i + 4)), f), o);
+		_mm256_storeu_pd(pGain + i, g0);
+		_mm256_storeu_pd(pGain + i + 4, g1);
+		x0 = _mm256_loadu_pd(pX + i);
+		x1 = _mm256_loadu_pd(pX + i + 4);
+		acc0 = _mm256_fmadd_pd(_mm256_mul_pd(g0, x0), x0, acc0);
+		acc1 = _mm256_fmadd_pd(_mm256_mul_pd(g1, x1), x1, acc1);
+	}
+	energy = HorizontalSum(_mm256_add_pd(acc0, acc1));
+
+	for ( ; i < length; i++ ) {
+		magnitude = (pW[i] < 0) ? -pW[i] : pW[i];
+		if (magnitude < floor) {
+			magnitude = floor;
+		}
+		pGain[i] = offset + scale * magnitude;
+		energy += pGain[i] * pX[i] * pX[i];
+	}
+
+	return energy;
+}
+/* End of Avx2PropGain()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Avx2PropUpdate
+*
+* @note          Weight update with FMA; the L1 and max norms are taken from
+*  the updated weights while still in registers.
+*******************************************************************************/
+static void Avx2PropUpdate(double *pW, double step, const double *pGain, const double *pX,
+                           unsigned int length, double *pNorms) {
+	const __m256d sign = _mm256_set1_pd(-0.0), s = _mm256_set1_pd(step);
+	__m256d sum = _mm256_setzero_pd(), peak = _mm256_setzero_pd(), w;
+	__m128d half;
+	double magnitude;
+	unsigned int i = 0;
+
+	for ( ; i + 4 <= length; i += 4 ) {
+		w = _mm256_fmadd_pd(_mm256_mul_pd(s, _mm256_loadu_pd(pGain + i)), _mm256_loadu_pd(pX + i),
+		                    _mm256_loadu_pd(pW + i));
+		_mm256_storeu_pd(pW + i, w);
+		w = _mm256_andnot_pd(sign, w);
+		sum = _mm256_add_pd(sum, w);
+		peak = _mm256_max_pd(peak, w);
+	}
+	pNorms[0] = HorizontalSum(sum);
+	half = _mm_max_pd(_mm256_castpd256_pd128(peak), _mm256_extractf128_pd(peak, 1));
+	pNorms[1] = _mm_cvtsd_f64(_mm_max_sd(half, _mm_unpackhi_pd(half, half)));
+
+	for ( ; i < length; i++ ) {
+		pW[i] += step * pGain[i] * pX[i];
+		magnitude = (pW[i] < 0) ? -pW[i] : pW[i];
+		pNorms[0] += magnitude;
+		if (magnitude > pNorms[1]) {
+			pNorms[1] = magnitude;
+		}
+	}
+}
+/* End of Avx2PropUpdate()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* HorizontalSumF
+*
+* @note          Adds the eight lanes of x.
+*******************************************************************************/
+static float HorizontalSumF(__m256 x) {
+	__m128 sum = _mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+
+	sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+	sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+
+	return _mm_cvtss_f32(sum);
+}
+/* End of HorizontalSumF()*/
+/******************************************************************************/
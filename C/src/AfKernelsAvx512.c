@@ -0,0 +1,421 @@
+/*
+ * @file AfKernelsAvx512.c
+ *
+ * AVX-512F kernel table. This file is compiled with -mavx512f and is only
+ * entered after AfKernelsGet() has confirmed host support.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+/******************************************************************************/
+/* include block */
+#include "AfKernels.h"
+#include <immintrin.h>
+
+/******************************************************************************/
+/** local definitions **/
+static double Avx512Dot(const double *pA, const double *pB, unsigned int length);
+static void Avx512ScaledAdd(double *pOut, double scale, const double *pIn, unsigned int length);
+static double Avx512SquaredNorm(const double *pIn, unsigned int length);
+static double Avx512UpdateDot(double *pW, const double *pNew, const double *pOld, double scale,
+                              unsigned int length, double *pEnergy);
+
+static float Avx512DotF(const float *pA, const float *pB, unsigned int length);
+static void Avx512ScaledAddF(float *pOut, float scale, const float *pIn, unsigned int length);
+static float Avx512SquaredNormF(const float *pIn, unsigned int length);
+static float Avx512UpdateDotF(float *pW, const float *pNew, const float *pOld, float scale,
+                              unsigned int length, float *pEnergy);
+static void Avx512BankDot(const double *pW, const double *pX, unsigned int length,
+                          unsigned int channels, unsigned int stride,
+                          double *pOut, double *pEnergy);
+static void Avx512BankScaledAdd(double *pW, const double *pScale, const double *pX,
+                                unsigned int length, unsigned int channels,
+                                unsigned int stride);
+static double Avx512PropGain(double *pGain, const double *pW, const double *pX, double offset,
+                             double scale, double floor, unsigned int length);
+static void Avx512PropUpdate(double *pW, double step, const double *pGain, const double *pX,
+                             unsigned int length, double *pNorms);
+
+const AfKernels AfKernelsAvx512 = {
+	AF_ISA_AVX512, "avx512", Avx512Dot, Avx512ScaledAdd, Avx512SquaredNorm, Avx512UpdateDot,
+	Avx512DotF, Avx512ScaledAddF, Avx512SquaredNormF, Avx512UpdateDotF,
+	Avx512BankDot, Avx512BankScaledAdd, Avx512PropGain, Avx512PropUpdate
+};
+
+/** internal functions **/
+
+/***************************************************************************//**
+* Avx512Dot
+*
+* @note          Four 8-lane FMA partial sums; the tail is a masked load so
+*  no scalar cleanup loop is needed.
+*******************************************************************************/
+static double Avx512Dot(const double *pA, const double *pB, unsigned int length) {
+	__m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+	__m512d acc2 = _mm512_setzero_pd(), acc3 = _mm512_setzero_pd();
+	__mmask8 tail;
+	unsigned int i = 0;
+
+	for ( ; i + 32 <= length; i += 32 ) {
+		acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(pA + i), _mm512_loadu_pd(pB + i), acc0);
+		acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(pA + i + 8), _mm512_loadu_pd(pB + i + 8), acc1);
+		acc2 = _mm512_fmadd_pd(_mm512_loadu_pd(pA + i + 16), _mm512_loadu_pd(pB + i + 16), acc2);
+		acc3 = _mm512_fmadd_pd(_mm512_loadu_pd(pA + i + 24), _mm512_loadu_pd(pB + i + 24), acc3);
+	}
+	for ( ; i + 8 <= length; i += 8 ) {
+		acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(pA + i), _mm512_loadu_pd(pB + i), acc0);
+	}
+	if (i < length) {
+		tail = (__mmask8)((1u << (length - i)) - 1);
+		acc1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(tail, pA + i), _mm512_maskz_loadu_pd(tail, pB + i), acc1);
+	}
+
+	return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3)));
+}
+/* End of Avx512Dot()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Avx512ScaledAdd
+*
+* @note          pOut += scale * pIn with a masked tail.
+*******************************************************************************/
+static void Avx512ScaledAdd(double *pOut, double scale, const double *pIn, unsigned int length) {
+	const __m512d s = _mm512_set1_pd(scale);
+	__mmask8 tail;
+	unsigned int i = 0;
+
+	for ( ; i + 8 <= length; i += 8 ) {
+		_mm512_storeu_pd(pOut + i, _mm512_fmadd_pd(s, _mm512_loadu_pd(pIn + i), _mm512_loadu_pd(pOut + i)));
+	}
+	if (i < length) {
+		tail = (__mmask8)((1u << (length - i)) - 1);
+		_mm512_mask_storeu_pd(pOut + i, tail,
+			_mm512_fmadd_pd(s, _mm512_maskz_loadu_pd(tail, pIn + i), _mm512_maskz_loadu_pd(tail, pOut + i)));
+	}
+}
+/* End of Avx512ScaledAdd()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Avx512SquaredNorm
+*
+* @note          Squared-norm counterpart of Avx512Dot.
+*******************************************************************************/
+static double Avx512SquaredNorm(const double *pIn, unsigned int length) {
+	__m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+	__m512d acc2 = _mm512_setzero_pd(), acc3 = _mm512_setzero_pd();
+	__m512d x0, x1, x2, x3;
+	__mmask8 tail;
+	unsigned int i = 0;
+
+	for ( ; i + 32 <= length; i += 32 ) {
+		x0 = _mm512_loadu_pd(pIn + i);
+		x1 = _mm512_loadu_pd(pIn + i + 8);
+		x2 = _mm512_loadu_pd(pIn + i + 16);
+		x3 = _mm512_loadu_pd(pIn + i + 24);
+		acc0 = _mm512_fmadd_pd(x0, x0, acc0);
+		acc1 = _mm512_fmadd_pd(x1, x1, acc1);
+		acc2 = _mm512_fmadd_pd(x2, x2, acc2);
+		acc3 = _mm512_fmadd_pd(x3, x3, acc3);
+	}
+	for ( ; i + 8 <= length; i += 8 ) {
+		x0 = _mm512_loadu_pd(pIn + i);
+		acc0 = _mm512_fmadd_pd(x0, x0, acc0);
+	}
+	if (i < length) {
+		tail = (__mmask8)((1u << (length - i)) - 1);
+		x1 = _mm512_maskz_loadu_pd(tail, pIn + i);
+		acc1 = _mm512_fmadd_pd(x1, x1, acc1);
+	}
+
+	return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3)));
+}
+/* End of Avx512SquaredNorm()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Avx512UpdateDot
+*
+* @note          Fused update and dot product, sixteen weights per iteration
+*  with a masked tail.
+*******************************************************************************/
+static double Avx512UpdateDot(double *pW, const double *pNew, const double *pOld, double scale,
+                              unsigned int length, double *pEnergy) {
+	const __m512d s = _mm512_set1_pd(scale);
+	__m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+	__m512d eacc0 = _mm512_setzero_pd(), eacc1 = _mm512_setzero_pd();
+	__m512d w0, w1, x0, x1;
+	__mmask8 tail;
+	unsigned int i = 0;
+
+	for ( ; i + 16 <= length; i += 16 ) {
+		w0 = _mm512_fmadd_pd(s, _mm512_loadu_pd(pOld + i), _mm512_loadu_pd(pW + i));
+		w1 = _mm512_fmadd_pd(s, _mm512_loadu_pd(pOld + i + 8), _mm512_loadu_pd(pW + i + 8));
+		_mm512_storeu_pd(pW + i, w0);
+		_mm512_storeu_pd(pW + i + 8, w1);
+		x0 = _mm512_loadu_pd(pNew + i);
+		x1 = _mm512_loadu_pd(pNew + i + 8);
+		acc0 = _mm512_fmadd_pd(w0, x0, acc0);
+		acc1 = _mm512_fmadd_pd(w1, x1, acc1);
+		eacc0 = _mm512_fmadd_pd(x0, x0, eacc0);
+		eacc1 = _mm512_fmadd_pd(x1, x1, eacc1);
+	}
+	for ( ; i < length; i += 8 ) {
+		tail = (length - i >= 8) ? (__mmask8)0xFF : (__mmask8)((1u << (length - i)) - 1);
+		w0 = _mm512_fmadd_pd(s, _mm512_maskz_loadu_pd(tail, pOld + i), _mm512_maskz_loadu_pd(tail, pW + i));
+		_mm512_mask_storeu_pd(pW + i, tail, w0);
+		x0 = _mm512_maskz_loadu_pd(tail, pNew + i);
+		acc0 = _mm512_fmadd_pd(w0, x0, acc0);
+		eacc0 = _mm512_fmadd_pd(x0, x0, eacc0);
+	}
+	*pEnergy += _mm512_reduce_add_pd(_mm512_add_pd(eacc0, eacc1));
+
+	return _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1));
+}
+/* End of Avx512UpdateDot()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Avx512DotF
+*
+* @note          Single precision Avx512Dot, sixteen lanes per vector.
+*******************************************************************************/
+static float Avx512DotF(const float *pA, const float *pB, unsigned int length) {
+	__m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+	__m512 acc2 = _mm512_setzero_ps(), acc3 = _mm512_setzero_ps();
+	__mmask16 tail;
+	unsigned int i = 0;
+
+	for ( ; i + 64 <= length; i += 64 ) {
+		acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(pA + i), _mm512_loadu_ps(pB + i), acc0);
+		acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(pA + i + 16), _mm512_loadu_ps(pB + i + 16), acc1);
+		acc2 = _mm512_fmadd_ps(_mm512_loadu_ps(pA + i + 32), _mm512_loadu_ps(pB + i + 32), acc2);
+		acc3 = _mm512_fmadd_ps(_mm512_loadu_ps(pA + i + 48), _mm512_loadu_ps(pB + i + 48), acc3);
+	}
+	for ( ; i + 16 <= length; i += 16 ) {
+		acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(pA + i), _mm512_loadu_ps(pB + i), acc0);
+	}
+	if (i < length) {
+		tail = (__mmask16)((1u << (length - i)) - 1);
+		acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(tail, pA + i), _mm512_maskz_loadu_ps(tail, pB + i), acc1);
+	}
+
+	return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3)));
+}
+/* End of Avx512DotF()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Avx512ScaledAddF
+*
+* @note          Single precision Avx512ScaledAdd.
+*******************************************************************************/
+static void Avx512ScaledAddF(float *pOut, float scale, const float *pIn, unsigned int length) {
+	const __m512 s = _mm512_set1_ps(scale);
+	__mmask16 tail;
+	unsigned int i = 0;
+
+	for ( ; i + 16 <= length; i += 16 ) {
+		_mm512_storeu_ps(pOut + i, _mm512_fmadd_ps(s, _mm512_loadu_ps(pIn + i), _mm512_loadu_ps(pOut + i)));
+	}
+	if (i < length) {
+		tail = (__mmask16)((1u << (length - i)) - 1);
+		_mm512_mask_storeu_ps(pOut + i, tail,
+			_mm512_fmadd_ps(s, _mm512_maskz_loadu_ps(tail, pIn + i), _mm512_maskz_loadu_ps(tail, pOut + i)));
+	}
+}
+/* End of Avx512ScaledAddF()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Avx512SquaredNormF
+*
+* @note          Single precision Avx512SquaredNorm.
+*******************************************************************************/
+static float Avx512SquaredNormF(const float *pIn, unsigned int length) {
+	__m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps(), x0, x1;
+	__mmask16 tail;
+	unsigned int i = 0;
+
+	for ( ; i + 32 <= length; i += 32 ) {
+		x0 = _mm512_loadu_ps(pIn + i);
+		x1 = _mm512_loadu_ps(pIn + i + 16);
+		acc0 = _mm512_fmadd_ps(x0, x0, acc0);
+		acc1 = _mm512_fmadd_ps(x1, x1, acc1);
+	}
+	for ( ; i < length; i += 16 ) {
+		tail = (length - i >= 16) ? (__mmask16)0xFFFF : (__mmask16)((1u << (length - i)) - 1);
+		x0 = _mm512_maskz_loadu_ps(tail, pIn + i);
+		acc0 = _mm512_fmadd_ps(x0, x0, acc0);
+	}
+
+	return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+}
+/* End of Avx512SquaredNormF()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Avx512UpdateDotF
+*
+* @note          Single precision Avx512UpdateDot.
+*******************************************************************************/
+static float Avx512UpdateDotF(float *pW, const float *pNew, const float *pOld, float scale,
+                              unsigned int length, float *pEnergy) {
+	const __m512 s = _mm512_set1_ps(scale);
+	__m512 acc = _mm512_setzero_ps(), eacc = _mm512_setzero_ps(), w, x;
+	__mmask16 tail;
+	unsigned int i = 0;
+
+	for ( ; i < length; i += 16 ) {
+		tail = (length - i >= 16) ? (__mmask16)0xFFFF : (__mmask16)((1u << (length - i)) - 1);
+		w = _mm512_fmadd_ps(s, _mm512_maskz_loadu_ps(tail, pOld + i), _mm512_maskz_loadu_ps(tail, pW + i));
+		_mm512_mask_storeu_ps(pW + i, tail, w);
+		x = _mm512_maskz_loadu_ps(tail, pNew + i);
+		acc = _mm512_fmadd_ps(w, x, acc);
+		eacc = _mm512_fmadd_ps(x, x, eacc);
+	}
+	*pEnergy += _mm512_reduce_add_ps(eacc);
+
+	return _mm512_reduce_add_ps(acc);
+}
+/* End of Avx512UpdateDotF()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Avx512BankDot
+*
+* @note          Sixteen channels per pass with their sums held in registers
+*  across all taps, then eight at a time; the last partial group of channels
+*  uses masked loads and stores.
+*******************************************************************************/
+static void Avx512BankDot(const double *pW, const double *pX, unsigned int length,
+                          unsigned int channels, unsigned int stride,
+                          double *pOut, double *pEnergy) {
+	__m512d acc0, acc1, eacc0, eacc1, x0, x1;
+	__mmask8 tail;
+	size_t off;
+	unsigned int i, c = 0;
+
+	for ( ; c + 16 <= channels; c += 16 ) {
+		acc0 = acc1 = eacc0 = eacc1 = _mm512_setzero_pd();
+		for ( i = 0, off = c; i < length; i++, off += stride ) {
+			x0 = _mm512_loadu_pd(pX + off);
+			x1 = _mm512_loadu_pd(pX + off + 8);
+			acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(pW + off), x0, acc0);
+			acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(pW + off + 8), x1, acc1);
+			eacc0 = _mm512_fmadd_pd(x0, x0, eacc0);
+			eacc1 = _mm512_fmadd_pd(x1, x1, eacc1);
+		}
+		_mm512_storeu_pd(pOut + c, acc0);
+		_mm512_storeu_pd(pOut + c + 8, acc1);
+		_mm512_storeu_pd(pEnergy + c, eacc0);
+		_mm512_storeu_pd(pEnergy + c + 8, eacc1);
+	}
+	for ( ; c < channels; c += 8 ) {
+		tail = (channels - c >= 8) ? (__mmask8)0xFF : (__mmask8)((1u << (channels - c)) - 1);
+		acc0 = eacc0 = _mm512_setzero_pd();
+		for ( i = 0, off = c; i < length; i++, off += stride ) {
+			x0 = _mm512_maskz_loadu_pd(tail, pX + off);
+			acc0 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(tail, pW + off), x0, acc0);
+			eacc0 = _mm512_fmadd_pd(x0, x0, eacc0);
+		}
+		_mm512_mask_storeu_pd(pOut + c, tail, acc0);
+		_mm512_mask_storeu_pd(pEnergy + c, tail, eacc0);
+	}
+}
+/* End of Avx512BankDot()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Avx512BankScaledAdd
+*
+* @note          w += scale[c] * x a row of channels at a time, with a masked
+*  tail per row.
+*******************************************************************************/
+static void Avx512BankScaledAdd(double *pW, const double *pScale, const double *pX,
+                                unsigned int length, unsigned int channels,
+                                unsigned int stride) {
+	__mmask8 tail;
+	unsigned int i, c;
+
+	for ( i = 0; i < length; i++, pW += stride, pX += stride ) {
+		for ( c = 0; c < channels; c += 8 ) {
+			tail = (channels - c >= 8) ? (__mmask8)0xFF : (__mmask8)((1u << (channels - c)) - 1);
+			_mm512_mask_storeu_pd(pW + c, tail,
+			                      _mm512_fmadd_pd(_mm512_maskz_loadu_pd(tail, pScale + c),
+			                                      _mm512_maskz_loadu_pd(tail, pX + c),
+			                                      _mm512_maskz_loadu_pd(tail, pW + c)));
+		}
+	}
+}
+/* End of Avx512BankScaledAdd()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Avx512PropGain
+*
+* @note          Eight taps per FMA with a masked tail; masked-off lanes load
+*  as zero, so they add nothing to the energy.
+*******************************************************************************/
+static double Avx512PropGain(double *pGain, const double *pW, const double *pX, double offset,
+                             double scale, double floor, unsigned int length) {
+	const __m512d o = _mm512_set1_pd(offset), s = _mm512_set1_pd(scale), f = _mm512_set1_pd(floor);
+	__m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd(), g, x;
+	__mmask8 tail;
+	unsigned int i = 0;
+
+	for ( ; i + 8 <= length; i += 8 ) {
+		g = _mm512_fmadd_pd(s, _mm512_max_pd(_mm512_abs_pd(_mm512_loadu_pd(pW + i)), f), o);
+		_mm512_storeu_pd(pGain + i, g);
+		x = _mm512_loadu_pd(pX + i);
+		acc0 = _mm512_fmadd_pd(_mm512_mul_pd(g, x), x, acc0);
+	}
+	if (i < length) {
+		tail = (__mmask8)((1u << (length - i)) - 1);
+		g = _mm512_fmadd_pd(s, _mm512_max_pd(_mm512_abs_pd(_mm512_maskz_loadu_pd(tail, pW + i)), f), o);
+		_mm512_mask_storeu_pd(pGain + i, tail, g);
+		x = _mm512_maskz_loadu_pd(tail, pX + i);
+		acc1 = _mm512_fmadd_pd(_mm512_mul_pd(g, x), x, acc1);
+	}
+
+	return _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1));
+}
+/* End of Avx512PropGain()*/
+/******************************************************************************/
+
+/***************************************************************************//**
+* Avx512PropUpdate
+*
+* @note          Masked-tail weight update; masked-off lanes are zero, so
+*  they do not change either norm.
+*******************************************************************************/
+static void Avx512PropUpdate(double *pW, double step, const double *pGain, const double *pX,
+                             unsigned int length, double *pNorms) {
+	const __m512d s = _mm512_set1_pd(step);
+	__m512d sum = _mm512_setzero_pd(), peak = _mm512_setzero_pd(), w;
+	__mmask8 tail;
+	unsigned int i = 0;
+
+	for ( ; i + 8 <= length; i += 8 ) {
+		w = _mm512_fmadd_pd(_mm512_mul_pd(s, _mm512_loadu_pd(pGain + i)), _mm512_loadu_pd(pX + i),
+		                    _mm512_loadu_pd(pW + i));
+		_mm512_storeu_pd(pW + i, w);
+		w = _mm512_abs_pd(w);
+		sum = _mm512_add_pd(sum, w);
+		peak = _mm512_max_pd(peak, w);
+	}
+	if (i < length) {
+		tail = (__mmask8)((1u << (length - i)) - 1);
+		w = _mm512_fmadd_pd(_mm512_mul_pd(s, _mm512_maskz_loadu_pd(tail, pGain + i)),
+		                    _mm512_maskz_loadu_pd(tail, pX + i), _mm512_maskz_loadu_pd(tail, pW + i));
+		_mm512_mask_storeu_pd(pW + i, tail, w);
+		w = _mm512_abs_pd(w);
+		sum = _mm512_add_pd(sum, w);
+		peak = _mm512_max_pd(peak, w);
+	}
+	pNorms[0] = _mm512_reduce_add_pd(sum);
+	pNorms[1] = _mm512_reduce_max_pd(peak);
+}
+/* End of Avx512PropUpdate()*/
+/******************************************************************************/
@@ -0,0 +1,191 @@
+/*
+ * @file AfMetrics.c
+ *
+ * Batched metrics recorder. AfMetricsRecord() only copies the raw values
+ * of every Decimation-th sample into the buffer; when the buffer is full,
+ * AfMetricsFlush() converts the whole batch to dB in one pass and writes it
+ * with a single fwrite() (binary) or one fprintf() per record (CSV), so
+ * neither log10() nor stdio runs per sample.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+/******************************************************************************/
+/* include block */
+#include "AfMetrics.h"
+#include <math.h>
+
+/******************************************************************************
+ * AfMetricsMemSize
+ *
+ * @param[in]     fields   values per sample
+ * @param[in]     capacity records buffered per batch
+ *
+ * @returns       number of bytes AfMetricsInit() needs in pMem
+ *
+ * @note          none
+ *
+ * @warning       none
+ */
+size_t AfMetricsMemSize(unsigned int fields, unsigned int capacity) {
+	return (size_t)capacity * (fields + 1) * sizeof(double);
+}
+/* End of AfMetricsMemSize() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfMetricsInit
+ *
+ * @param[out]    pMetrics   recorder to initialize
+ * @param[in]     fields     values per sample, at least 1
+ * @param[in]     capacity   records buffered per batch, at least 1
+ * @param[in]     decimation keep every decimation-th sample, 0 or 1: all
+ * @param[in]     format     AF_METRICS_CSV or AF_METRICS_BINARY
+ * @param[in]     pFile      open output file
+ * @param[in]     ppNames    fields column names for the CSV header, or NULL
+ *  for no header
+ * @param[in]     pMem       AfMetricsMemSize(fields, capacity) bytes,
+ *  aligned for double
+ *
+ * @returns       0 on success, -1 if fields, capacity or pFile is missing
+ *  or the CSV header cannot be written
+ *
+ * @note          none
+ *
+ * @warning       pMem and pFile must stay valid until the last
+ *  AfMetricsFlush()
+ */
+int AfMetricsInit(AfMetrics *pMetrics, unsigned int fields, unsigned int capacity,
+                  unsigned int decimation, AfMetricsFormat format, FILE *pFile,
+                  const char *const *ppNames, void *pMem) {
+	unsigned int i;
+
+	if (fields == 0 || capacity == 0 || !pFile) {
+		return -1;
+	}
+
+	pMetrics->Fields = fields;
+	pMetrics->Capacity = capacity;
+	pMetrics->Decimation = (decimation > 1) ? decimation : 1;
+	pMetrics->Countdown = pMetrics->Decimation;
+	pMetrics->Count = 0;
+	pMetrics->Samples = 0;
+	pMetrics->Format = format;
+	pMetrics->pFile = pFile;
+	pMetrics->pRecords = (double *)pMem;
+	pMetrics->Failed = 0;
+
+	if (format == AF_METRICS_CSV && ppNames) {
+		fprintf(pFile, "sample");
+		for ( i = 0; i < fields; i++ ) {
+			fprintf(pFile, ",%s", ppNames[i]);
+		}
+		if (fprintf(pFile, "\n") < 0) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+/* End of AfMetricsInit() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfMetricsRecord
+ *
+ * @param[in,out] pMetrics recorder
+ * @param[in]     pValues  Fields raw (linear power) values for this sample
+ *
+ * @returns       none
+ *
+ * @note          Writes a batch only when the buffer fills, every
+ *  Capacity * Decimation samples.
+ *
+ * @warning       none
+ */
+void AfMetricsRecord(AfMetrics *pMetrics, const double *pValues) {
+	double *pRecord;
+	unsigned int i;
+
+	pMetrics->Samples++;
+	if (--pMetrics->Countdown != 0) {
+		return;
+	}
+	pMetrics->Countdown = pMetrics->Decimation;
+
+	pRecord = pMetrics->pRecords + (size_t)pMetrics->Count * (pMetrics->Fields + 1);
+	pRecord[0] = (double)pMetrics->Samples;
+	for ( i = 0; i < pMetrics->Fields; i++ ) {
+		pRecord[i + 1] = pValues[i];
+	}
+	if (++pMetrics->Count == pMetrics->Capacity) {
+		AfMetricsFlush(pMetrics);
+	}
+}
+/* End of AfMetricsRecord() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfMetricsKeepsNext
+ *
+ * @param[in]     pMetrics recorder
+ *
+ * @returns       nonzero if the next AfMetricsRecord() keeps its sample
+ *
+ * @note          Lets the caller skip computing values that would only be
+ *  dropped by the decimation.
+ *
+ * @warning       none
+ */
+int AfMetricsKeepsNext(const AfMetrics *pMetrics) {
+	return pMetrics->Countdown == 1;
+}
+/* End of AfMetricsKeepsNext() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfMetricsFlush
+ *
+ * @param[in,out] pMetrics recorder
+ *
+ * @returns       0 on success, -1 if this or an earlier write failed
+ *
+ * @note          Converts the buffered records to dB and writes them. Call
+ *  once more after the last sample for the partial batch.
+ *
+ * @warning       none
+ */
+int AfMetricsFlush(AfMetrics *pMetrics) {
+	const unsigned int width = pMetrics->Fields + 1;
+	double *pRecord;
+	unsigned int r, i;
+
+	for ( r = 0; r < pMetrics->Count; r++ ) {
+		pRecord = pMetrics->pRecords + (size_t)r * width;
+		for ( i = 1; i < width; i++ ) {
+			pRecord[i] = 10 * log10( AF_METRICS_DB_EPSILON + pRecord[i] );
+		}
+	}
+
+	if (!pMetrics->Failed && pMetrics->Count > 0) {
+		if (pMetrics->Format == AF_METRICS_BINARY) {
+			pMetrics->Failed = fwrite(pMetrics->pRecords, width * sizeof(double),
+			                          pMetrics->Count, pMetrics->pFile) != pMetrics->Count;
+		}
+		else {
+			for ( r = 0; r < pMetrics->Count && !pMetrics->Failed; r++ ) {
+				pRecord = pMetrics->pRecords + (size_t)r * width;
+				fprintf(pMetrics->pFile, "%.0f", pRecord[0]);
+				for ( i = 1; i < width; i++ ) {
+					fprintf(pMetrics->pFile, ",%f", pRecord[i]);
+				}
+				pMetrics->Failed = fprintf(pMetrics->pFile, "\n") < 0;
+			}
+		}
+	}
+	pMetrics->Count = 0;
+
+	return pMetrics->Failed ? -1 : 0;
+}
+/* End of AfMetricsFlush() */
+/******************************************************************************/
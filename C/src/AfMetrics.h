@@ -0,0 +1,52 @@
+/*
+ * @file AfMetrics.h
+ *
+ * Header file for AfMetrics.c, a recorder that keeps per-sample metrics
+ * (such as squared error and misalignment) out of the hot loop: raw values
+ * go into a preallocated buffer, optionally decimated, and are converted to
+ * dB and written to a CSV or binary file a batch at a time.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+#ifndef AFMETRICS_H_
+#define AFMETRICS_H_
+
+#include <stddef.h>
+#include <stdio.h>
+
+#define AF_METRICS_DB_EPSILON (1.0E-40) /* allows minimum 10*log10() value of -400dB */
+
+/* Output formats. A binary record is Fields + 1 native doubles: the 1-based
+ * sample number followed by the values in dB.
+ */
+typedef enum {
+	AF_METRICS_CSV = 0,
+	AF_METRICS_BINARY
+} AfMetricsFormat;
+
+/* Contains recorder parameters and state. Set up with AfMetricsInit() in
+ * caller-provided memory.
+ */
+typedef struct {
+	unsigned int Fields; /* values per sample */
+	unsigned int Capacity; /* records buffered before a batch is written */
+	unsigned int Decimation; /* keep every Decimation-th sample */
+	unsigned int Countdown; /* samples until the next kept one */
+	unsigned int Count; /* records buffered */
+	unsigned long Samples; /* samples offered */
+	AfMetricsFormat Format;
+	FILE *pFile; /* output, owned by the caller */
+	double *pRecords; /* Capacity * (Fields + 1) doubles */
+	int Failed; /* a write failed; later records are dropped */
+} AfMetrics;
+
+size_t AfMetricsMemSize(unsigned int fields, unsigned int capacity);
+int AfMetricsInit(AfMetrics *pMetrics, unsigned int fields, unsigned int capacity,
+                  unsigned int decimation, AfMetricsFormat format, FILE *pFile,
+                  const char *const *ppNames, void *pMem);
+void AfMetricsRecord(AfMetrics *pMetrics, const double *pValues);
+int AfMetricsKeepsNext(const AfMetrics *pMetrics);
+int AfMetricsFlush(AfMetrics *pMetrics);
+
+#endif /* AFMETRICS_H_ */
@@ -0,0 +1,261 @@
+/*
+ * @file AfRing.c
+ *
+ * Lock-free single-producer/single-consumer ring of sample frames. The
+ * producer publishes frames with a release store of Head and the consumer
+ * frees them with a release store of Tail; each side reads the other's
+ * position with an acquire load only when its cached copy says the ring is
+ * full (or empty), so a steady stream costs one atomic store per call on
+ * each side. Neither side ever waits: a full ring drops the excess frames
+ * and counts an overrun, an empty one returns short and counts an underrun.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+/******************************************************************************/
+/* include block */
+#include "AfRing.h"
+
+/******************************************************************************/
+/** local definitions **/
+static void CopyFrames(double *pDst, const double *pSrc, size_t doubles);
+
+/******************************************************************************
+ * AfRingMemSize
+ *
+ * @param[in]     capacity ring size in frames, a power of two
+ * @param[in]     width    doubles per frame
+ *
+ * @returns       number of bytes AfRingInit() needs in pMem
+ *
+ * @note          none
+ *
+ * @warning       none
+ */
+size_t AfRingMemSize(unsigned int capacity, unsigned int width) {
+	return (size_t)capacity * width * sizeof(double);
+}
+/* End of AfRingMemSize() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfRingInit
+ *
+ * @param[out]    pRing    ring to initialize
+ * @param[in]     capacity ring size in frames, a power of two
+ * @param[in]     width    doubles per frame, at least 1
+ * @param[in]     pMem     AfRingMemSize(capacity, width) bytes, aligned for
+ *  double
+ *
+ * @returns       0 on success, -1 if capacity is not a power of two or width
+ *  is 0
+ *
+ * @note          The ring starts empty with both counters at 0.
+ *
+ * @warning       must not run while either side is using the ring
+ */
+int AfRingInit(AfRing *pRing, unsigned int capacity, unsigned int width, void *pMem) {
+	if (capacity == 0 || (capacity & (capacity - 1)) != 0 || width == 0) {
+		return -1;
+	}
+
+	atomic_init(&pRing->Head, 0);
+	atomic_init(&pRing->Tail, 0);
+	atomic_init(&pRing->Overruns, 0);
+	atomic_init(&pRing->Underruns, 0);
+	pRing->TailCache = 0;
+	pRing->HeadCache = 0;
+	pRing->Capacity = capacity;
+	pRing->Width = width;
+	pRing->pFrames = (double *)pMem;
+
+	return 0;
+}
+/* End of AfRingInit() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfRingWrite
+ *
+ * @param[in,out] pRing   ring
+ * @param[in]     pFrames n frames of Width doubles
+ * @param[in]     n       number of frames to write
+ *
+ * @returns       number of frames written, the oldest first
+ *
+ * @note          Producer side. Never blocks: frames that do not fit are
+ *  dropped and added to the overrun count.
+ *
+ * @warning       only one thread may write
+ */
+size_t AfRingWrite(AfRing *pRing, const double *pFrames, size_t n) {
+	const size_t capacity = pRing->Capacity, width = pRing->Width;
+	const size_t head = atomic_load_explicit(&pRing->Head, memory_order_relaxed);
+	size_t space, count, slot, first;
+
+	space = capacity - (head - pRing->TailCache);
+	if (space < n) {
+		pRing->TailCache = atomic_load_explicit(&pRing->Tail, memory_order_acquire);
+		space = capacity - (head - pRing->TailCache);
+	}
+	count = (n < space) ? n : space;
+
+	slot = head & (capacity - 1);
+	first = (count < capacity - slot) ? count : capacity - slot;
+	CopyFrames(pRing->pFrames + slot * width, pFrames, first * width);
+	CopyFrames(pRing->pFrames, pFrames + first * width, (count - first) * width);
+	atomic_store_explicit(&pRing->Head, head + count, memory_order_release);
+
+	if (count < n) {
+		atomic_fetch_add_explicit(&pRing->Overruns, (unsigned long)(n - count),
+		                          memory_order_relaxed);
+	}
+
+	return count;
+}
+/* End of AfRingWrite() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfRingRead
+ *
+ * @param[in,out] pRing   ring
+ * @param[out]    pFrames room for n frames of Width doubles
+ * @param[in]     n       number of frames wanted
+ *
+ * @returns       number of frames read, the oldest first
+ *
+ * @note          Consumer side. Never blocks: if fewer than n frames are
+ *  available the shortfall is added to the underrun count. Use
+ *  AfRingAvailable() to poll without counting.
+ *
+ * @warning       only one thread may read
+ */
+size_t AfRingRead(AfRing *pRing, double *pFrames, size_t n) {
+	const size_t capacity = pRing->Capacity, width = pRing->Width;
+	const size_t tail = atomic_load_explicit(&pRing->Tail, memory_order_relaxed);
+	size_t available, count, slot, first;
+
+	available = pRing->HeadCache - tail;
+	if (available < n) {
+		pRing->HeadCache = atomic_load_explicit(&pRing->Head, memory_order_acquire);
+		available = pRing->HeadCache - tail;
+	}
+	count = (n < available) ? n : available;
+
+	slot = tail & (capacity - 1);
+	first = (count < capacity - slot) ? count : capacity - slot;
+	CopyFrames(pFrames, pRing->pFrames + slot * width, first * width);
+	CopyFrames(pFrames + first * width, pRing->pFrames, (count - first) * width);
+	atomic_store_explicit(&pRing->Tail, tail + count, memory_order_release);
+
+	if (count < n) {
+		atomic_fetch_add_explicit(&pRing->Underruns, (unsigned long)(n - count),
+		                          memory_order_relaxed);
+	}
+
+	return count;
+}
+/* End of AfRingRead() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfRingSpace
+ *
+ * @param[in,out] pRing ring
+ *
+ * @returns       number of frames AfRingWrite() can currently take
+ *
+ * @note          Producer side; the result may grow but not shrink before
+ *  the next write.
+ *
+ * @warning       only the writing thread may call this
+ */
+size_t AfRingSpace(AfRing *pRing) {
+	const size_t head = atomic_load_explicit(&pRing->Head, memory_order_relaxed);
+
+	pRing->TailCache = atomic_load_explicit(&pRing->Tail, memory_order_acquire);
+	return pRing->Capacity - (head - pRing->TailCache);
+}
+/* End of AfRingSpace() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfRingAvailable
+ *
+ * @param[in,out] pRing ring
+ *
+ * @returns       number of frames AfRingRead() can currently return
+ *
+ * @note          Consumer side; the result may grow but not shrink before
+ *  the next read.
+ *
+ * @warning       only the reading thread may call this
+ */
+size_t AfRingAvailable(AfRing *pRing) {
+	const size_t tail = atomic_load_explicit(&pRing->Tail, memory_order_relaxed);
+
+	pRing->HeadCache = atomic_load_explicit(&pRing->Head, memory_order_acquire);
+	return pRing->HeadCache - tail;
+}
+/* End of AfRingAvailable() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfRingOverruns
+ *
+ * @param[in]     pRing ring
+ *
+ * @returns       total frames dropped by AfRingWrite()
+ *
+ * @note          May be called from any thread.
+ *
+ * @warning       none
+ */
+unsigned long AfRingOverruns(const AfRing *pRing) {
+	return atomic_load_explicit(&pRing->Overruns, memory_order_relaxed);
+}
+/* End of AfRingOverruns() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfRingUnderruns
+ *
+ * @param[in]     pRing ring
+ *
+ * @returns       total frames AfRingRead() was asked for but could not return
+ *
+ * @note          May be called from any thread.
+ *
+ * @warning       none
+ */
+unsigned long AfRingUnderruns(const AfRing *pRing) {
+	return atomic_load_explicit(&pRing->Underruns, memory_order_relaxed);
+}
+/* End of AfRingUnderruns() */
+/******************************************************************************/
+
+/** internal functions **/
+
+/***************************************************************************//**
+* CopyFrames
+*
+* @param[out]    pDst    destination
+* @param[in]     pSrc    source
+* @param[in]     doubles number of doubles to copy
+*
+* @returns       none
+*
+* @note          none
+*
+* @warning       none
+*******************************************************************************/
+static void CopyFrames(double *pDst, const double *pSrc, size_t doubles) {
+	size_t i;
+
+	for ( i = 0; i < doubles; i++ ) {
+		pDst[i] = pSrc[i];
+	}
+}
+/* End of CopyFrames()*/
+/******************************************************************************/
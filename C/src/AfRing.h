@@ -0,0 +1,47 @@
+/*
+ * @file AfRing.h
+ *
+ * Header file for AfRing.c, a lock-free single-producer/single-consumer ring
+ * of fixed-width sample frames (for example an (input, desired) pair) for
+ * passing samples between an I/O thread and a DSP thread.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+#ifndef AFRING_H_
+#define AFRING_H_
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+#define AF_RING_LINE (64) /* cache line size; keeps the two sides apart */
+
+/* Contains ring parameters and state. Set up with AfRingInit() in
+ * caller-provided memory. The producer only writes the first group of
+ * fields and the consumer only the second, each on its own cache line, so
+ * the two threads never contend for a line except to publish positions.
+ * Positions are frame counts that wrap at 2^N; the slot is the position
+ * modulo Capacity.
+ */
+typedef struct {
+	_Alignas(AF_RING_LINE) _Atomic size_t Head; /* frames written (producer) */
+	size_t TailCache; /* producer's last view of Tail */
+	_Atomic unsigned long Overruns; /* frames dropped because the ring was full */
+	_Alignas(AF_RING_LINE) _Atomic size_t Tail; /* frames read (consumer) */
+	size_t HeadCache; /* consumer's last view of Head */
+	_Atomic unsigned long Underruns; /* frames requested but not yet written */
+	_Alignas(AF_RING_LINE) unsigned int Capacity; /* frames, a power of two */
+	unsigned int Width; /* doubles per frame */
+	double *pFrames; /* Capacity * Width doubles */
+} AfRing;
+
+size_t AfRingMemSize(unsigned int capacity, unsigned int width);
+int AfRingInit(AfRing *pRing, unsigned int capacity, unsigned int width, void *pMem);
+size_t AfRingWrite(AfRing *pRing, const double *pFrames, size_t n);
+size_t AfRingRead(AfRing *pRing, double *pFrames, size_t n);
+size_t AfRingSpace(AfRing *pRing);
+size_t AfRingAvailable(AfRing *pRing);
+unsigned long AfRingOverruns(const AfRing *pRing);
+unsigned long AfRingUnderruns(const AfRing *pRing);
+
+#endif /* AFRING_H_ */
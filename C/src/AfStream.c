@@ -0,0 +1,98 @@
+/*
+ * @file AfStream.c
+ *
+ * Streaming driver for AdaptiveFilter.c: takes (input, desired) frames from
+ * an AfRing, runs them through AdaptiveFilterRunBlock() in blocks of up to
+ * AF_STREAM_BLOCK frames on the stack, and posts (output, error) frames to a
+ * second AfRing. I/O jitter only shows up in the rings' overrun and
+ * underrun counters, never as a stall in the adaptation loop.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+/******************************************************************************/
+/* include block */
+#include "AfStream.h"
+#include <sched.h>
+
+/******************************************************************************
+ * AfStreamProcess
+ *
+ * @param[in,out] pStream stream
+ * @param[in]     n       number of frames to process
+ *
+ * @returns       number of frames processed, less than n if the input ring
+ *  ran dry
+ *
+ * @note          Call once per period from a clocked DSP thread: a short
+ *  input ring counts as underruns, and a full output ring drops frames as
+ *  overruns, rather than waiting.
+ *
+ * @warning       must be called from the stream's single DSP thread
+ */
+size_t AfStreamProcess(AfStream *pStream, size_t n) {
+	double frames[2 * AF_STREAM_BLOCK];
+	double input[AF_STREAM_BLOCK], desired[AF_STREAM_BLOCK];
+	double output[AF_STREAM_BLOCK], error[AF_STREAM_BLOCK];
+	size_t done = 0, want, got, i;
+
+	while (done < n) {
+		want = (n - done < AF_STREAM_BLOCK) ? n - done : AF_STREAM_BLOCK;
+		got = AfRingRead(pStream->pIn, frames, want);
+
+		for ( i = 0; i < got; i++ ) {
+			input[i] = frames[2 * i];
+			desired[i] = frames[2 * i + 1];
+		}
+		AdaptiveFilterRunBlock(input, desired, output, error, got, pStream->pData);
+
+		if (pStream->pOut) {
+			for ( i = 0; i < got; i++ ) {
+				frames[2 * i] = output[i];
+				frames[2 * i + 1] = error[i];
+			}
+			AfRingWrite(pStream->pOut, frames, got);
+		}
+
+		done += got;
+		if (got < want) {
+			break; /* input ran dry: the shortfall is already counted */
+		}
+	}
+	pStream->Frames += done;
+
+	return done;
+}
+/* End of AfStreamProcess() */
+/******************************************************************************/
+
+/******************************************************************************
+ * AfStreamRun
+ *
+ * @param[in,out] pStream stream
+ * @param[in]     pStop   loop exits once this is nonzero
+ *
+ * @returns       none
+ *
+ * @note          Free-running DSP loop: processes whatever the input ring
+ *  holds and yields the CPU while it is empty, so idle polling does not
+ *  count as underruns. Frames still in the ring when pStop is set are left
+ *  there.
+ *
+ * @warning       must be the stream's single DSP thread
+ */
+void AfStreamRun(AfStream *pStream, const atomic_int *pStop) {
+	size_t n;
+
+	while (!atomic_load_explicit(pStop, memory_order_acquire)) {
+		n = AfRingAvailable(pStream->pIn);
+		if (n > 0) {
+			AfStreamProcess(pStream, n);
+		}
+		else {
+			sched_yield();
+		}
+	}
+}
+/* End of AfStreamRun() */
+/******************************************************************************/
@@ -0,0 +1,36 @@
+/*
+ * @file AfStream.h
+ *
+ * Header file for AfStream.c, a streaming driver that runs an adaptive
+ * filter between two AfRing buffers, so a capture thread and the DSP thread
+ * never wait on each other.
+ *
+ * Created on: Oct 16, 2026
+ */
+
+#ifndef AFSTREAM_H_
+#define AFSTREAM_H_
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include "AdaptiveFilter.h"
+#include "AfRing.h"
+
+#define AF_STREAM_BLOCK (64) /* frames moved per filter call */
+
+/* Contains the rings and filter of one stream. pIn carries frames of 2
+ * doubles (input, desired); pOut, if not NULL, receives frames of 2 doubles
+ * (output, error). The DSP thread is the consumer of pIn and the producer
+ * of pOut.
+ */
+typedef struct {
+	AfRing *pIn; /* (input, desired) frames from the capture thread */
+	AfRing *pOut; /* (output, error) frames to the I/O thread, or NULL */
+	AfData *pData; /* adaptive filter */
+	unsigned long Frames; /* frames processed so far */
+} AfStream;
+
+size_t AfStreamProcess(AfStream *pStream, size_t n);
+void AfStreamRun(AfStream *pStream, const atomic_int *pStop);
+
+#endif /* AFSTREAM_H_ */
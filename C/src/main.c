@@ -7,13 +7,112 @@
 //
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "AdaptiveFilterTest.h"
+#include "AdaptiveFilterScenario.h"
+#include "AdaptiveFilterEnsemble.h"
 
 int main(int argc, const char * argv[])
 {
+    AfTestOptions options = { 0 };
+    AfScenarioParams params;
+    AfScenario *pScenarios = NULL;
+    AfEnsemble ensemble;
+    unsigned int count = 0, threads = 0, trials = 0, k;
+    int i, failed = 0;
 
-    AdaptiveFilterTestRun();
+    for (i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--scenario") == 0) {
+            /* collected below, once the count is known */
+            AfScenarioDefaults(&params);
+            if (AfScenarioParse(&params, argv[++i]) != 0) {
+                fprintf(stderr, "%s: bad scenario %s\n", argv[0], argv[i]);
+                return 1;
+            }
+            count++;
+        } else if (i + 1 < argc && strcmp(argv[i], "--threads") == 0) {
+            threads = (unsigned int)strtoul(argv[++i], NULL, 0);
+        } else if (i + 1 < argc && strcmp(argv[i], "--ensemble") == 0) {
+            trials = (unsigned int)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            options.Verbose = 1;
+        } else if (i + 1 < argc && strcmp(argv[i], "--metrics") == 0) {
+            options.pMetricsPath = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--decimate") == 0) {
+            options.Decimation = (unsigned int)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--binary") == 0) {
+            options.Format = AF_METRICS_BINARY;
+        } else {
+            fprintf(stderr, "usage: %s [--scenario key=value,...]... [--ensemble TRIALS] "
+                    "[--threads N] [--verbose] [--metrics FILE] [--decimate N] [--binary]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
 
-    return 0;
+    if (trials > 0) {
+        /* trials of the first scenario, or the default one */
+        AfScenarioDefaults(&params);
+        for (i = 1; i + 1 < argc; i++) {
+            if (strcmp(argv[i], "--scenario") == 0) {
+                AfScenarioParse(&params, argv[i + 1]);
+                break;
+            }
+        }
+        if (AfEnsembleInit(&ensemble, &params, trials, options.Decimation) != 0) {
+            fprintf(stderr, "%s: cannot set up %u trials\n", argv[0], trials);
+            return 1;
+        }
+        AfEnsembleRun(&ensemble, threads);
+        AfEnsembleReport(&ensemble);
+        failed = ensemble.Failed || ensemble.Passed != trials;
+        if (options.pMetricsPath &&
+            AfEnsembleWrite(&ensemble, options.pMetricsPath, options.Format) != 0) {
+            fprintf(stderr, "%s: cannot write %s\n", argv[0], options.pMetricsPath);
+            failed = 1;
+        }
+        AfEnsembleDestroy(&ensemble);
+        return failed;
+    }
+
+    if (count == 0) {
+        AdaptiveFilterTestRun(&options);
+        AdaptiveFilterTemplateTestRun();
+        return 0;
+    }
+
+    /* only the given scenarios, concurrently */
+    pScenarios = (AfScenario *)calloc(count, sizeof(AfScenario));
+    if (!pScenarios) {
+        return 1;
+    }
+    for (i = 1, k = 0; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--scenario") == 0) {
+            AfScenarioDefaults(&params);
+            AfScenarioParse(&params, argv[++i]);
+            if (AfScenarioInit(&pScenarios[k++], &params) != 0) {
+                fprintf(stderr, "%s: cannot set up scenario %s\n", argv[0], argv[i]);
+                failed = 1;
+            }
+        } else if (i + 1 < argc && (strcmp(argv[i], "--threads") == 0 ||
+                   strcmp(argv[i], "--ensemble") == 0 ||
+                   strcmp(argv[i], "--metrics") == 0 || strcmp(argv[i], "--decimate") == 0)) {
+            i++;
+        }
+    }
+    if (!failed) {
+        AfScenarioRunMany(pScenarios, count, threads, &options);
+        for (k = 0; k < count; k++) {
+            AfScenarioReport(&pScenarios[k], k + 1);
+            failed |= !pScenarios[k].Passed || pScenarios[k].MetricsFailed;
+        }
+    }
+    for (k = 0; k < count; k++) {
+        AfScenarioDestroy(&pScenarios[k]);
+    }
+    free(pScenarios);
+
+    return failed;
 }
 